@@ -1,31 +1,100 @@
 HEADERS += \
+    include/AmplitudeHistogram.hpp \
+    include/AnalysisPool.hpp \
+    include/BitDepthEstimator.hpp \
     include/BitDisplay.hpp \
+    include/BitStatistics.hpp \
+    include/BlockQueue.hpp \
+    include/CaptureSpool.hpp \
+    include/ChannelPairEntropy.hpp \
+    include/CodeHistogram.hpp \
+    include/ConsoleRunner.hpp \
+    include/DeviceCapabilityCache.hpp \
+    include/DriftEstimator.hpp \
     include/Entropy.hpp \
     include/EntropyDisplay.hpp \
+    include/EntropyHistory.hpp \
+    include/EntropyProfile.hpp \
+    include/EntropySketch.hpp \
+    include/EventTrigger.hpp \
+    include/Fft.hpp \
+    include/FileSource.hpp \
+    include/HistogramPanel.hpp \
+    include/HistoryBuffer.hpp \
+    include/HistoryPanel.hpp \
     include/InfoWindow.hpp \
+    include/LosslessBitrate.hpp \
     include/MainWindow.hpp \
     include/MeterDisplay.hpp \
+    include/MissingCodes.hpp \
+    include/MultiResolutionEntropy.hpp \
     include/OptionPanel.hpp \
     include/PeakMeter.hpp \
     include/PortAudioControl.hpp \
     include/PortAudioIO.hpp \
+    include/PredictionEntropy.hpp \
     include/RingBuffer.hpp \
-    include/RMSMeter.hpp
+    include/RMSMeter.hpp \
+    include/RunningMoments.hpp \
+    include/SampleSource.hpp \
+    include/SettingsMailbox.hpp \
+    include/Spectrogram.hpp \
+    include/SpectrogramPanel.hpp \
+    include/StatisticsPanel.hpp \
+    include/StreamStatistics.hpp \
+    include/SyntheticSource.hpp \
+    include/TriggerPanel.hpp \
+    include/WaveformPanel.hpp \
+    include/WaveformPyramid.hpp
 
 SOURCES += \
+    src/AmplitudeHistogram.cpp \
+    src/AnalysisPool.cpp \
+    src/BitDepthEstimator.cpp \
     src/BitDisplay.cpp \
+    src/BitStatistics.cpp \
+    src/BlockQueue.cpp \
+    src/CaptureSpool.cpp \
+    src/ChannelPairEntropy.cpp \
+    src/CodeHistogram.cpp \
+    src/ConsoleRunner.cpp \
+    src/DeviceCapabilityCache.cpp \
+    src/DriftEstimator.cpp \
     src/Entropy.cpp \
     src/EntropyDisplay.cpp \
+    src/EntropyHistory.cpp \
+    src/EntropyProfile.cpp \
+    src/EntropySketch.cpp \
+    src/EventTrigger.cpp \
+    src/Fft.cpp \
+    src/FileSource.cpp \
+    src/HistogramPanel.cpp \
+    src/HistoryBuffer.cpp \
+    src/HistoryPanel.cpp \
     src/InfoWindow.cpp \
+    src/LosslessBitrate.cpp \
     src/Main.cpp \
     src/MainWindow.cpp \
     src/MeterDisplay.cpp \
+    src/MissingCodes.cpp \
+    src/MultiResolutionEntropy.cpp \
     src/OptionPanel.cpp \
     src/PeakMeter.cpp \
     src/PortAudioControl.cpp \
     src/PortAudioIO.cpp \
+    src/PredictionEntropy.cpp \
     src/RingBuffer.cpp \
-    src/RMSMeter.cpp
+    src/RMSMeter.cpp \
+    src/RunningMoments.cpp \
+    src/SampleSource.cpp \
+    src/Spectrogram.cpp \
+    src/SpectrogramPanel.cpp \
+    src/StatisticsPanel.cpp \
+    src/StreamStatistics.cpp \
+    src/SyntheticSource.cpp \
+    src/TriggerPanel.cpp \
+    src/WaveformPanel.cpp \
+    src/WaveformPyramid.cpp
 
 
 
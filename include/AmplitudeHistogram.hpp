@@ -0,0 +1,66 @@
+/*
+ * AmplitudeHistogram: Amplitude distribution with a fixed number of display bins
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AMPLITUDEHISTOGRAM_H
+#define AMPLITUDEHISTOGRAM_H
+
+#include <cstdint>
+#include <vector>
+
+class AmplitudeHistogramListener
+{
+public:
+    AmplitudeHistogramListener() {}
+
+    // Bin 0 holds the most negative codes, every bin holds "codesPerBin" consecutive codes
+    virtual void receiveAmplitudeHistogram(const std::vector<uint32_t> & counts, int codesPerBin) = 0;
+};
+
+// Counts the samples of the entropy window in at most 2^maximumBinBits bins, i.e. the MSBs of the sample.
+// The bins are updated with every block, so the display only gets a small copy and never the table of all codes.
+class AmplitudeHistogram
+{
+public:
+    // About the width of the histogram in pixels
+    static const int maximumBinBits = 9;
+
+    AmplitudeHistogram(AmplitudeHistogramListener *listener = nullptr);
+
+    // Same window as Entropy: the histogram is reported after every "numberOfBlocks" blocks
+    void addSamples(const std::vector<int32_t> & signalValues);
+    void setNumberOfBlocks(int numberOfBlocks);
+    // Clears the window
+    void setBitDepth(int bitDepth);
+    void clear();
+
+    int getCodesPerBin() const;
+
+private:
+    AmplitudeHistogramListener *m_amplitudeHistogramListener;
+    int m_bitDepth;
+    int m_shift;
+    uint32_t m_mask;
+    uint32_t m_signBit;
+    int m_numberOfBlocks;
+    int m_blockCounter;
+    std::vector<uint32_t> m_counts;
+};
+
+#endif // AMPLITUDEHISTOGRAM_H
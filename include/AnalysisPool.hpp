@@ -0,0 +1,72 @@
+/*
+ * AnalysisPool: Worker threads which analyze the blocks of several sources
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ANALYSISPOOL_H
+#define ANALYSISPOOL_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class RingBuffer;
+
+// The blocks of every buffer are passed to its receiver in order and never by two workers at the same time,
+// so the receivers don't have to be thread-safe. Different buffers are analyzed in parallel.
+class AnalysisPool
+{
+public:
+    // 0 starts one worker per hardware thread
+    AnalysisPool(int numberOfThreads = 0);
+    ~AnalysisPool();
+
+    // Pass the queued blocks of "buffer" to its receiver on the worker threads
+    void addBuffer(RingBuffer *buffer);
+    // Wait until no worker is using the buffer anymore, blocks which are still queued are left in the buffer
+    void removeBuffer(RingBuffer *buffer);
+    int getNumberOfThreads() const;
+
+private:
+    struct Entry
+    {
+        RingBuffer *m_buffer;
+        // A worker is passing a block of this buffer to the receiver
+        bool m_busy;
+    };
+
+    // Find a buffer with queued blocks which isn't used by another worker, m_mutex must be locked
+    Entry * claimEntry();
+    void runWorkerThread();
+
+private:
+    std::vector<std::unique_ptr<Entry>> m_entries;
+    // Round robin start position of claimEntry(), so no buffer starves
+    size_t m_nextEntry;
+    std::mutex m_mutex;
+    // Notified by the queues of all buffers
+    std::condition_variable m_condition;
+    // Notified when a worker has released a buffer
+    std::condition_variable m_releaseCondition;
+    std::vector<std::thread> m_workerThreads;
+    bool m_running;
+};
+
+#endif // ANALYSISPOOL_H
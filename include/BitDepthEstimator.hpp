@@ -0,0 +1,89 @@
+/*
+ * BitDepthEstimator: Effective bit depth from trailing zeros and bit toggle rates
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BITDEPTHESTIMATOR_H
+#define BITDEPTHESTIMATOR_H
+
+#include <cstdint>
+#include <vector>
+
+#include "BitStatistics.hpp"
+
+class BitDepthEstimatorListener
+{
+public:
+    BitDepthEstimatorListener() {}
+
+    virtual void receiveBitDepthEstimate(int bitDepth, int effectiveBitDepth, int noiseBits, const char *verdict) = 0;
+};
+
+// Estimates from the bit statistics since the last clear():
+// - Padded: the lowest bits are always zero, the LSB of the remaining word toggles like noise (e.g. 16 bit in a 24 bit stream)
+// - Truncated: the lowest bits are always zero, the LSB of the remaining word toggles much less than noise (requantized without dither)
+// - Dithered: all bits are used, but the lowest bits (at most a quarter of the word) toggle like independent noise
+// - Full: all bits are used and only noise-like bits above the lowest quarter, which are taken as signal
+class BitDepthEstimator
+{
+public:
+    enum class Verdict
+    {
+        Unknown,
+        Full,
+        Padded,
+        Dithered,
+        Truncated
+    };
+
+    struct Estimate
+    {
+        int m_bitDepth;
+        // Bit depth without the zero LSBs
+        int m_effectiveBitDepth;
+        int m_paddedBits;
+        // Lowest bits of the effective word which toggle like noise
+        int m_noiseBits;
+        // Probability that the LSB of the effective word differs from the previous sample
+        double m_lsbToggleRate;
+        Verdict m_verdict;
+        uint64_t m_numberOfSamples;
+    };
+
+    BitDepthEstimator(BitDepthEstimatorListener *listener = nullptr);
+
+    // Clears the statistics
+    void setBitDepth(int bitDepth);
+    // The listener gets an estimate every "numberOfBlocks" blocks
+    void setReportInterval(int numberOfBlocks);
+    void addSamples(const std::vector<int32_t> & signalValues);
+    void clear();
+
+    Estimate getEstimate() const;
+    // The per-bit counts the estimate is based on
+    const BitStatistics & getStatistics() const;
+    static const char *getVerdictName(Verdict verdict);
+
+private:
+    BitDepthEstimatorListener *m_bitDepthEstimatorListener;
+    BitStatistics m_statistics;
+    int m_reportInterval;
+    int m_blockCounter;
+};
+
+#endif // BITDEPTHESTIMATOR_H
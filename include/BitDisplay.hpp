@@ -25,6 +25,8 @@
 
 #include <bitset>
 
+#include "BitStatistics.hpp"
+
 class QLabel;
 class QSpinBox;
 class QComboBox;
@@ -62,6 +64,12 @@ public:
 signals:
     void signalConversionChanged(bool showOriginal);
 
+public slots:
+    // Show the result of BitDepthEstimator
+    void updateBitDepthEstimate(int bitDepth, int effectiveBitDepth, int noiseBits, QString verdict);
+    // Color the heatmap rows under the bits with the set and toggle rates, stuck bits get a red border
+    void updateBitStatistics(const BitStatistics::Snapshot & statistics);
+
 protected:
     // Enable background-color painting of this widget
     virtual void paintEvent(QPaintEvent *) override;
@@ -81,6 +89,9 @@ private:
     BitView m_view;
     // The bits
     QList<QGraphicsEllipseItem*> m_bitCircles;
+    // Heatmap rows under the circles (same index)
+    QList<QGraphicsRectItem*> m_setRateCells;
+    QList<QGraphicsRectItem*> m_toggleRateCells;
     // Labels MSB and LSB
     QGraphicsTextItem *m_tMsb;
     QGraphicsTextItem *m_tLsb;
@@ -94,6 +105,7 @@ private:
     QPushButton *m_buttonReset;
     QLabel *m_labelSamplePosition;
     QSpinBox *m_spinBoxSamplePosition;
+    QLabel *m_labelBitDepthEstimate;
 
     // Is set when "HOLD" button is pressed
     bool m_holdBits;
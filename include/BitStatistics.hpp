@@ -0,0 +1,108 @@
+/*
+ * BitStatistics: Long-run per-bit set, toggle and stuck-bit statistics
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BITSTATISTICS_H
+#define BITSTATISTICS_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Counts for every bit of the samples since the last clear() how often it was set, how often it differed from the previous sample
+// and how often it was the lowest set bit (the trailing-zero distribution). The counts are 64 bit, so hours of samples fit.
+class BitStatistics
+{
+public:
+    struct Snapshot
+    {
+        int m_bitDepth;
+        uint64_t m_numberOfSamples;
+        // Index is the bit, 0 is the LSB
+        std::vector<double> m_setRates;
+        std::vector<double> m_toggleRates;
+        // Bits which have never been set / have always been set
+        uint32_t m_stuckAtZero;
+        uint32_t m_stuckAtOne;
+    };
+
+    BitStatistics();
+
+    // Clears the statistics
+    void setBitDepth(int bitDepth);
+    int getBitDepth() const;
+    void addSamples(const std::vector<int32_t> & signalValues);
+    void clear();
+
+    uint64_t getNumberOfSamples() const;
+    uint64_t getSetCount(int bit) const;
+    uint64_t getToggleCount(int bit) const;
+    // Number of samples with exactly "bit" trailing zeros (zero samples aren't counted)
+    uint64_t getTrailingZeroCount(int bit) const;
+    // Probability that "bit" is set / differs from the previous sample
+    double getSetRate(int bit) const;
+    double getToggleRate(int bit) const;
+    // Masks of the bits which have never been set / have always been set, both are 0 without samples
+    uint32_t getStuckAtZero() const;
+    uint32_t getStuckAtOne() const;
+    Snapshot getSnapshot() const;
+
+private:
+    // Bit-sliced counter: plane k holds bit k of the count of every bit position, so one word operation counts all bits of two samples
+    // (the second sample in the upper half of the 64 bit word).
+    class BitCounter
+    {
+    public:
+        static const int numberOfPlanes = 16;
+        // Samples which can be added before flush() must be called
+        static const uint32_t maximumCount = (1U << numberOfPlanes) - 64;
+        // Samples per addGroup()
+        static const int groupSize = 32;
+
+        void clear();
+        void add(uint32_t bits);
+        // Add "groupSize" samples packed into 16 words with a carry-save adder tree, the planes above 16 are only touched once
+        void addGroup(const uint64_t *words);
+        // Move the planes into the 64 bit counts
+        void flush();
+        uint64_t getCount(int bit) const;
+
+    private:
+        void addFromPlane(int plane, uint64_t bits);
+
+    private:
+        std::array<uint64_t, numberOfPlanes> m_planes;
+        std::array<uint64_t, 32> m_counts;
+    };
+
+    void flush();
+
+private:
+    int m_bitDepth;
+    uint32_t m_mask;
+    BitCounter m_setBits;
+    BitCounter m_toggledBits;
+    // Lowest set bit of every sample
+    BitCounter m_lowestBits;
+    uint32_t m_countSinceFlush;
+    uint32_t m_previousCode;
+    uint64_t m_numberOfSamples;
+};
+
+#endif // BITSTATISTICS_H
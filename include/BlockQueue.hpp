@@ -0,0 +1,90 @@
+/*
+ * BlockQueue: Lock-free queue of sample blocks between capture and analysis
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BLOCKQUEUE_H
+#define BLOCKQUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+struct AudioBlock
+{
+    std::vector<int32_t> m_samples;
+    // Samples of the second channel of a channel pair at the same positions, empty if no pair channel is captured
+    std::vector<int32_t> m_pairSamples;
+    // Position of the first sample in the stream
+    uint64_t m_sampleIndex;
+    // Nanoseconds since epoch when the block was completed
+    int64_t m_systemTime;
+    // Time of the first sample in seconds on the clock of the source (PortAudio ADC time or sample index / sample rate)
+    double m_adcTime;
+};
+
+// Single producer, single consumer queue with preallocated blocks.
+// The producer side never locks or allocates and can be used from the audio thread.
+class BlockQueue
+{
+public:
+    BlockQueue(size_t numberOfBlocks = 2, size_t blockSize = 0);
+    // Reallocate all blocks, must not be called while producer or consumer are active.
+    // "pairChannel" additionally allocates the samples of a second channel
+    void clearAndResize(size_t numberOfBlocks, size_t blockSize, bool pairChannel = false);
+
+    // Producer: get the next free block, nullptr if the queue is full
+    AudioBlock * getWriteBlock();
+    // Producer: pass the block returned by getWriteBlock() to the consumer
+    void pushBlock();
+    // Producer: count a block which couldn't be queued
+    void dropBlock();
+
+    // Consumer: get the oldest queued block, nullptr if the queue is empty
+    AudioBlock * getReadBlock();
+    // Consumer: wait until a block is queued or the timeout has expired
+    AudioBlock * waitForReadBlock(std::chrono::milliseconds timeout);
+    // Consumer: release the block returned by getReadBlock()
+    void popBlock();
+
+    // Wake up a waiting consumer (e.g. when it should stop)
+    void wakeUp();
+    // Additionally notify "condition" for every queued block, nullptr disables it
+    void setConsumerCondition(std::condition_variable *condition);
+
+    size_t getNumberOfQueuedBlocks() const;
+    size_t getNumberOfBlocks() const;
+    uint64_t getNumberOfDroppedBlocks() const;
+
+private:
+    std::vector<AudioBlock> m_blocks;
+    // Monotonic counters, index into m_blocks is counter modulo number of blocks
+    std::atomic<uint64_t> m_writeCounter;
+    std::atomic<uint64_t> m_readCounter;
+    std::atomic<uint64_t> m_droppedBlocks;
+    // Only used by the consumer for sleeping, the producer just notifies
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    // Condition of a consumer which serves several queues (e.g. AnalysisPool)
+    std::atomic<std::condition_variable *> m_consumerCondition;
+};
+
+#endif // BLOCKQUEUE_H
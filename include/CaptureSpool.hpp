@@ -0,0 +1,132 @@
+/*
+ * CaptureSpool: Recording of decoded blocks into memory-mapped segment files
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CAPTURESPOOL_H
+#define CAPTURESPOOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BlockQueue.hpp"
+
+// Segment files are named <prefix>_<sequence>.spool and contain a SegmentHeader followed by records.
+// Every record is a RecordHeader followed by "m_numberOfSamples" int32 samples (host byte order).
+// Only the newest "maximum number of segments" files are kept.
+class CaptureSpool
+{
+public:
+    struct SegmentHeader
+    {
+        char m_magic[8];
+        uint32_t m_version;
+        uint32_t m_bitDepth;
+        uint32_t m_sampleRate;
+        uint32_t m_blockSize;
+        uint64_t m_sequence;
+        // Bytes of complete records after the header
+        uint64_t m_usedBytes;
+        uint8_t m_reserved[24];
+    };
+
+    struct RecordHeader
+    {
+        // Position of the first sample in the stream
+        uint64_t m_sampleIndex;
+        // Nanoseconds since epoch when the block was received
+        int64_t m_systemTime;
+        uint32_t m_numberOfSamples;
+        uint32_t m_reserved;
+    };
+
+    CaptureSpool();
+    ~CaptureSpool();
+
+    // Path and beginning of the file names, e.g. "/tmp/capture"
+    void setFileNamePrefix(const std::string & prefix);
+    // Size of one segment file in bytes
+    void setSegmentSize(size_t segmentSize);
+    // Older segments are deleted, 0 keeps all segments
+    void setMaximumNumberOfSegments(int maximumNumberOfSegments);
+    const std::string & getFileNamePrefix() const;
+
+    // Create the first segments and start the spool thread, return "true" if everything is okay
+    bool open(int bitDepth, uint32_t sampleRate, uint32_t blockSize);
+    // Write all queued blocks and close the segment files
+    void close();
+    bool isOpen() const;
+
+    // Called from the receiver thread, never blocks or allocates (the block is dropped if the queue is full)
+    void addBlock(const AudioBlock & block);
+    uint64_t getNumberOfWrittenBlocks() const;
+    uint64_t getNumberOfDroppedBlocks() const;
+
+    static std::string getSegmentFileName(const std::string & prefix, uint64_t sequence);
+    // Split a segment file name into prefix and sequence number, return "false" if it isn't a segment file name
+    static bool splitSegmentFileName(const std::string & fileName, std::string & prefix, uint64_t & sequence);
+    // Check the magic of a segment header
+    static bool isSegmentHeader(const SegmentHeader & header);
+
+private:
+    // Memory-mapped segment file
+    struct Segment
+    {
+        uint8_t *m_data;
+        size_t m_size;
+        size_t m_position;
+        uint64_t m_sequence;
+#ifdef _WIN32
+        void *m_fileHandle;
+        void *m_mappingHandle;
+#else
+        int m_fileDescriptor;
+#endif
+    };
+
+    // Create, resize and map the segment file with the given sequence number
+    bool createSegment(Segment & segment, uint64_t sequence);
+    // Unmap the segment and truncate the file to the used size
+    void finishSegment(Segment & segment);
+    // Switch to the prepared segment and prepare the next one
+    bool rotateSegment();
+    void writeBlock(const AudioBlock & block);
+    void runSpoolThread();
+
+private:
+    std::string m_prefix;
+    size_t m_segmentSize;
+    int m_maximumNumberOfSegments;
+    int m_bitDepth;
+    uint32_t m_sampleRate;
+    uint32_t m_blockSize;
+    // Queue between the receiver thread and the spool thread
+    BlockQueue m_queue;
+    std::atomic<uint64_t> m_writtenBlocks;
+    Segment m_segment;
+    // Created in advance, so rotating only has to switch pointers
+    Segment m_nextSegment;
+    std::thread m_spoolThread;
+    std::atomic<bool> m_spoolRunning;
+    bool m_open;
+};
+
+#endif // CAPTURESPOOL_H
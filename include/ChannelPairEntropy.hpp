@@ -0,0 +1,105 @@
+/*
+ * ChannelPairEntropy: Joint entropy and mutual information of two channels
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CHANNELPAIRENTROPY_H
+#define CHANNELPAIRENTROPY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "CodeHistogram.hpp"
+
+class ChannelPairEntropyListener
+{
+public:
+    ChannelPairEntropyListener() {}
+
+    // Entropies in bit of both channels and of the sample pairs, mutual information = first + second - joint.
+    // "resolution" is the number of most significant bits per sample which have been kept (see ChannelPairEntropy).
+    virtual void receiveChannelPairEntropy(double firstEntropy, double secondEntropy, double jointEntropy,
+                                           double mutualInformation, int resolution) = 0;
+};
+
+// Same windows as Entropy: one result after every "number of blocks" blocks. The pairs are counted in an open addressing
+// hash table which grows up to 2^maximumTableBits slots. If the window contains more distinct pairs than the table or
+// the number of samples allows (see samplesPerPair), the least significant bit of both channels is dropped and the table
+// is rehashed, so the memory stays bounded and the result is reported at a lower resolution. Both channel entropies are
+// derived from the pair counts, so they have the same resolution as the joint entropy and need no memory of their own.
+class ChannelPairEntropy
+{
+public:
+    static const int maximumTableBits = 20;
+    // Minimum number of samples per distinct pair in a window. With fewer samples the joint histogram is undersampled
+    // and the mutual information of independent channels is overestimated by several bits.
+    static const int samplesPerPair = 4;
+
+    ChannelPairEntropy(ChannelPairEntropyListener *listener = nullptr);
+
+    // Samples of both channels at the same positions
+    void addSamples(const std::vector<int32_t> & firstValues, const std::vector<int32_t> & secondValues);
+    void setNumberOfBlocks(int numberOfBlocks);
+    // Clears everything
+    void setBitDepth(int bitDepth);
+    void clear();
+
+private:
+    struct Slot
+    {
+        // Pair of codes + 1, 0 marks an empty slot
+        uint64_t m_key;
+        uint64_t m_count;
+    };
+
+    void addPair(uint64_t key, uint64_t count);
+    // Double the table or drop more bits of both channels until another pair can be added
+    void makeRoom();
+    void rehash(size_t tableBits, int droppedBits);
+    void calculateEntropy();
+    // Entropy of the codes in "bins", which are merged in place
+    static double calculateChannelEntropy(std::vector<CodeHistogram::Bin> & bins, uint64_t numberOfSamples);
+    size_t getSlotIndex(uint64_t key) const
+    {
+        return static_cast<size_t>((key*0x9E3779B97F4A7C15ULL) >> (64 - m_tableBits));
+    }
+
+private:
+    ChannelPairEntropyListener *m_channelPairEntropyListener;
+    int m_bitDepth;
+    uint32_t m_mask;
+    uint32_t m_signBit;
+    int m_numberOfBlocks;
+    int m_blockCounter;
+    uint64_t m_numberOfSamples;
+    std::vector<Slot> m_slots;
+    size_t m_tableBits;
+    size_t m_numberOfUsedSlots;
+    // Limit of the current window, derived from its number of samples
+    size_t m_maximumNumberOfPairs;
+    // Least significant bits of both channels which aren't counted in the current window
+    int m_droppedBits;
+    // Reused by rehash()
+    std::vector<Slot> m_oldSlots;
+    // Reused by calculateEntropy()
+    std::vector<CodeHistogram::Bin> m_firstBins;
+    std::vector<CodeHistogram::Bin> m_secondBins;
+};
+
+#endif // CHANNELPAIRENTROPY_H
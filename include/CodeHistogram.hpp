@@ -0,0 +1,129 @@
+/*
+ * CodeHistogram: Full resolution histogram of the sample codes
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CODEHISTOGRAM_H
+#define CODEHISTOGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Codes are the samples shifted to unsigned values: 0 is the most negative sample, 2^bitDepth-1 the most positive one.
+// Up to "maximumDenseBitDepth" every code has a counter, above only the occupied codes are stored in an open addressing
+// hash table which is at most half full. Adding a sample costs the same however many codes the window already holds;
+// the table grows with the number of distinct codes and is only sorted when the bins are read.
+// With a maximum table size the memory stays bounded: if the table is full, the least significant bit of all codes is
+// dropped and the table is rehashed, like in ChannelPairEntropy. The histogram then has a lower resolution until clear().
+class CodeHistogram
+{
+public:
+    struct Bin
+    {
+        uint32_t m_code;
+        uint64_t m_count;
+    };
+
+    static const int maximumDenseBitDepth = 16;
+
+    CodeHistogram();
+
+    // Clears the histogram
+    void setBitDepth(int bitDepth);
+    int getBitDepth() const;
+    // At most 2^tableBits slots above maximumDenseBitDepth, 0 lets the table grow with the number of codes
+    void setMaximumTableBits(int tableBits);
+    // Least significant bits which aren't counted since the last clear()
+    int getDroppedBits() const;
+    void addSamples(const std::vector<int32_t> & samples);
+    // Add codes which are already unsigned (only the lower "bit depth" bits are used)
+    void addCodes(const std::vector<uint32_t> & codes);
+    // Add the counts of a histogram with the same bit depth
+    void addHistogram(const CodeHistogram & histogram);
+    void clear();
+    uint64_t getNumberOfSamples() const;
+
+    // Entropy in bit of the codes without the dropped bits
+    double getEntropy() const;
+    // Occupied codes without the dropped bits in ascending order
+    void getBins(std::vector<Bin> & bins) const;
+    // Entropy in bit if only the "bits" most significant bits of every code are kept, index "bits-1" for 1 ... bit depth
+    // All values are derived from the histogram by merging adjacent bins. Above the current resolution every dropped bit
+    // is assumed to add one bit.
+    void getEntropyProfile(std::vector<double> & profile) const;
+    // Bins with a count of 0 are ignored
+    static double calculateEntropy(const std::vector<Bin> & bins, uint64_t numberOfSamples);
+
+private:
+    void addSparseCode(uint32_t code, uint64_t count)
+    {
+        if(2*(m_numberOfUsedSlots + 1) > m_slots.size())
+        {
+            makeRoom();
+        }
+        insertCode(code >> m_droppedBits, count);
+    }
+    // "code" without the dropped bits, there must be room for it
+    void insertCode(uint32_t code, uint64_t count)
+    {
+        // Linear probing, the table is never full
+        const size_t indexMask = m_slots.size() - 1;
+        size_t index = getSlotIndex(code);
+        while(m_slots[index].m_count != 0 && m_slots[index].m_code != code)
+        {
+            index = (index + 1) & indexMask;
+        }
+        if(m_slots[index].m_count == 0)
+        {
+            m_slots[index].m_code = code;
+            ++m_numberOfUsedSlots;
+        }
+        m_slots[index].m_count += count;
+    }
+    // Double the table or drop more bits until another code can be added
+    void makeRoom();
+    // Double the table until "numberOfCodes" more codes fit or it has the maximum size
+    void growTable(size_t numberOfCodes);
+    void rehash(size_t tableBits, int droppedBits);
+    size_t getSlotIndex(uint32_t code) const
+    {
+        return static_cast<size_t>((static_cast<uint64_t>(code)*0x9E3779B97F4A7C15ULL) >> (64 - m_tableBits));
+    }
+    uint32_t toCode(int32_t sample) const
+    {
+        return (static_cast<uint32_t>(sample) ^ m_signBit) & m_mask;
+    }
+
+private:
+    int m_bitDepth;
+    uint32_t m_mask;
+    uint32_t m_signBit;
+    uint64_t m_numberOfSamples;
+    std::vector<uint64_t> m_denseCounts;
+    // Slots with a count of 0 are empty, the size is a power of two and only grows within a run
+    std::vector<Bin> m_slots;
+    size_t m_tableBits;
+    size_t m_numberOfUsedSlots;
+    size_t m_maximumTableBits;
+    int m_droppedBits;
+    // Used by getEntropyProfile()
+    mutable std::vector<Bin> m_profileBins;
+};
+
+#endif // CODEHISTOGRAM_H
@@ -0,0 +1,192 @@
+/*
+ * ConsoleRunner: Analysis without GUI for benchmarks and regression tests
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CONSOLERUNNER_H
+#define CONSOLERUNNER_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AnalysisPool.hpp"
+#include "BitDepthEstimator.hpp"
+#include "CaptureSpool.hpp"
+#include "ChannelPairEntropy.hpp"
+#include "PortAudioControl.hpp"
+#include "Entropy.hpp"
+#include "EntropyHistory.hpp"
+#include "EntropyProfile.hpp"
+#include "EventTrigger.hpp"
+#include "LosslessBitrate.hpp"
+#include "MissingCodes.hpp"
+#include "MultiResolutionEntropy.hpp"
+#include "PeakMeter.hpp"
+#include "PredictionEntropy.hpp"
+#include "RMSMeter.hpp"
+#include "RunningMoments.hpp"
+
+class ConsoleRunner
+    : public PortAudioControlListener
+    , public EntropyListener
+    , public EntropyProfileListener
+    , public PredictionEntropyListener
+    , public LosslessBitrateListener
+    , public MultiResolutionEntropyListener
+    , public ChannelPairEntropyListener
+    , public PeakMeterListener
+    , public RMSMeterListener
+    , public RunningMomentsListener
+{
+public:
+    ConsoleRunner();
+    virtual ~ConsoleRunner();
+
+    // Indicates whether the application should run without GUI
+    static bool isConsoleMode(int argc, char *argv[]);
+    // Read the command line options, return "false" if they are invalid
+    bool parseArguments(int argc, char *argv[]);
+    void printUsage() const;
+    // Run the analysis and print the results, return the exit code of the application
+    int run();
+
+    virtual void receiveSourceSamples(const AudioBlock & block) override;
+    virtual void receiveSupportedSampleRates(int deviceNumber, const std::vector<uint32_t> & sampleRates) override;
+    virtual void receiveProbingFinished(bool completed) override;
+
+    virtual void receiveEntropy(double entropy) override;
+    virtual void receiveEntropyProfile(const std::vector<double> & profile) override;
+    virtual void receivePredictionEntropy(const std::vector<double> & residualEntropy, double conditionalEntropy, int conditionalResolution) override;
+    virtual void receiveLosslessBitrate(double bitsPerSample, const char *predictor) override;
+    virtual void receiveMultiResolutionEntropy(const std::vector<double> & entropies) override;
+    virtual void receiveRunningMoments(const RunningMoments::Result & window, const RunningMoments::Result & total) override;
+    virtual void receiveChannelPairEntropy(double firstEntropy, double secondEntropy, double jointEntropy,
+                                           double mutualInformation, int resolution) override;
+
+    virtual void receivePeakHolderValue(double value) override;
+    virtual void receivePeakMeterValue(double value) override;
+
+    virtual void receiveRmsHolderValue(double rms) override;
+    virtual void receiveRmsMeterValue(double rms) override;
+
+private:
+    // Create the source selected on the command line
+    bool createSource();
+    // Take the options of "other" for a single device, file names get "suffix"
+    void copyOptions(const ConsoleRunner & other, int deviceNumber, int channel, const std::string & suffix);
+    // Create and open the source, the blocks are analyzed by "pool" if it isn't nullptr
+    bool openSource(AnalysisPool *pool);
+    // Indicates whether the requested duration has been analyzed or the source has no more samples
+    bool isDone() const;
+    // Close the source and return the stream statistics of PortAudio sources
+    StreamStatistics::Snapshot closeSource();
+    // Capture all devices of the command line at the same time
+    int runDevices();
+    // Parse a comma separated list of trigger conditions, e.g. "clip,entropy:6,rms:20,bits"
+    bool parseTriggers(const std::string & triggers);
+    void printResults(double wallTime) const;
+    void printStreamStatistics(const StreamStatistics::Snapshot & statistics) const;
+
+private:
+    // Command line options
+    std::string m_sourceType;
+    std::string m_patternName;
+    std::string m_fileName;
+    // More than one device is captured concurrently
+    std::vector<int> m_deviceNumbers;
+    std::vector<int> m_channels;
+    int m_deviceNumber;
+    int m_channel;
+    // Second channel of a channel pair, 0 if none
+    int m_pairChannel;
+    int m_channelCount;
+    int m_bitDepth;
+    uint32_t m_sampleRate;
+    uint32_t m_blockSize;
+    unsigned long m_framesPerBuffer;
+    double m_duration;
+    bool m_realTime;
+    int m_numberOfBlocks;
+    bool m_entropyDecaying;
+    // Entropy::Mode::Approximate if not 0
+    int m_sketchCounters;
+    double m_sketchMemory;
+    std::string m_spoolPrefix;
+    // Written after the run if not empty
+    std::string m_historyFileName;
+    bool m_triggerEnabled;
+    bool m_missingCodesEnabled;
+
+    uint64_t m_numberOfSamples;
+    std::unique_ptr<SampleSource> m_source;
+    // Same object as m_source if PortAudio is used, otherwise nullptr
+    PortAudioControl *m_portAudioControl;
+    CaptureSpool m_captureSpool;
+    Entropy m_entropy;
+    EntropyProfile m_entropyProfile;
+    PredictionEntropy m_predictionEntropy;
+    LosslessBitrate m_losslessBitrate;
+    MultiResolutionEntropy m_multiResolutionEntropy;
+    ChannelPairEntropy m_channelPairEntropy;
+    // Read once after the source has been closed, so it needs no listener
+    BitDepthEstimator m_bitDepthEstimator;
+    PeakMeter m_peakMeter;
+    RMSMeter m_rmsMeter;
+    RunningMoments m_runningMoments;
+    EntropyHistory m_entropyHistory;
+    EventTrigger m_eventTrigger;
+    // Only sized if enabled, the bitmap alone has 2 MB at 24 bit
+    MissingCodes m_missingCodes;
+    // Shared by the runners of all devices
+    std::unique_ptr<AnalysisPool> m_analysisPool;
+    std::vector<std::unique_ptr<ConsoleRunner>> m_deviceRunners;
+
+    // Results, written by the receiver thread
+    std::atomic<uint64_t> m_receivedSamples;
+    uint64_t m_receivedBlocks;
+    double m_minimumBlockTime;
+    double m_maximumBlockTime;
+    double m_totalBlockTime;
+    double m_entropyValue;
+    // ADC time of the end of the block which completed the last entropy value
+    double m_entropyTime;
+    double m_distinctSymbolsValue;
+    std::vector<double> m_entropyProfileValues;
+    std::vector<double> m_residualEntropyValues;
+    double m_conditionalEntropyValue;
+    int m_conditionalResolution;
+    // Negative until the first window is complete
+    double m_losslessBitrateValue;
+    std::string m_losslessPredictor;
+    std::vector<double> m_multiResolutionEntropyValues;
+    // 0 until the first window of the channel pair is complete
+    int m_pairResolution;
+    double m_pairFirstEntropy;
+    double m_pairSecondEntropy;
+    double m_pairJointEntropy;
+    double m_mutualInformation;
+    double m_blockEndTime;
+    double m_peakValue;
+    double m_rmsValue;
+    // No samples until the first window is complete
+    RunningMoments::Result m_momentsWindow;
+};
+
+#endif // CONSOLERUNNER_H
@@ -0,0 +1,59 @@
+/*
+ * DeviceCapabilityCache: On-disk cache of probed device capabilities
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DEVICECAPABILITYCACHE_H
+#define DEVICECAPABILITYCACHE_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+class DeviceCapabilityCache
+{
+public:
+    DeviceCapabilityCache(const std::string & fileName = "");
+    void setFileName(const std::string & fileName);
+    // Read the cache file, return "false" if it doesn't exist or has an unknown format
+    bool load();
+    // Write the cache file, return "false" if it can't be written
+    bool save() const;
+    // Get the cached sample rates of a device, return "false" if the device hasn't been probed yet
+    bool getSupportedSampleRates(const std::string & key, std::vector<uint32_t> & sampleRates) const;
+    void setSupportedSampleRates(const std::string & key, const std::vector<uint32_t> & sampleRates);
+    // Signature of the device set the cache has been created with
+    const std::string & getDeviceSetSignature() const;
+    void setDeviceSetSignature(const std::string & signature);
+    // Remove all devices which are not part of the given key list
+    void removeOtherDevices(const std::vector<std::string> & keys);
+    void clear();
+
+    // Key of a device consisting of host API and device name
+    static std::string createKey(const std::string & hostApiName, const std::string & deviceName);
+    // Signature of a whole device set (changes if a device is added or removed)
+    static std::string createDeviceSetSignature(std::vector<std::string> keys);
+
+private:
+    std::string m_fileName;
+    std::string m_deviceSetSignature;
+    std::map<std::string, std::vector<uint32_t>> m_supportedSampleRates;
+};
+
+#endif // DEVICECAPABILITYCACHE_H
@@ -0,0 +1,63 @@
+/*
+ * DriftEstimator: Measurement of the actual sample rate against the system clock
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DRIFTESTIMATOR_H
+#define DRIFTESTIMATOR_H
+
+#include <atomic>
+#include <cstdint>
+
+// Least squares fit of the sample index over the system time of all blocks since reset(),
+// the slope is the sample rate measured with the system clock
+class DriftEstimator
+{
+public:
+    DriftEstimator();
+
+    void reset(uint32_t nominalSampleRate);
+    // Called by the receiver thread, "endIndex" is the index of the sample after the block and
+    // "systemTime" the time in nanoseconds since epoch when the block was completed
+    void addBlock(uint64_t endIndex, int64_t systemTime);
+
+    // Can be called from any thread, 0 until the measurement has covered "minimumTime" seconds
+    double getMeasuredSampleRate() const;
+    // Deviation of the measured from the nominal sample rate in ppm (positive: the device runs faster)
+    double getDrift() const;
+    // Seconds of system time covered by the measurement
+    double getMeasurementTime() const;
+
+    // Shorter measurements are dominated by the jitter of the callbacks
+    static constexpr double minimumTime = 2.0;
+
+private:
+    uint32_t m_nominalSampleRate;
+    uint64_t m_firstIndex;
+    int64_t m_firstTime;
+    // Running means and co-moments of time (x) and index (y) relative to the first block
+    uint64_t m_count;
+    double m_meanX;
+    double m_meanY;
+    double m_comomentXY;
+    double m_comomentXX;
+    std::atomic<double> m_measuredSampleRate;
+    std::atomic<double> m_measurementTime;
+};
+
+#endif // DRIFTESTIMATOR_H
@@ -23,8 +23,11 @@
 
 #include <cstdint>
 #include <map>
+#include <unordered_map>
 #include <vector>
 
+#include "EntropySketch.hpp"
+
 class EntropyListener
 {
 public:
@@ -37,6 +40,16 @@ class Entropy
 {
 
 public:
+    enum class Mode
+    {
+        // One value after every "number of blocks" blocks
+        Blocks,
+        // One value after every block, older blocks are weighted down with a time constant of "number of blocks" blocks
+        Decaying,
+        // Same windows as "Blocks", estimated with fixed memory by EntropySketch instead of counting every symbol
+        Approximate
+    };
+
     Entropy(EntropyListener *listener = nullptr);
 
 public:
@@ -49,9 +62,20 @@ public:
     void clear();
     // Reset blockCounter if "Stop" has been pressed
     void reset();
+    // Clears everything
+    void setMode(Mode mode);
+    Mode getMode() const;
+    // Size of the sketch of Mode::Approximate, see EntropySketch::setSize()
+    void setSketchSize(int numberOfCounters, size_t memorySize);
+    const EntropySketch & getSketch() const;
+    // Symbols in the window of the last value (estimated in Mode::Approximate), can be called by the listener
+    double getNumberOfDistinctSymbols() const;
 
 private:
     void calculateEntropy(int blockSize);
+    void addDecayingSamples(const std::vector<int32_t> & signalValues);
+    // Divide all weights by the current increment and drop the negligible ones
+    void normalizeDecayingWeights();
 
 private:
     EntropyListener *m_entropyListener;
@@ -63,6 +87,21 @@ private:
     int m_numberOfBlocks;
     int m_blockSize;
     std::map<int32_t, uint32_t> m_mapSymbolsToOccurrence;
+
+    // Decaying mode: instead of multiplying every weight by the decay factor after each block, new samples get a weight
+    // which grows by 1/decay factor per block ("lazy" scaling). Only the symbols of a block are touched.
+    Mode m_mode;
+    std::unordered_map<int32_t, double> m_decayingWeights;
+    // Weight of a sample of the current block
+    double m_weightIncrement;
+    // Sum of all weights and sum of weight*log2(weight), the entropy is log2(W) - S/W
+    double m_totalWeight;
+    double m_weightLogSum;
+    // Reused for every block
+    std::vector<int32_t> m_sortedSamples;
+
+    EntropySketch m_sketch;
+    double m_numberOfDistinctSymbols;
 };
 
 #endif // ENTROPY_H
@@ -23,6 +23,11 @@
 
 #include <QWidget>
 
+#include <vector>
+
+#include "RunningMoments.hpp"
+
+class QCheckBox;
 class QLabel;
 class QSpinBox;
 
@@ -35,21 +40,47 @@ public:
 
 private:
     QLabel *m_labelEntropy;
+    QLabel *m_labelLossless;
     QLabel *m_labelNumberOfBlocks;
     QSpinBox *m_boxNumberOfBlocks;
+    // Entropy::Mode::Decaying, the number of blocks is the time constant
+    QCheckBox *m_boxDecaying;
     QLabel *m_labelIntegrationTime;
+    QLabel *m_labelPrediction;
+    QLabel *m_labelMultiResolution;
+    QLabel *m_labelChannelPair;
+    QLabel *m_labelMoments;
+    // Placeholder for the area in which the entropy profile is painted
+    QWidget *m_profileArea;
+    std::vector<double> m_profile;
 
 signals:
     void signalNumberOfBlocksChanged(int value);
+    void signalDecayingChanged(bool decaying);
 
 public slots:
     void updateEntropy(double entropy);
     void updateIntegrationTimeLabel(double blockDuration);
+    // Entropy over the number of kept MSBs, see EntropyProfile
+    void updateEntropyProfile(const std::vector<double> & profile);
+    // Entropy of the prediction residuals and conditional entropy, see PredictionEntropy
+    void updatePredictionEntropy(const std::vector<double> & residualEntropy, double conditionalEntropy, int conditionalResolution);
+    // Estimated bitrate of a lossless encoder, see LosslessBitrate
+    void updateLosslessBitrate(double bitsPerSample, QString predictor);
+    // Entropy over 1, 10, 100, ... blocks, see MultiResolutionEntropy
+    void updateMultiResolutionEntropy(const std::vector<double> & entropies);
+    // Joint entropy and mutual information of the input channel and the pair channel, see ChannelPairEntropy
+    void updateChannelPairEntropy(double firstEntropy, double secondEntropy, double jointEntropy, double mutualInformation, int resolution);
+    // DC offset, AC RMS, skewness and kurtosis of the window and since the start, see RunningMoments
+    void updateRunningMoments(RunningMoments::Result window, RunningMoments::Result total);
     void emitNumberOfBlocksChanged(int value);
+    void emitDecayingChanged(bool decaying);
     quint32 getNumberOfBlocks();
+    bool isDecaying();
     void disableUI(bool disable);
 
 protected:
+    // Enable background-color painting of this widget and paint the entropy profile
     virtual void paintEvent(QPaintEvent *) override;
 };
 
@@ -0,0 +1,112 @@
+/*
+ * EntropyHistory: Entropy, peak and RMS of every window with decimated levels for long sessions
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ENTROPYHISTORY_H
+#define ENTROPYHISTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// One record per entropy window, with the highest block peak and the RMS of the window. The windows are counted in blocks,
+// so with decaying entropy (a value after every block) a record is the mean of the values of "number of blocks" blocks.
+// Level 0 keeps the last "levelCapacity" records, every further level combines "levelFactor" records of the level
+// below, so the memory is fixed (about 250 kB) and the top level covers about 28 days with 2.3 s windows.
+class EntropyHistory
+{
+public:
+    static const int numberOfLevels = 6;
+    static const int levelFactor = 4;
+    static const size_t levelCapacity = 1024;
+
+    struct Record
+    {
+        // Seconds since start()
+        double m_startTime;
+        double m_endTime;
+        uint32_t m_numberOfWindows;
+        // Mean of the windows
+        double m_entropy;
+        // In dB, highest block peak and RMS over all samples
+        double m_peak;
+        double m_rms;
+        // End of the last window on the clock of the source: sample index after its last sample and ADC time
+        uint64_t m_endSampleIndex;
+        double m_endAdcTime;
+    };
+
+    EntropyHistory();
+
+    // Clears the history, the times are counted from here
+    void start(uint32_t sampleRate);
+    // Clears the history with the same sample rate, called when another signal is analyzed
+    void clear();
+    // Same window as Entropy, the current window is counted from here
+    void setNumberOfBlocks(int numberOfBlocks);
+
+    // Called from the analysis thread for every block, before the entropy of the block is reported.
+    // "sampleIndex" and "adcTime" are the position of the first sample of the block (see AudioBlock).
+    void addLevels(double peak, double rms, size_t numberOfSamples, uint64_t sampleIndex, double adcTime);
+    // Called from the analysis thread when an entropy value is reported, ends the record if the window is complete
+    void addEntropy(double entropy);
+
+    // Called from any thread: the whole session, oldest first, from the finest level which still holds all of it
+    // (at most levelCapacity + numberOfLevels records)
+    void getRecords(std::vector<Record> & records) const;
+    uint64_t getNumberOfWindows() const;
+    // Every record at the finest resolution which is still available, return "false" if the file can't be written
+    bool writeCsv(const std::string & fileName) const;
+
+private:
+    struct Level
+    {
+        std::vector<Record> m_records;
+        // Number of records written since start(), the newest one is at (m_count-1) % levelCapacity
+        uint64_t m_count;
+        // Combined from the level below, not complete yet
+        Record m_pending;
+        int m_pendingCount;
+    };
+
+    // Add a complete record to "level" and combine it into the next level
+    void pushRecord(int level, const Record & record);
+    static void mergeRecord(Record & record, const Record & other);
+
+private:
+    mutable std::mutex m_mutex;
+    std::vector<Level> m_levels;
+    uint32_t m_sampleRate;
+    uint64_t m_numberOfSamples;
+    int m_numberOfBlocks;
+    // Window which is being filled by addLevels() and addEntropy()
+    int m_blockCounter;
+    uint64_t m_windowStartSample;
+    size_t m_windowSamples;
+    double m_windowPeak;
+    double m_windowPower;
+    double m_windowEntropySum;
+    int m_windowEntropyCount;
+    uint64_t m_windowEndSampleIndex;
+    double m_windowEndAdcTime;
+};
+
+#endif // ENTROPYHISTORY_H
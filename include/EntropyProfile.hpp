@@ -0,0 +1,58 @@
+/*
+ * EntropyProfile: Entropy for every bit depth from 1 bit up to the stream's bit depth
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ENTROPYPROFILE_H
+#define ENTROPYPROFILE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "CodeHistogram.hpp"
+
+class EntropyProfileListener
+{
+public:
+    EntropyProfileListener() {}
+
+    // "profile[bits-1]" is the entropy if the samples are truncated to "bits" bits
+    virtual void receiveEntropyProfile(const std::vector<double> & profile) = 0;
+};
+
+class EntropyProfile
+{
+public:
+    EntropyProfile(EntropyProfileListener *listener = nullptr);
+
+    // Same window as Entropy: a profile is calculated after every "numberOfBlocks" blocks
+    void addSamples(const std::vector<int32_t> & signalValues);
+    void setNumberOfBlocks(int numberOfBlocks);
+    // Clears the histogram
+    void setBitDepth(int bitDepth);
+    void clear();
+
+private:
+    EntropyProfileListener *m_entropyProfileListener;
+    CodeHistogram m_histogram;
+    int m_blockCounter;
+    int m_numberOfBlocks;
+    std::vector<double> m_profile;
+};
+
+#endif // ENTROPYPROFILE_H
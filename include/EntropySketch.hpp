@@ -0,0 +1,92 @@
+/*
+ * EntropySketch: Fixed-memory estimates of the entropy and the number of distinct symbols
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ENTROPYSKETCH_H
+#define ENTROPYSKETCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Approximate entropy and number of distinct symbols of a stream with a memory size which depends neither on the
+// alphabet (bit depth) nor on the number of samples.
+//
+// Entropy: stable sketch of Clifford and Cosma ("A simple sketching algorithm for entropy estimation", 2013).
+// Every symbol s has a pseudo-random value R(s,j) per counter j, drawn from the maximally skewed 1-stable distribution
+// with E[exp(t*R)] = t^t. Counter j is the sum of R(s,j) over all samples, so for the probabilities p_s
+// E[exp(counter/N)] = prod(p_s^p_s) = exp(-H) and Var[exp(counter/N)] = 3*exp(-2H). The mean over k counters gives H with
+// a standard error of about sqrt(3/k) nat = 2.5/sqrt(k) bit, independent of H and of the alphabet.
+//
+// Distinct symbols: HyperLogLog with 2^precision registers (Flajolet et al. 2007, with the small range correction),
+// relative standard error 1.04/sqrt(2^precision).
+//
+// Both sketches are linear in the counts, so the samples are first counted in a fixed-size hash table and a symbol is
+// only passed to the sketches when the table is half full or the estimates are read. This doesn't change the estimates,
+// but the k random values are generated once per distinct symbol of a batch instead of once per sample.
+class EntropySketch
+{
+public:
+    // 2^precision HyperLogLog registers
+    static const int precision = 14;
+
+    EntropySketch();
+
+    // "memorySize" in bytes includes the counters, the registers and the hash table. Clears everything.
+    void setSize(int numberOfCounters, size_t memorySize);
+    int getNumberOfCounters() const;
+    // Bytes actually used
+    size_t getMemorySize() const;
+
+    void addSamples(const std::vector<int32_t> & samples);
+    void clear();
+    uint64_t getNumberOfSamples() const;
+
+    // Entropy in bit (not const, the hash table is passed to the sketches first)
+    double getEntropy();
+    // Standard error of getEntropy() in bit
+    double getEntropyError() const;
+    double getNumberOfDistinctSymbols();
+    // Relative standard error of getNumberOfDistinctSymbols()
+    double getDistinctSymbolsError() const;
+
+private:
+    struct Slot
+    {
+        int32_t m_symbol;
+        // 0 marks an empty slot
+        uint32_t m_count;
+    };
+
+    // Pass all symbols of the hash table to the sketches and empty it
+    void flush();
+    void addSymbol(int32_t symbol, uint32_t count);
+
+private:
+    std::vector<double> m_counters;
+    std::vector<uint8_t> m_registers;
+    std::vector<Slot> m_slots;
+    int m_tableBits;
+    size_t m_numberOfUsedSlots;
+    uint64_t m_numberOfSamples;
+    // Samples counted in the table since the last flush()
+    uint64_t m_pendingSamples;
+};
+
+#endif // ENTROPYSKETCH_H
@@ -0,0 +1,133 @@
+/*
+ * EventTrigger: Writes the samples around analyzer events to WAV files
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EVENTTRIGGER_H
+#define EVENTTRIGGER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "HistoryBuffer.hpp"
+
+class EventTriggerListener
+{
+public:
+    EventTriggerListener() {}
+
+    // Called from the writer thread when an event has been written ("fileName" is empty if writing failed)
+    virtual void receiveTriggerEvent(const std::string & reason, const std::string & fileName) = 0;
+};
+
+class EventTrigger
+{
+public:
+    struct Settings
+    {
+        // A block contains a full-scale sample
+        bool m_clip;
+        // The entropy falls below the threshold (bit)
+        bool m_entropyDrop;
+        double m_entropyThreshold;
+        // The RMS of two consecutive blocks differs by at least the step size (dB)
+        bool m_rmsStep;
+        double m_rmsStepSize;
+        // The set of bits used in a block differs from the previous block
+        bool m_bitChange;
+        // Seconds before and after the trigger which are written, applied by start()
+        double m_preTriggerTime;
+        double m_postTriggerTime;
+        // Path and beginning of the file names
+        std::string m_fileNamePrefix;
+    };
+
+    EventTrigger(EventTriggerListener *listener = nullptr);
+    ~EventTrigger();
+
+    // Can be called from any thread, conditions are applied with the next block
+    void setSettings(const Settings & settings);
+    Settings getSettings() const;
+
+    // Size the history buffer and clear all state, must not be called while blocks are added
+    void start(int bitDepth, uint32_t sampleRate, uint32_t blockSize);
+    // Write a pending event with the samples received so far
+    void stop();
+
+    // Called from the analysis thread with the results of the analyzers for this block
+    void addBlock(const std::vector<int32_t> & samples, bool clipping, double rms);
+    // Called from the analysis thread when a new entropy value has been calculated
+    void addEntropy(double entropy);
+
+    // Number of detected events, including the ones which are still being written
+    uint64_t getNumberOfEvents() const;
+
+private:
+    struct Event
+    {
+        std::vector<int32_t> m_samples;
+        uint64_t m_number;
+        std::string m_reason;
+        std::string m_fileNamePrefix;
+        int m_bitDepth;
+        uint32_t m_sampleRate;
+    };
+
+    void applySettings();
+    // Start an event at the beginning of the current block, ignored while an event is pending
+    void fire(const std::string & reason);
+    // Pass the samples of the pending event to the writer thread
+    void finishEvent();
+    void runWriterThread();
+    static bool writeWaveFile(const std::string & fileName, const std::vector<int32_t> & samples, int bitDepth, uint32_t sampleRate);
+
+private:
+    EventTriggerListener *m_triggerListener;
+    // Settings written by setSettings(), copied by the analysis thread
+    mutable std::mutex m_settingsMutex;
+    Settings m_newSettings;
+    std::atomic<bool> m_settingsChanged;
+    // Used by the analysis thread only
+    Settings m_settings;
+    HistoryBuffer m_history;
+    int m_bitDepth;
+    uint32_t m_sampleRate;
+    uint64_t m_blockIndex;
+    uint32_t m_previousBits;
+    double m_previousRms;
+    double m_previousEntropy;
+    bool m_firstBlock;
+    bool m_eventPending;
+    uint64_t m_triggerIndex;
+    std::string m_triggerReason;
+    // Events which haven't been written yet
+    std::deque<Event> m_events;
+    std::mutex m_eventMutex;
+    std::condition_variable m_eventCondition;
+    std::thread m_writerThread;
+    bool m_writerRunning;
+    std::atomic<uint64_t> m_numberOfEvents;
+};
+
+#endif // EVENTTRIGGER_H
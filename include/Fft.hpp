@@ -0,0 +1,51 @@
+/*
+ * Fft: Radix-2 fast Fourier transform
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FFT_H
+#define FFT_H
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+// Iterative radix-2 FFT, the twiddle factors and the bit reversal are computed once per size
+class Fft
+{
+public:
+    Fft(size_t size = 0);
+
+    // "size" must be a power of two
+    void setSize(size_t size);
+    size_t getSize() const;
+
+    // In-place forward transform of "getSize()" values
+    void transform(std::vector<std::complex<double>> & data) const;
+    // |X[k]|^2 of the bins 0 ... size/2 of the real input "input" (size values)
+    void calculatePowerSpectrum(const std::vector<double> & input, std::vector<double> & power);
+
+private:
+    size_t m_size;
+    std::vector<std::complex<double>> m_twiddles;
+    std::vector<size_t> m_bitReverse;
+    // Reused by calculatePowerSpectrum()
+    std::vector<std::complex<double>> m_buffer;
+};
+
+#endif // FFT_H
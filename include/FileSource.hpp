@@ -0,0 +1,84 @@
+/*
+ * FileSource: Samples read from WAV or raw PCM files
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FILESOURCE_H
+#define FILESOURCE_H
+
+#include <fstream>
+
+#include "SampleSource.hpp"
+
+class FileSource
+    : public SampleSource
+{
+public:
+    FileSource(SampleSourceListener *listener = nullptr);
+    virtual ~FileSource();
+
+    // WAV files and spool segments (CaptureSpool) are detected by their header, everything else is read as raw PCM.
+    // The following segments of a spool are read as well.
+    void setFileName(const std::string & fileName);
+    // Number of interleaved channels of raw PCM files (little endian, bit depth is passed to open())
+    void setRawChannelCount(int channelCount);
+    // Selected channel (1 ... number of channels)
+    void setChannel(int channel);
+    // Deliver samples at the sample rate or as fast as the listener can process them
+    void setRealTime(bool realTime);
+    // Start again at the beginning when the end of the file has been reached
+    void setLoop(bool loop);
+
+    // Bit depth and sample rate are taken from the header of WAV files
+    virtual bool open(int bitDepth, uint32_t sampleRate, uint32_t blockSize) override;
+    virtual void close() override;
+    virtual std::string getName() const override;
+
+protected:
+    virtual size_t generateSamples(int32_t *samples, size_t count) override;
+
+private:
+    // Read the header of a WAV file, return "false" if the file isn't a supported WAV file
+    bool readWaveHeader(int & bitDepth, uint32_t & sampleRate, int & channelCount);
+    // Open the spool segment with the given sequence number, return "false" if it doesn't exist
+    bool openSpoolSegment(uint64_t sequence, int & bitDepth, uint32_t & sampleRate);
+    size_t readSpoolSamples(int32_t *samples, size_t count);
+
+private:
+    std::string m_fileName;
+    std::ifstream m_file;
+    int m_channelCount;
+    int m_channel;
+    bool m_realTime;
+    bool m_loop;
+    // Position and size of the sample data
+    std::streamoff m_dataStart;
+    std::streamoff m_dataSize;
+    std::streamoff m_dataPosition;
+    std::vector<char> m_readBuffer;
+    // Spool segments
+    bool m_spool;
+    std::string m_spoolPrefix;
+    uint64_t m_firstSequence;
+    uint64_t m_sequence;
+    uint32_t m_recordRemaining;
+    // Expected index of the next record, used to detect dropped blocks
+    uint64_t m_nextSampleIndex;
+};
+
+#endif // FILESOURCE_H
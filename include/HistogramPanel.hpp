@@ -0,0 +1,56 @@
+/*
+ * HistogramPanel: Window with the amplitude distribution of the input channel
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HISTOGRAMPANEL_H
+#define HISTOGRAMPANEL_H
+
+#include <QWidget>
+
+#include <cstdint>
+#include <vector>
+
+class QLabel;
+class QPushButton;
+
+class HistogramPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    HistogramPanel(QWidget *parent = 0);
+
+private:
+    QLabel *m_labelSamples;
+    QLabel *m_labelBins;
+    // Placeholder for the area in which the histogram is painted
+    QWidget *m_histogramArea;
+    QPushButton *m_buttonClose;
+    std::vector<uint32_t> m_counts;
+
+public slots:
+    // Decimated counts, see AmplitudeHistogram
+    void updateHistogram(const std::vector<uint32_t> & counts, int codesPerBin);
+
+protected:
+    // Enable background-color painting of this widget and paint the histogram
+    virtual void paintEvent(QPaintEvent *) override;
+};
+
+#endif // HISTOGRAMPANEL_H
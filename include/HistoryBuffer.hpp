@@ -0,0 +1,52 @@
+/*
+ * HistoryBuffer: Circular buffer with the most recent samples
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HISTORYBUFFER_H
+#define HISTORYBUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Samples are addressed by their index in the stream, not by their position in the buffer
+class HistoryBuffer
+{
+public:
+    HistoryBuffer(size_t capacity = 0);
+
+    // Set the number of samples which are kept and clear the buffer
+    void resize(size_t capacity);
+    void clear();
+    void addSamples(const std::vector<int32_t> & samples);
+
+    size_t getCapacity() const;
+    // Index of the next sample which will be added
+    uint64_t getEndIndex() const;
+    // Index of the oldest sample which is still in the buffer
+    uint64_t getBeginIndex() const;
+    // Copy "count" samples starting at "firstIndex", return "false" if they aren't in the buffer (anymore)
+    bool copySamples(uint64_t firstIndex, size_t count, std::vector<int32_t> & samples) const;
+
+private:
+    std::vector<int32_t> m_samples;
+    uint64_t m_endIndex;
+};
+
+#endif // HISTORYBUFFER_H
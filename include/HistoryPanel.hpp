@@ -0,0 +1,73 @@
+/*
+ * HistoryPanel: Window with the entropy and level history of the whole session
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HISTORYPANEL_H
+#define HISTORYPANEL_H
+
+#include <QPainterPath>
+#include <QWidget>
+
+class EntropyHistory;
+class QLabel;
+class QPushButton;
+
+class HistoryPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    // "history" is filled by the analysis thread and read whenever a new entropy value arrives
+    HistoryPanel(const EntropyHistory *history, QWidget *parent = 0);
+
+    // Scale of the graph
+    void setBitDepth(int bitDepth);
+
+private:
+    // Read the history and build the paths in unit coordinates (x: 0 = start, 1 = now, y: 0 = bottom, 1 = top)
+    void updatePaths();
+
+    const EntropyHistory *m_history;
+    int m_bitDepth;
+    QLabel *m_labelHistory;
+    // Placeholder for the area in which the history is painted
+    QWidget *m_historyArea;
+    QPushButton *m_buttonExport;
+    QPushButton *m_buttonClose;
+    // Rebuilt with every entropy value, only transformed when painting
+    QPainterPath m_entropyPath;
+    QPainterPath m_peakPath;
+    QPainterPath m_rmsPath;
+
+signals:
+    void signalExportRequested();
+
+public slots:
+    // A record may have been completed
+    void updateHistory();
+    void emitExportRequested();
+    // "fileName" is empty if the history couldn't be written
+    void updateExport(QString fileName);
+
+protected:
+    // Enable background-color painting of this widget and paint the history
+    virtual void paintEvent(QPaintEvent *) override;
+};
+
+#endif // HISTORYPANEL_H
@@ -0,0 +1,106 @@
+/*
+ * LosslessBitrate: Estimated bitrate of a FLAC-like lossless encoding
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LOSSLESSBITRATE_H
+#define LOSSLESSBITRATE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class LosslessBitrateListener
+{
+public:
+    LosslessBitrateListener() {}
+
+    // "bitsPerSample" over the window, "predictor" is the one chosen for most blocks
+    virtual void receiveLosslessBitrate(double bitsPerSample, const char *predictor) = 0;
+};
+
+// Runs the model of a FLAC encoder over every block without producing a bitstream. A block is one frame, its subframe is
+// the smallest of: verbatim, constant, fixed predictor of order 0 - 4 or LPC up to order 8 with quantized coefficients.
+// Zero LSBs are removed first ("wasted bits"). Residuals are Rice coded with one parameter per partition, the partition
+// order is searched; like in FLAC the Rice size is estimated from the sum of the absolute residuals of a partition.
+// Frame headers and CRCs aren't counted.
+class LosslessBitrate
+{
+public:
+    enum class Predictor
+    {
+        Verbatim,
+        Constant,
+        Fixed0,
+        Fixed1,
+        Fixed2,
+        Fixed3,
+        Fixed4,
+        Lpc,
+        NumberOfPredictors
+    };
+
+    static const int maximumFixedOrder = 4;
+    static const int maximumLpcOrder = 8;
+    static const int maximumPartitionOrder = 8;
+
+    LosslessBitrate(LosslessBitrateListener *listener = nullptr);
+
+    // Same window as Entropy: the bitrate is reported after every "numberOfBlocks" blocks
+    void addSamples(const std::vector<int32_t> & signalValues);
+    void setNumberOfBlocks(int numberOfBlocks);
+    // Clears the window
+    void setBitDepth(int bitDepth);
+    void clear();
+
+    // Bits of the subframe which codes "signalValues"
+    uint64_t estimateBlockBits(const std::vector<int32_t> & signalValues, Predictor & predictor);
+    static const char *getPredictorName(Predictor predictor);
+
+private:
+    // Bits of the Rice coded residual in m_residual[order ... m_size-1] with the best partition order
+    uint64_t estimateResidualBits(int order);
+    // Bits of the LPC subframe, Levinson-Durbin on the windowed block
+    uint64_t estimateLpcBits(int bitDepth);
+    // Bits of one Rice partition with the best parameter
+    uint64_t estimatePartitionBits(uint64_t absoluteSum, uint64_t numberOfSamples) const;
+    void updateWindow();
+
+private:
+    LosslessBitrateListener *m_losslessBitrateListener;
+    int m_bitDepth;
+    int m_blockCounter;
+    int m_numberOfBlocks;
+    uint64_t m_windowBits;
+    uint64_t m_windowSamples;
+    std::array<int, static_cast<int>(Predictor::NumberOfPredictors)> m_predictorCounts;
+
+    // Reused for every block
+    size_t m_size;
+    int m_maximumRiceParameter;
+    std::vector<int64_t> m_samples;
+    std::vector<int64_t> m_residual;
+    std::vector<int64_t> m_difference;
+    std::vector<uint64_t> m_partitionSums;
+    // Tukey(0.5) window for the LPC analysis, zero padded by the maximum LPC order
+    std::vector<double> m_window;
+    std::vector<double> m_windowed;
+};
+
+#endif // LOSSLESSBITRATE_H
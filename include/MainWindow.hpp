@@ -23,26 +23,57 @@
 
 #include <QMainWindow>
 
+#include "AmplitudeHistogram.hpp"
+#include "BitDepthEstimator.hpp"
+#include "CaptureSpool.hpp"
+#include "ChannelPairEntropy.hpp"
 #include "PortAudioControl.hpp"
+#include "DeviceCapabilityCache.hpp"
 #include "Entropy.hpp"
+#include "EntropyHistory.hpp"
+#include "EntropyProfile.hpp"
+#include "EventTrigger.hpp"
+#include "LosslessBitrate.hpp"
+#include "MultiResolutionEntropy.hpp"
 #include "PeakMeter.hpp"
+#include "PredictionEntropy.hpp"
 #include "RMSMeter.hpp"
+#include "RunningMoments.hpp"
+#include "SettingsMailbox.hpp"
+#include "Spectrogram.hpp"
+#include "WaveformPyramid.hpp"
 
 class OptionPanel;
 class BitDisplay;
 class MeterDisplay;
 class EntropyDisplay;
+class HistogramPanel;
 class InfoWindow;
+class SpectrogramPanel;
+class HistoryPanel;
+class StatisticsPanel;
+class TriggerPanel;
+class WaveformPanel;
 
 class QHBoxLayout;
 class QVBoxLayout;
+class QTimer;
 
 class MainWindow
     : public QMainWindow
     , public PortAudioControlListener
     , public EntropyListener
+    , public EntropyProfileListener
+    , public PredictionEntropyListener
+    , public LosslessBitrateListener
+    , public MultiResolutionEntropyListener
+    , public ChannelPairEntropyListener
+    , public AmplitudeHistogramListener
     , public PeakMeterListener
     , public RMSMeterListener
+    , public RunningMomentsListener
+    , public EventTriggerListener
+    , public BitDepthEstimatorListener
 {
     Q_OBJECT
 
@@ -51,9 +82,18 @@ public:
     virtual ~MainWindow ();
 
 public:
-    virtual void receivePortAudioSamples(const std::vector<int32_t> & samples) override;
+    virtual void receiveSourceSamples(const AudioBlock & block) override;
+    virtual void receiveSupportedSampleRates(int deviceNumber, const std::vector<uint32_t> & sampleRates) override;
+    virtual void receiveProbingFinished(bool completed) override;
 
     virtual void receiveEntropy(double entropy) override;
+    virtual void receiveEntropyProfile(const std::vector<double> & profile) override;
+    virtual void receivePredictionEntropy(const std::vector<double> & residualEntropy, double conditionalEntropy, int conditionalResolution) override;
+    virtual void receiveLosslessBitrate(double bitsPerSample, const char *predictor) override;
+    virtual void receiveMultiResolutionEntropy(const std::vector<double> & entropies) override;
+    virtual void receiveChannelPairEntropy(double firstEntropy, double secondEntropy, double jointEntropy,
+                                           double mutualInformation, int resolution) override;
+    virtual void receiveAmplitudeHistogram(const std::vector<uint32_t> & counts, int codesPerBin) override;
 
     virtual void receivePeakHolderValue(double value) override;
     virtual void receivePeakMeterValue(double value) override;
@@ -61,6 +101,12 @@ public:
     virtual void receiveRmsHolderValue(double rms) override;
     virtual void receiveRmsMeterValue(double rms) override;
 
+    virtual void receiveRunningMoments(const RunningMoments::Result & window, const RunningMoments::Result & total) override;
+
+    virtual void receiveTriggerEvent(const std::string & reason, const std::string & fileName) override;
+
+    virtual void receiveBitDepthEstimate(int bitDepth, int effectiveBitDepth, int noiseBits, const char *verdict) override;
+
 private:
     // Struct with information of all input devices
     struct DeviceInformation
@@ -70,8 +116,15 @@ private:
         PaHostApiTypeId m_hostApi;
         int m_maxInputChannels;
         std::vector<uint32_t> m_supportedSampleRates;
+        // Key in the capability cache
+        std::string m_cacheKey;
+        // Indicates whether the sample rates have been probed or read from the cache
+        bool m_probed;
     };
     std::vector<DeviceInformation> m_devices;
+    DeviceCapabilityCache m_capabilityCache;
+    // Signature of the currently connected devices
+    std::string m_deviceSetSignature;
 
     // Struct with selected parameters in optionsPanel
     struct SelectedParameters
@@ -84,30 +137,85 @@ private:
         quint32 m_blockSize;
         int m_bitDepth;
         int m_channel;
+        // Second channel of a channel pair (0 if none), applied when the stream is started
+        int m_pairChannel;
+        PortAudioControl::CaptureMode m_captureMode;
+        // 0 lets the host API choose
+        quint32 m_framesPerBuffer;
+        bool m_recording;
+        bool m_littleEndian;
+        // Seconds in which the meters fall by 20 dB
+        double m_meterFallTime;
     };
     SelectedParameters m_parameters;
 
+    // Parameters which can be changed while the stream is running, applied by the analysis thread between two blocks
+    struct AnalysisConfiguration
+    {
+        int m_numberOfBlocks;
+        // Entropy::Mode::Decaying instead of Blocks
+        bool m_decayingEntropy;
+        // Meter fall per block in dB
+        double m_returnTimeValue;
+        int m_channel;
+        bool m_littleEndian;
+    };
+    SettingsMailbox<AnalysisConfiguration> m_analysisConfiguration;
+    // Configuration used by the analysis thread
+    AnalysisConfiguration m_activeConfiguration;
+
     // Objects
     OptionPanel *m_optionsPanel;
     BitDisplay *m_bitDisplay;
     std::unique_ptr<Entropy> m_entropy;
+    std::unique_ptr<EntropyProfile> m_entropyProfile;
+    std::unique_ptr<PredictionEntropy> m_predictionEntropy;
+    std::unique_ptr<LosslessBitrate> m_losslessBitrate;
+    std::unique_ptr<MultiResolutionEntropy> m_multiResolutionEntropy;
+    std::unique_ptr<ChannelPairEntropy> m_channelPairEntropy;
+    std::unique_ptr<AmplitudeHistogram> m_amplitudeHistogram;
+    // Read by m_waveformPanel
+    std::unique_ptr<WaveformPyramid> m_waveformPyramid;
+    // Read by m_spectrogramPanel
+    std::unique_ptr<Spectrogram> m_spectrogram;
+    std::unique_ptr<BitDepthEstimator> m_bitDepthEstimator;
     PeakMeter *m_peakMeter;
     std::unique_ptr<RMSMeter> m_rmsMeter;
+    std::unique_ptr<RunningMoments> m_runningMoments;
+    // Read by m_historyPanel
+    std::unique_ptr<EntropyHistory> m_entropyHistory;
     MeterDisplay *m_meterDisplay;
+    std::unique_ptr<EventTrigger> m_eventTrigger;
+    // Must outlive m_portAudioControl, which closes it when the stream is closed
+    CaptureSpool m_captureSpool;
     std::unique_ptr<PortAudioControl> m_portAudioControl;
     EntropyDisplay *m_entropyDisplay;
     InfoWindow *m_infoWindow;
+    StatisticsPanel *m_statisticsPanel;
+    HistogramPanel *m_histogramPanel;
+    WaveformPanel *m_waveformPanel;
+    SpectrogramPanel *m_spectrogramPanel;
+    HistoryPanel *m_historyPanel;
+    TriggerPanel *m_triggerPanel;
+    // Polls CPU load and latency while the stream is running
+    QTimer *m_streamStatusTimer;
 
     QHBoxLayout *m_mainHLayout;
     QVBoxLayout *m_mainVLayout;
     QHBoxLayout *m_mainLayout;
 
     void initializeUI();
-    // Fill device info struct
+    // Fill device info struct (sample rates are taken from the capability cache)
     bool getDeviceInformation();
+    // Probe all devices without known sample rates in the background
+    void probeUnknownDevices();
     // Fill UI elements of optionsPanel
     bool setOptions();
     void connectUI();
+    // Pass the current analysis parameters to the analysis thread
+    void publishAnalysisConfiguration();
+    // Called by the analysis thread before a block is analyzed
+    void applyAnalysisConfiguration(const AnalysisConfiguration & configuration);
 
 protected:
     virtual void resizeEvent(QResizeEvent *event) override;
@@ -125,21 +233,56 @@ private slots:
     void anotherBlockSizeSelected(int blockSize);
     void anotherBitDepthSelected(int bits);
     void anotherChannelSelected(int channel);
+    void anotherPairChannelSelected(int pairChannel);
+    void anotherCaptureModeSelected(int captureMode);
+    void anotherHardwareBufferSelected(int framesPerBuffer);
+    void anotherByteOrderSelected(bool littleEndian);
+    void anotherMeterFallTimeSelected(double fallTime);
+    void recordingChanged(bool record);
     void setEntropyNumberOfBlocks(int numberOfBlocks);
+    void setEntropyDecaying(bool decaying);
     void showAsioPanel();
     void showInfoWindow();
+    void showStatisticsPanel();
+    void showHistogramPanel();
+    void showWaveformPanel();
+    void showSpectrogramPanel();
+    void showHistoryPanel();
+    void showTriggerPanel();
+    void triggerSettingsChanged();
+    // Probe all devices again, ignoring the capability cache
+    void rescanDevices();
+    void updateSupportedSampleRates(int deviceNumber, std::vector<uint32_t> sampleRates);
+    void finishProbing(bool completed);
     void updateEntropyDisplay(double entropy);
+    void updateEntropyProfile(std::vector<double> profile);
     void updatePeakHolder(double value);
     void updatePeakMeter(double value);
     void updateRmsHolder(double value);
     void updateRmsMeter(double value);
+    void updateStreamStatus();
+    void updateTriggerEvents(QString fileName);
+    // Write the history into the application data directory
+    void exportHistory();
 
 signals:
     void signalUpdateEntropyDisplay(double entropy);
+    void signalUpdateEntropyProfile(std::vector<double> profile);
+    void signalUpdatePredictionEntropy(std::vector<double> residualEntropy, double conditionalEntropy, int conditionalResolution);
+    void signalUpdateLosslessBitrate(double bitsPerSample, QString predictor);
+    void signalUpdateMultiResolutionEntropy(std::vector<double> entropies);
+    void signalUpdateChannelPairEntropy(double firstEntropy, double secondEntropy, double jointEntropy, double mutualInformation, int resolution);
+    void signalUpdateAmplitudeHistogram(std::vector<uint32_t> counts, int codesPerBin);
     void signalUpdatePeakHolder(double value);
     void signalUpdatePeakMeter(double value);
     void signalUpdateRmsHolder(double value);
     void signalUpdateRmsMeter(double value);
+    void signalUpdateRunningMoments(RunningMoments::Result window, RunningMoments::Result total);
+    void signalSupportedSampleRatesReceived(int deviceNumber, std::vector<uint32_t> sampleRates);
+    void signalProbingFinished(bool completed);
+    void signalTriggerEvent(QString fileName);
+    void signalUpdateBitDepthEstimate(int bitDepth, int effectiveBitDepth, int noiseBits, QString verdict);
+    void signalUpdateBitStatistics(BitStatistics::Snapshot statistics);
 };
 
 
@@ -0,0 +1,91 @@
+/*
+ * MissingCodes: Missing code, DNL and INL analysis for ADC linearity tests
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MISSINGCODES_H
+#define MISSINGCODES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Code density test: the stimulus (ramp or uniform noise) should hit every code equally often.
+// Missing codes are taken from an occupancy bitmap at full resolution (2 MB at 24 bit), DNL and INL from a histogram
+// with at most "maximumDensityBits" bits (the codes are grouped above), so the memory stays bounded for 24 bit streams.
+class MissingCodes
+{
+public:
+    static const int maximumDensityBits = 20;
+    // Number of missing codes which are listed in the result
+    static const size_t maximumListedCodes = 16;
+
+    struct Result
+    {
+        int m_bitDepth;
+        // Resolution of the DNL and INL
+        int m_densityBits;
+        uint64_t m_numberOfSamples;
+        // Smallest and largest sample value which occurred, only codes in between can be missing
+        int32_t m_minimumValue;
+        int32_t m_maximumValue;
+        uint64_t m_missingCodes;
+        // Smallest missing sample values
+        std::vector<int32_t> m_firstMissingValues;
+        // In LSB of the density resolution, the first and the last code of the range are excluded (they collect the overload)
+        double m_minimumDnl;
+        double m_maximumDnl;
+        double m_minimumInl;
+        double m_maximumInl;
+    };
+
+    MissingCodes();
+
+    // Clears the bitmap and the histogram
+    void setBitDepth(int bitDepth);
+    void addSamples(const std::vector<int32_t> & signalValues);
+    void clear();
+
+    Result getResult() const;
+    // DNL and INL for every code of the density histogram in the occupied range, empty if there are less than three codes
+    void getLinearity(std::vector<double> & dnl, std::vector<double> & inl) const;
+
+private:
+    uint32_t toCode(int32_t sample) const
+    {
+        return (static_cast<uint32_t>(sample) ^ m_signBit) & m_mask;
+    }
+    int32_t toValue(uint32_t code) const
+    {
+        return static_cast<int32_t>(code - m_signBit);
+    }
+
+private:
+    int m_bitDepth;
+    int m_densityShift;
+    uint32_t m_mask;
+    uint32_t m_signBit;
+    // One bit per code
+    std::vector<uint64_t> m_occupancy;
+    std::vector<uint64_t> m_density;
+    uint64_t m_numberOfSamples;
+    uint32_t m_minimumCode;
+    uint32_t m_maximumCode;
+};
+
+#endif // MISSINGCODES_H
@@ -0,0 +1,73 @@
+/*
+ * MultiResolutionEntropy: Entropy over several window lengths at once
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MULTIRESOLUTIONENTROPY_H
+#define MULTIRESOLUTIONENTROPY_H
+
+#include <cstdint>
+#include <vector>
+
+#include "CodeHistogram.hpp"
+
+class MultiResolutionEntropyListener
+{
+public:
+    MultiResolutionEntropyListener() {}
+
+    // "entropies[level]" is the entropy of the last complete window of "levelFactor^level" blocks, negative if there is none yet
+    virtual void receiveMultiResolutionEntropy(const std::vector<double> & entropies) = 0;
+};
+
+// Windows of 1, 10, 100, ... blocks from one pass over the samples. Every level keeps one partial histogram: the blocks go
+// into level 0, and a level which has collected "levelFactor" windows of the level below is complete; its entropy is
+// calculated, then it is merged into the next level and cleared. Every sample is counted once and the memory grows with
+// the number of levels, i.e. logarithmically with the longest window.
+class MultiResolutionEntropy
+{
+public:
+    static const int levelFactor = 10;
+
+    MultiResolutionEntropy(MultiResolutionEntropyListener *listener = nullptr);
+
+    // The listener is called whenever at least one window is complete, i.e. after every block
+    void addSamples(const std::vector<int32_t> & signalValues);
+    // Windows of 1 ... levelFactor^(numberOfLevels-1) blocks, clears everything
+    void setNumberOfLevels(int numberOfLevels);
+    int getNumberOfLevels() const;
+    static int getNumberOfBlocks(int level);
+    // Clears everything
+    void setBitDepth(int bitDepth);
+    void clear();
+
+private:
+    struct Level
+    {
+        CodeHistogram m_histogram;
+        // Windows of the level below merged so far
+        int m_numberOfParts;
+    };
+
+    MultiResolutionEntropyListener *m_multiResolutionEntropyListener;
+    int m_bitDepth;
+    std::vector<Level> m_levels;
+    std::vector<double> m_entropies;
+};
+
+#endif // MULTIRESOLUTIONENTROPY_H
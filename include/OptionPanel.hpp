@@ -26,7 +26,10 @@
 class QVBoxLayout;
 class QHBoxLayout;
 class QFormLayout;
+class QCheckBox;
 class QComboBox;
+class QDoubleSpinBox;
+class QLabel;
 class QPushButton;
 class QSpinBox;
 
@@ -40,8 +43,12 @@ public:
     void setHostApis(QList<QString> name, QList<int> apiIndex);
     void setInputDevices(QList<QString> name, QList<int> boxIndex);
     void setChannels(int numberOfChannels);
+    // Selects "channel" again without a signal and shows the reason why the other one can't be used
+    void rejectInputChannel(int channel, QString reason);
     void setBitDepths(QList<int> bitDepths);
     void setSampleRates(const std::vector<uint32_t> & sampleRates);
+    // Show CPU load (0.0 - 1.0), latency (seconds) and drift (ppm) of the running stream, the drift only if "driftValid" is true
+    void setStreamStatus(double cpuLoad, double latency, bool driftValid, double drift);
 
     // Disable or enable UI when stream is being opened or closed
     void disableUI(bool disable);
@@ -57,12 +64,26 @@ private:
     QComboBox *m_boxHostAPI;
     QComboBox *m_boxSampleRate;
     QComboBox *m_boxInputChannel;
+    QComboBox *m_boxPairChannel;
     QComboBox *m_boxBitDepth;
     QSpinBox *m_boxBlockSize;
+    QComboBox *m_boxCaptureMode;
+    QComboBox *m_boxHardwareBuffer;
+    QComboBox *m_boxByteOrder;
+    QDoubleSpinBox *m_boxMeterFallTime;
+    QCheckBox *m_checkBoxRecord;
+    QLabel *m_labelStreamStatus;
     QPushButton *m_buttonStart;
     QPushButton *m_buttonStop;
     QPushButton *m_buttonShowAsioPanel;
     QPushButton *m_buttonInfo;
+    QPushButton *m_buttonRescan;
+    QPushButton *m_buttonStatistics;
+    QPushButton *m_buttonHistogram;
+    QPushButton *m_buttonWaveform;
+    QPushButton *m_buttonSpectrogram;
+    QPushButton *m_buttonHistory;
+    QPushButton *m_buttonTriggers;
 
 protected:
     virtual void paintEvent(QPaintEvent *) override;
@@ -71,23 +92,50 @@ signals:
     void signalHostApiChanged(int apiId);
     void signalInputDeviceChanged(int deviceId);
     void signalInputChannelChanged(int channel);
+    // 0 if no channel pair is analyzed
+    void signalPairChannelChanged(int pairChannel);
     void signalBitDepthChanged(int bitDepth);
     void signalSampleRateChanged(int sampleRate);
     void signalBlockSizeChanged(int blockSize);
+    void signalCaptureModeChanged(int captureMode);
+    void signalHardwareBufferChanged(int framesPerBuffer);
+    void signalByteOrderChanged(bool littleEndian);
+    void signalMeterFallTimeChanged(double fallTime);
+    void signalRecordingChanged(bool record);
     void signalStartButtonPressed();
     void signalStopButtonPressed();
     void signalInfoButtonPressed();
+    void signalRescanButtonPressed();
+    void signalStatisticsButtonPressed();
+    void signalHistogramButtonPressed();
+    void signalWaveformButtonPressed();
+    void signalSpectrogramButtonPressed();
+    void signalHistoryButtonPressed();
+    void signalTriggersButtonPressed();
 
 private slots:
     void emitHostApiChanged(int index);
     void emitInputDeviceChanged(int index);
     void emitInputChannelChanged(QString channel);
+    void emitPairChannelChanged(int index);
     void emitBitDepthChanged(QString bitDepth);
     void emitSampleRateChanged(QString sampleRate);
     void emitBlockSizeChanged(int blockSize);
+    void emitCaptureModeChanged(int index);
+    void emitHardwareBufferChanged(int index);
+    void emitByteOrderChanged(int index);
+    void emitMeterFallTimeChanged(double fallTime);
+    void emitRecordingChanged(bool record);
     void emitStartButtonPressed();
     void emitStopButtonPressed();
     void emitInfoButtonPressed();
+    void emitRescanButtonPressed();
+    void emitStatisticsButtonPressed();
+    void emitHistogramButtonPressed();
+    void emitWaveformButtonPressed();
+    void emitSpectrogramButtonPressed();
+    void emitHistoryButtonPressed();
+    void emitTriggersButtonPressed();
 };
 
 #endif // OPTIONPANEL_H
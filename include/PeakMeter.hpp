@@ -41,6 +41,10 @@ public:
     void setReturnTimeValue(double value);
     void updateMeter(const std::vector<int32_t> & signalValues);
     void updateBitdepth(int bitdepth);
+    // Indicates whether the last block contained a full-scale sample
+    bool isClipping() const;
+    // Peak of the last block in dB (without return time)
+    double getBlockPeak() const;
 
 private:
     // Get maximum value of all samples
@@ -59,6 +63,7 @@ private:
     uint32_t m_maxValue;
     uint32_t m_absoluteValue;
     double m_maximumDynamicRange;
+    double m_blockPeak;
 };
 
 #endif // PEAKMETER_H
@@ -21,25 +21,43 @@
 #ifndef PORTAUDIOCONTROL_H
 #define PORTAUDIOCONTROL_H
 
+#include <atomic>
+#include <memory>
+#include <thread>
 #include <vector>
 #include <portaudio.h>
 
 #include "PortAudioIO.hpp"
-#include "RingBuffer.hpp"
+#include "SampleSource.hpp"
+#include "StreamStatistics.hpp"
 
 class PortAudioControlListener
+    : public SampleSourceListener
 {
 public:
     PortAudioControlListener() {}
 
-    virtual void receivePortAudioSamples(const std::vector<int32_t> & samples) = 0;
+    // Called from the probing thread for every probed device
+    virtual void receiveSupportedSampleRates(int deviceNumber, const std::vector<uint32_t> & sampleRates) = 0;
+    // Called from the probing thread when all devices have been probed or probing has been cancelled
+    virtual void receiveProbingFinished(bool completed) = 0;
 };
 
 class PortAudioControl
-    : public RingBufferReceiver
+    : public SampleSource
 {
 public:
+    // How the samples are taken from PortAudio
+    enum class CaptureMode
+    {
+        // PortAudio calls the callback function for every buffer
+        Callback,
+        // A dedicated thread reads large batches with Pa_ReadStream
+        BlockingRead
+    };
+
     PortAudioControl(PortAudioControlListener *listener = nullptr);
+    virtual ~PortAudioControl();
     // Initialize PortAudio, return "true" if everything is okay
     bool initialize();
     // Get an array with all PortAudio devices
@@ -48,21 +66,63 @@ public:
     const PaHostApiInfo & getApiInfo(int apiIndex);
     // Get the supported samples rates for a specific device
     const std::vector<uint32_t> & getSupportedSampleRates(int deviceNumber);
+    // Probe the supported sample rates of the given devices in a background thread, results are passed to the listener
+    void probeSupportedSampleRates(const std::vector<int> & deviceNumbers);
+    // Stop probing after the current sample rate test
+    void cancelProbing();
     // Open stream with given parameters
-    bool openStream(int deviceNumber, int channel, int bitDepth, uint32_t sampleRate, uint32_t blockSize);
+    bool openStream(int deviceNumber, int channel, int bitDepth, uint32_t sampleRate, uint32_t blockSize,
+                    CaptureMode captureMode = CaptureMode::Callback);
     void closeStream();
+    // Device and channel used by open()
+    void setDevice(int deviceNumber, int channel);
+    // Select another channel while the stream is running, return "false" if the channel isn't captured
+    bool setChannel(int channel);
+    // Byte order of the samples, can be changed while the stream is running
+    void setLittleEndian(bool littleEndian);
+    void setCaptureMode(CaptureMode captureMode);
+    // Frames per PortAudio buffer, independent of the block size (0 lets the host API choose)
+    void setFramesPerBuffer(unsigned long framesPerBuffer);
+    // Fraction of the available time which is spent capturing and decoding samples (0.0 - 1.0)
+    double getCpuLoad() const;
+    // Time in seconds until a sample has been written to the ring buffer
+    double getInputLatency() const;
+    // Callback timing, overflows and queue depth since the stream has been opened
+    StreamStatistics::Snapshot getStreamStatistics() const;
+
+    virtual bool open(int bitDepth, uint32_t sampleRate, uint32_t blockSize) override;
+    virtual void close() override;
+    virtual std::string getName() const override;
 
-    virtual void receiveSamples(const std::vector<int32_t> & samples) override;
+private:
+    std::vector<uint32_t> querySupportedSampleRates(int deviceNumber);
+    void probeDevices(std::vector<int> deviceNumbers);
+    // Thread function of CaptureMode::BlockingRead
+    void runReaderThread();
 
 private:
     PortAudioControlListener *m_controlListener;
     PaStream *m_stream;
-    std::shared_ptr<RingBuffer> m_buffer;
+    int m_deviceNumber;
+    int m_channel;
     // Array with custom data to pass to the callback function
     PortAudioIO::PortAudioUserData m_data;
+    std::shared_ptr<StreamStatistics> m_statistics;
     std::vector<PaDeviceInfo> m_deviceInfos;
     PaHostApiInfo m_apiInfo;
     std::vector<uint32_t> m_supportedSampleRates;
+    // Pa_IsFormatSupported can take a long time on some host APIs, so devices are probed in the background
+    std::thread m_probingThread;
+    std::atomic<bool> m_cancelProbing;
+    CaptureMode m_captureMode;
+    unsigned long m_framesPerBuffer;
+    // Reader thread for CaptureMode::BlockingRead
+    std::thread m_readerThread;
+    std::atomic<bool> m_readerRunning;
+    std::vector<int8_t> m_readBuffer;
+    unsigned long m_framesPerRead;
+    // PortAudio only measures the CPU load of callback streams
+    std::atomic<double> m_readerCpuLoad;
 };
 
 #endif // PORTAUDIOCONTROL_H
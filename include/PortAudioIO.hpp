@@ -21,34 +21,47 @@
 #ifndef PORTAUDIOIO_H
 #define PORTAUDIOIO_H
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 
 #include "portaudio.h"
 
 class RingBuffer;
+class StreamStatistics;
 
 class PortAudioIO
 {
 
 public:
     PortAudioIO();
-    // PortAudio callback function
-    static int getInputCallback(const void *input, void *output, unsigned long frameCount,
-                                             const PaStreamCallbackTimeInfo* timeInfo,
-                                             PaStreamCallbackFlags statusFlags, void *userData);
 
     // Array with custom user data which is passed to the callback function
     struct PortAudioUserData
     {
         std::shared_ptr<RingBuffer> m_buffer;
+        std::shared_ptr<StreamStatistics> m_statistics;
         int m_bitDepth;
-        bool m_littleEndian;
-        int m_channel;
+        // Channel and byte order can be changed while the stream is running, they are read once per callback
+        std::atomic<bool> m_littleEndian;
+        // Selected channel (1 ... m_channelCount)
+        std::atomic<int> m_channel;
+        // Number of interleaved channels in each frame
+        int m_channelCount;
+        // Second channel of a channel pair (0 if none), fixed while the stream is open
+        int m_pairChannel;
     };
 
-private:
-    static uint32_t sampleCounter;
+    // PortAudio callback function
+    static int getInputCallback(const void *input, void *output, unsigned long frameCount,
+                                             const PaStreamCallbackTimeInfo* timeInfo,
+                                             PaStreamCallbackFlags statusFlags, void *userData);
+
+    // Decode the selected channel (and the pair channel) of interleaved input frames and write the samples to the ring buffer
+    static void decodeSamples(const void *input, unsigned long frameCount, PortAudioUserData *data);
+    // Decode one channel of interleaved integer frames (8, 16 or 24 bit) into "samples"
+    static void decodeFrames(const void *input, size_t frameCount, int bitDepth, bool littleEndian,
+                             int channelCount, int channel, int32_t *samples);
 };
 
 #endif // PORTAUDIOIO_H
@@ -0,0 +1,100 @@
+/*
+ * PredictionEntropy: Entropy of prediction residuals and conditional entropy of consecutive samples
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PREDICTIONENTROPY_H
+#define PREDICTIONENTROPY_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "ChannelPairEntropy.hpp"
+#include "CodeHistogram.hpp"
+
+class PredictionEntropyListener
+{
+public:
+    PredictionEntropyListener() {}
+
+    // "residualEntropy[order-1]" is the entropy of the residual of the fixed predictor of that order,
+    // "conditionalEntropy" the entropy of a sample if the previous sample is known, counted with the "conditionalResolution"
+    // most significant bits of both samples (see PredictionEntropy)
+    virtual void receivePredictionEntropy(const std::vector<double> & residualEntropy, double conditionalEntropy,
+                                          int conditionalResolution) = 0;
+};
+
+// The zeroth-order entropy of the samples overestimates the bits a lossless coder needs, because consecutive samples are correlated.
+// The fixed predictors are the ones of FLAC: order 1 is the first difference, order 2 the second difference, and so on.
+// Conditional entropy H(x[n] | x[n-1]) = H(x[n-1], x[n]) - H(x[n-1]) is counted by a ChannelPairEntropy on the pairs of
+// consecutive samples. A window has far fewer samples than the joint code space, so the LSBs of both samples are dropped
+// until there are at least ChannelPairEntropy::samplesPerPair samples per distinct pair. Otherwise both entropies would be
+// capped near log2(window) and their difference would show noise as almost perfectly predictable. Each dropped bit of the
+// current sample adds its own binary entropy, counted over the window: 1 bit for a noisy LSB, 0 for a bit which never
+// changes. That is an upper bound for the dropped bits, so a signal is never shown as more predictable than it is.
+// The residual histograms are cleared after every window and have at most 2^maximumTableBits slots (16 MB each). A window
+// with more distinct residuals is counted without their LSBs, and every dropped bit is added to the entropy again (see
+// CodeHistogram).
+class PredictionEntropy : private ChannelPairEntropyListener
+{
+public:
+    static const int maximumOrder = 4;
+    static const int maximumTableBits = 20;
+
+    PredictionEntropy(PredictionEntropyListener *listener = nullptr);
+
+    // Same window as Entropy: the values are calculated after every "numberOfBlocks" blocks
+    void addSamples(const std::vector<int32_t> & signalValues);
+    void setNumberOfBlocks(int numberOfBlocks);
+    // Clears everything
+    void setBitDepth(int bitDepth);
+    // Clear the histograms and the history of previous samples
+    void clear();
+
+private:
+    virtual void receiveChannelPairEntropy(double firstEntropy, double secondEntropy, double jointEntropy,
+                                           double mutualInformation, int resolution) override;
+    void clearHistograms();
+
+private:
+    PredictionEntropyListener *m_predictionEntropyListener;
+    int m_bitDepth;
+    int m_blockCounter;
+    int m_numberOfBlocks;
+    // Last value of each difference order, valid for the orders below m_historyLength
+    std::array<int64_t, maximumOrder> m_lastDifferences;
+    int m_historyLength;
+    int32_t m_previousValue;
+
+    std::array<CodeHistogram, maximumOrder> m_residualHistograms;
+    // First channel is the previous sample, second channel the current one
+    ChannelPairEntropy m_pairEntropy;
+    double m_conditionalEntropy;
+    int m_conditionalResolution;
+    // Set bits of the current samples of the pairs in the window, index is the bit
+    std::array<uint64_t, 32> m_bitCounts;
+    uint64_t m_numberOfPairs;
+    // Reused for every block
+    std::array<std::vector<int32_t>, maximumOrder> m_residuals;
+    std::vector<int32_t> m_previousValues;
+    std::vector<int32_t> m_currentValues;
+    std::vector<double> m_residualEntropy;
+};
+
+#endif // PREDICTIONENTROPY_H
@@ -43,6 +43,8 @@ public:
     void setReturnTimeValue(double value);
     void updateMeter(const std::vector<int32_t> & signalValues);
     void updateBitdepth(int bitdepth);
+    // RMS of the last block in dB (without return time)
+    double getBlockRms() const;
 
 private:
     double calculateRootMeanSquare(const std::vector<int32_t> & signalValues);
@@ -55,6 +57,7 @@ private:
     uint32_t m_referenceValue;
     int32_t m_i;
     double m_maximumDynamicRange;
+    double m_blockRms;
 };
 
 #endif // RMSMETER_H
@@ -21,15 +21,18 @@
 #ifndef RINGBUFFER_H
 #define RINGBUFFER_H
 
-#include <mutex>
+#include <atomic>
+#include <thread>
 #include <vector>
 
+#include "BlockQueue.hpp"
+
 class RingBufferReceiver
 {
 public:
     RingBufferReceiver() {}
 
-    virtual void receiveSamples(const std::vector<int32_t> & samples) = 0;
+    virtual void receiveSamples(const AudioBlock & block) = 0;
 };
 
 class RingBuffer
@@ -37,16 +40,55 @@ class RingBuffer
 
 public:
     RingBuffer(int capacity, RingBufferReceiver *receiver = nullptr);
-    void clearAndResize(int capacity);
-    // Insert sample at position
-    void insertItem(int32_t item, uint32_t position);
+    ~RingBuffer();
+    // Set the block size and clear all queued blocks, the sample index starts at 0 again.
+    // "pairChannel" allocates the samples of a second channel in every block
+    void clearAndResize(int capacity, bool pairChannel = false);
+    // Used for the ADC time of the blocks if setInputTime() isn't called
+    void setSampleRate(uint32_t sampleRate);
+    // Producer: ADC time of the next sample which is written (e.g. from PaStreamCallbackTimeInfo)
+    void setInputTime(double time);
+    // Insert a single sample
+    void insertItem(int32_t item);
+    // Get a pointer into the current block, "available" is set to the number of samples which can be written
+    int32_t * getWritePointer(size_t & available);
+    // Pointer to the same position in the samples of the pair channel, nullptr if no pair channel is allocated.
+    // Must be called after getWritePointer()
+    int32_t * getPairWritePointer();
+    // Commit samples written to the pointer returned by getWritePointer(), a full block is queued for the receiver
+    void commitItems(size_t count);
+    // Start the thread which passes the queued blocks to the receiver
+    void startReceiverThread();
+    // Stop the receiver thread, blocks which are still queued are discarded
+    void stopReceiverThread();
+    // Pass the oldest queued block to the receiver, return "false" if no block is queued.
+    // Used instead of the receiver thread, e.g. by an AnalysisPool
+    bool processBlock();
+    // Notify "condition" for every queued block, nullptr disables it
+    void setConsumerCondition(std::condition_variable *condition);
+    const BlockQueue & getQueue() const;
+
+private:
+    void runReceiverThread();
 
 private:
-    // Buffer to which is written by the callback function
-    std::vector<int32_t> m_inBuffer;
-    // Mutex to lock while copying from inBuffer to outBuffer
-    std::mutex m_mutex;
+    // Queue between the callback function (producer) and the receiver thread (consumer)
+    BlockQueue m_queue;
+    // Block which is currently written by the callback function
+    AudioBlock *m_writeBlock;
+    // Written instead if the queue is full
+    AudioBlock m_discardBlock;
+    size_t m_writePosition;
+    size_t m_blockSize;
+    // Producer: index of the next sample in the stream, including samples of dropped blocks
+    uint64_t m_sampleIndex;
+    // Producer: last input time and the sample index it belongs to
+    double m_inputTime;
+    uint64_t m_inputTimeIndex;
+    double m_samplePeriod;
     RingBufferReceiver *m_receiverObject;
+    std::thread m_receiverThread;
+    std::atomic<bool> m_receiverRunning;
 };
 
 #endif // RINGBUFFER_H
@@ -0,0 +1,103 @@
+/*
+ * RunningMoments: DC offset, AC RMS, skewness and kurtosis in one pass
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RUNNINGMOMENTS_H
+#define RUNNINGMOMENTS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class RunningMomentsListener;
+
+// Mean and the central moments 2 - 4 of the samples over the entropy window and since the start.
+// Every block is reduced to its own moments, which are merged into the window and the total with the pairwise update of
+// Chan et al. and Pebay. No sum of powers of the raw samples is kept, so there is no cancellation at large DC offsets
+// or long runs, and states from other chunks or threads can be merged the same way.
+class RunningMoments
+{
+public:
+    // Mergeable state, the moments are the sums of the powers of the deviations from the mean
+    struct State
+    {
+        uint64_t m_count;
+        double m_mean;
+        double m_m2;
+        double m_m3;
+        double m_m4;
+
+        State();
+        void clear();
+        void merge(const State & other);
+        double getVariance() const;
+        double getSkewness() const;
+        // 3 for Gaussian noise, 1.5 for a sine, 1.8 for uniform noise
+        double getKurtosis() const;
+    };
+
+    struct Result
+    {
+        uint64_t m_numberOfSamples;
+        // In LSB and relative to full scale (-999 if zero)
+        double m_dcOffset;
+        double m_dcOffsetDb;
+        // RMS without the DC offset
+        double m_acRms;
+        double m_acRmsDb;
+        double m_skewness;
+        double m_kurtosis;
+    };
+
+    RunningMoments(RunningMomentsListener *listener = nullptr);
+
+    // Same window as Entropy: the moments are reported after every "numberOfBlocks" blocks
+    void addSamples(const std::vector<int32_t> & signalValues);
+    void setNumberOfBlocks(int numberOfBlocks);
+    // Only sets the full scale of the dB values
+    void setBitDepth(int bitDepth);
+    // Clears the window
+    void clear();
+    // Clears the window and the total
+    void reset();
+
+    const State & getTotal() const;
+    Result getResult(const State & state) const;
+
+    // State of one chunk of samples, can be called from any thread
+    static State calculateState(const int32_t *samples, size_t numberOfSamples);
+
+private:
+    RunningMomentsListener *m_runningMomentsListener;
+    double m_referenceValue;
+    int m_numberOfBlocks;
+    int m_blockCounter;
+    State m_window;
+    State m_total;
+};
+
+class RunningMomentsListener
+{
+public:
+    RunningMomentsListener() {}
+
+    virtual void receiveRunningMoments(const RunningMoments::Result & window, const RunningMoments::Result & total) = 0;
+};
+
+#endif // RUNNINGMOMENTS_H
@@ -0,0 +1,113 @@
+/*
+ * SampleSource: Base class of everything which delivers audio samples
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SAMPLESOURCE_H
+#define SAMPLESOURCE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "DriftEstimator.hpp"
+#include "RingBuffer.hpp"
+
+class AnalysisPool;
+class CaptureSpool;
+
+class SampleSourceListener
+{
+public:
+    SampleSourceListener() {}
+
+    // Called from the receiver thread for every block, with its sample index and timestamps
+    virtual void receiveSourceSamples(const AudioBlock & block) = 0;
+};
+
+class SampleSource
+    : public RingBufferReceiver
+{
+public:
+    SampleSource(SampleSourceListener *listener = nullptr);
+    virtual ~SampleSource();
+
+    // Start delivering blocks of "blockSize" samples to the listener, return "true" if everything is okay
+    virtual bool open(int bitDepth, uint32_t sampleRate, uint32_t blockSize) = 0;
+    virtual void close() = 0;
+    // Short description for log output
+    virtual std::string getName() const = 0;
+    // Indicates whether the source has delivered all of its samples (e.g. end of file)
+    bool isFinished() const;
+
+    void setListener(SampleSourceListener *listener);
+    // Record all blocks while the source is open, nullptr disables recording
+    void setCaptureSpool(CaptureSpool *spool);
+    // Analyze the blocks on the workers of "pool" instead of an own receiver thread, applied by the next open()
+    void setAnalysisPool(AnalysisPool *pool);
+    // Second channel which is delivered in AudioBlock::m_pairSamples (1 ... number of channels, 0 disables it),
+    // applied by the next open()
+    void setPairChannel(int pairChannel);
+    int getPairChannel() const;
+    int getBitDepth() const;
+    uint32_t getSampleRate() const;
+    uint32_t getBlockSize() const;
+    // Queue between the source and the listener
+    const BlockQueue & getQueue() const;
+    // Sample rate measured with the system clock while the source is open
+    const DriftEstimator & getDriftEstimator() const;
+
+    virtual void receiveSamples(const AudioBlock & block) override;
+
+protected:
+    // Clear the ring buffer and start passing blocks to the listener
+    void startReceiving(int bitDepth, uint32_t sampleRate, uint32_t blockSize);
+    void stopReceiving();
+    // Start a thread which writes the samples of generateSamples() to the ring buffer,
+    // in real time or as fast as the listener can process them
+    void startGeneratorThread(bool realTime);
+    void stopGeneratorThread();
+    // Write up to "count" samples, return the number of samples written (0 if there are no more samples)
+    virtual size_t generateSamples(int32_t *samples, size_t count);
+
+private:
+    void runGeneratorThread(bool realTime);
+
+protected:
+    SampleSourceListener *m_sourceListener;
+    CaptureSpool *m_captureSpool;
+    AnalysisPool *m_analysisPool;
+    int m_pairChannel;
+    std::shared_ptr<RingBuffer> m_buffer;
+    int m_bitDepth;
+    uint32_t m_sampleRate;
+    uint32_t m_blockSize;
+
+private:
+    DriftEstimator m_driftEstimator;
+    // Pool which receives the blocks while the source is open
+    AnalysisPool *m_activeAnalysisPool;
+    std::thread m_generatorThread;
+    std::atomic<bool> m_generatorRunning;
+    std::atomic<bool> m_finished;
+};
+
+#endif // SAMPLESOURCE_H
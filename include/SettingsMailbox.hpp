@@ -0,0 +1,65 @@
+/*
+ * SettingsMailbox: Passes settings from the UI thread to the analysis thread
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SETTINGSMAILBOX_H
+#define SETTINGSMAILBOX_H
+
+#include <atomic>
+#include <mutex>
+
+// The consumer only takes the mutex if new settings have been published, so checking once per block is cheap.
+// A consumer always gets a complete set of settings, never a mix of old and new values.
+template <typename Settings>
+class SettingsMailbox
+{
+public:
+    SettingsMailbox()
+        : m_changed(false)
+    {
+    }
+
+    // Producer: replace the settings, older settings which haven't been fetched are discarded
+    void publish(const Settings & settings)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_settings = settings;
+        m_changed.store(true, std::memory_order_release);
+    }
+
+    // Consumer: copy the settings if they have changed since the last call, return "false" otherwise
+    bool fetch(Settings & settings)
+    {
+        if(!m_changed.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        settings = m_settings;
+        m_changed.store(false, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    std::mutex m_mutex;
+    Settings m_settings;
+    std::atomic<bool> m_changed;
+};
+
+#endif // SETTINGSMAILBOX_H
@@ -0,0 +1,74 @@
+/*
+ * Spectrogram: Short-time spectra of the incoming samples as columns of display rows
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPECTROGRAM_H
+#define SPECTROGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "Fft.hpp"
+
+// A Hann windowed FFT of "fftSize" samples every "hopSize" samples (50 % overlap). Every spectrum is reduced to
+// "numberOfRows" levels (maximum of the bins of a row, 0 ... 255 over the dynamic range of the bit depth) and
+// stored in a ring of columns, which the display reads at its own rate.
+class Spectrogram
+{
+public:
+    static const size_t fftSize = 4096;
+    static const size_t hopSize = 2048;
+    static const int numberOfRows = 256;
+    static const size_t numberOfColumns = 1024;
+
+    Spectrogram();
+
+    // Called from the analysis thread
+    void addSamples(const std::vector<int32_t> & signalValues);
+    // Clears the samples and the columns, sets the full scale and the lower end of the level range
+    void setBitDepth(int bitDepth);
+    void clear();
+
+    // Called from any thread: append the columns after "readCount" to "columns" (row 0 is 0 Hz, "numberOfRows" bytes
+    // per column) and set "readCount" to the number of columns written. Columns which were overwritten are skipped.
+    void readColumns(uint64_t & readCount, std::vector<uint8_t> & columns) const;
+
+private:
+    void addColumn();
+
+private:
+    Fft m_fft;
+    std::vector<double> m_window;
+    // The last fftSize samples, the oldest first
+    std::vector<double> m_samples;
+    size_t m_fill;
+    std::vector<double> m_windowed;
+    std::vector<double> m_power;
+    // Power of a full scale sine in its bin, the top of the level range
+    double m_fullScalePower;
+    double m_dynamicRange;
+
+    mutable std::mutex m_columnMutex;
+    std::vector<uint8_t> m_columns;
+    uint64_t m_columnCount;
+};
+
+#endif // SPECTROGRAM_H
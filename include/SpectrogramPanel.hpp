@@ -0,0 +1,74 @@
+/*
+ * SpectrogramPanel: Window with the scrolling spectrogram of the input channel
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPECTROGRAMPANEL_H
+#define SPECTROGRAMPANEL_H
+
+#include <QImage>
+#include <QRgb>
+#include <QWidget>
+
+#include <cstdint>
+#include <vector>
+
+class QPushButton;
+class QTimer;
+class Spectrogram;
+
+// The columns are written into a circular image, the oldest column is at "m_writeColumn". Painting copies the image
+// in two parts, nothing is drawn again from the history.
+class SpectrogramPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    static const int imageWidth = 512;
+
+    // "spectrogram" is filled by the analysis thread and read with every refresh
+    SpectrogramPanel(const Spectrogram *spectrogram, QWidget *parent = 0);
+
+    // Scale of the frequency and the time axis, set before the stream is started
+    void setSampleRate(uint32_t sampleRate);
+    // Clears the image
+    void clear();
+
+private:
+    const Spectrogram *m_spectrogram;
+    // Placeholder for the area in which the spectrogram is painted
+    QWidget *m_spectrogramArea;
+    QPushButton *m_buttonClose;
+    QTimer *m_refreshTimer;
+    uint32_t m_sampleRate;
+    QImage m_image;
+    int m_writeColumn;
+    uint64_t m_readCount;
+    std::vector<uint8_t> m_columns;
+    // Color of every level
+    std::vector<QRgb> m_palette;
+
+private slots:
+    void refresh();
+
+protected:
+    // Enable background-color painting of this widget and paint the spectrogram
+    virtual void paintEvent(QPaintEvent *) override;
+};
+
+#endif // SPECTROGRAMPANEL_H
@@ -0,0 +1,63 @@
+/*
+ * StatisticsPanel: Window with the timing statistics of the running stream
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STATISTICSPANEL_H
+#define STATISTICSPANEL_H
+
+#include <QWidget>
+
+#include "StreamStatistics.hpp"
+
+class QLabel;
+class QPainter;
+class QPushButton;
+
+class StatisticsPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    StatisticsPanel(QWidget *parent = 0);
+
+    void updateStatistics(const StreamStatistics::Snapshot & statistics);
+
+private:
+    // Draw a histogram with logarithmic time bins into "area"
+    void drawHistogram(QPainter & painter, const QRect & area, const QString & title,
+                       const std::array<uint64_t, StreamStatistics::numberOfBins> & histogram);
+
+private:
+    QLabel *m_labelCallbacks;
+    QLabel *m_labelXruns;
+    QLabel *m_labelDuration;
+    QLabel *m_labelJitter;
+    QLabel *m_labelCpuLoad;
+    QLabel *m_labelQueue;
+    // Placeholder for the area in which the histograms are painted
+    QWidget *m_histogramArea;
+    QPushButton *m_buttonClose;
+    StreamStatistics::Snapshot m_statistics;
+
+protected:
+    // Enable background-color painting of this widget and paint the histograms
+    virtual void paintEvent(QPaintEvent *) override;
+};
+
+#endif // STATISTICSPANEL_H
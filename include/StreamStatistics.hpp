@@ -0,0 +1,100 @@
+/*
+ * StreamStatistics: Timing and overflow counters of the audio thread
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STREAMSTATISTICS_H
+#define STREAMSTATISTICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Written by a single thread (audio callback or reader thread) without locks,
+// read by any other thread
+class StreamStatistics
+{
+public:
+    // Bin 0: < 2 us, bin i: 2^i ... 2^(i+1) us, the last bin also counts all larger values
+    static const int numberOfBins = 20;
+
+    struct Snapshot
+    {
+        uint64_t m_numberOfCallbacks;
+        uint64_t m_numberOfFrames;
+        uint64_t m_inputOverflows;
+        uint64_t m_inputUnderflows;
+        // Time spent in the callback in seconds
+        double m_minimumDuration;
+        double m_meanDuration;
+        double m_maximumDuration;
+        // Deviation of the time between two callbacks from the duration of the previous buffer in seconds
+        double m_meanJitter;
+        double m_maximumJitter;
+        std::array<uint64_t, numberOfBins> m_durationHistogram;
+        std::array<uint64_t, numberOfBins> m_jitterHistogram;
+        // Filled in by the owner of the stream
+        double m_cpuLoad;
+        size_t m_queuedBlocks;
+        size_t m_maximumQueuedBlocks;
+        size_t m_numberOfBlocks;
+        uint64_t m_droppedBlocks;
+    };
+
+    StreamStatistics();
+
+    // Clear all values, must not be called while the stream is running
+    void reset(uint32_t sampleRate);
+    // Called by the writing thread after every callback or read
+    void addCallback(unsigned long frameCount, bool inputOverflow, bool inputUnderflow,
+                     std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end,
+                     size_t queuedBlocks);
+    // Values may be from different callbacks if the stream is running
+    Snapshot getSnapshot() const;
+
+    // Lower bound of a histogram bin in seconds
+    static double getBinLowerBound(int bin);
+
+private:
+    static int getBin(uint64_t nanoseconds);
+    // Only one thread writes, so a load and a store are enough (no read-modify-write)
+    static void increment(std::atomic<uint64_t> & counter, uint64_t value = 1);
+
+private:
+    uint32_t m_sampleRate;
+    std::atomic<uint64_t> m_numberOfCallbacks;
+    std::atomic<uint64_t> m_numberOfFrames;
+    std::atomic<uint64_t> m_inputOverflows;
+    std::atomic<uint64_t> m_inputUnderflows;
+    // Nanoseconds
+    std::atomic<uint64_t> m_minimumDuration;
+    std::atomic<uint64_t> m_maximumDuration;
+    std::atomic<uint64_t> m_totalDuration;
+    std::atomic<uint64_t> m_maximumJitter;
+    std::atomic<uint64_t> m_totalJitter;
+    std::atomic<uint64_t> m_numberOfIntervals;
+    std::array<std::atomic<uint64_t>, numberOfBins> m_durationHistogram;
+    std::array<std::atomic<uint64_t>, numberOfBins> m_jitterHistogram;
+    std::atomic<uint64_t> m_maximumQueuedBlocks;
+    // Only accessed by the writing thread
+    std::chrono::steady_clock::time_point m_lastStart;
+    unsigned long m_lastFrameCount;
+};
+
+#endif // STREAMSTATISTICS_H
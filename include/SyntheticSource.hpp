@@ -0,0 +1,93 @@
+/*
+ * SyntheticSource: Deterministic test signals without audio hardware
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHETICSOURCE_H
+#define SYNTHETICSOURCE_H
+
+#include <random>
+
+#include "SampleSource.hpp"
+
+class SyntheticSource
+    : public SampleSource
+{
+public:
+    enum class Pattern
+    {
+        Sine,
+        Noise,
+        Silence,
+        // Noise with the lower bits cleared (see setEffectiveBits())
+        TruncatedBitDepth,
+        // Noise with one bit stuck at 0 or 1 (see setStuckBit())
+        StuckBit,
+        // Sawtooth which steps through every code from the negative to the positive peak, e.g. for missing code tests
+        Ramp
+    };
+
+    SyntheticSource(SampleSourceListener *listener = nullptr);
+    virtual ~SyntheticSource();
+
+    void setPattern(Pattern pattern);
+    // Frequency of the sine in Hz
+    void setFrequency(double frequency);
+    // Amplitude in dBFS
+    void setAmplitude(double amplitude);
+    // Number of used bits for Pattern::TruncatedBitDepth
+    void setEffectiveBits(int effectiveBits);
+    // Bit (0 = LSB) and its value for Pattern::StuckBit
+    void setStuckBit(int bit, bool value);
+    // Seed of the noise generator, the same seed always produces the same samples
+    void setSeed(uint32_t seed);
+    // Deliver samples at the sample rate or as fast as the listener can process them
+    void setRealTime(bool realTime);
+
+    virtual bool open(int bitDepth, uint32_t sampleRate, uint32_t blockSize) override;
+    virtual void close() override;
+    virtual std::string getName() const override;
+
+    // Convert a pattern name ("sine", "noise", ...) to a pattern, return "false" if the name is unknown
+    static bool getPatternFromName(const std::string & name, Pattern & pattern);
+
+protected:
+    virtual size_t generateSamples(int32_t *samples, size_t count) override;
+
+private:
+    int32_t getNoiseSample();
+    // Sign-extend a value with m_bitDepth bits
+    int32_t toSigned(uint32_t value) const;
+
+private:
+    Pattern m_pattern;
+    double m_frequency;
+    double m_amplitude;
+    int m_effectiveBits;
+    int m_stuckBit;
+    bool m_stuckBitValue;
+    uint32_t m_seed;
+    bool m_realTime;
+    // Generator state
+    double m_phase;
+    double m_peakValue;
+    int64_t m_rampValue;
+    std::mt19937 m_random;
+};
+
+#endif // SYNTHETICSOURCE_H
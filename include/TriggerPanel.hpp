@@ -0,0 +1,71 @@
+/*
+ * TriggerPanel: Window with the conditions of the event trigger
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRIGGERPANEL_H
+#define TRIGGERPANEL_H
+
+#include <QWidget>
+
+#include "EventTrigger.hpp"
+
+class QCheckBox;
+class QDoubleSpinBox;
+class QLabel;
+class QPushButton;
+
+class TriggerPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    TriggerPanel(QWidget *parent = 0);
+
+    void setSettings(const EventTrigger::Settings & settings);
+    // The file name prefix is left unchanged
+    EventTrigger::Settings getSettings(const EventTrigger::Settings & settings) const;
+    void updateEvents(quint64 numberOfEvents, const QString & fileName);
+    // Pre- and post-trigger time can only be changed while the stream is stopped
+    void disableUI(bool disable);
+
+private:
+    QCheckBox *m_checkBoxClip;
+    QCheckBox *m_checkBoxEntropy;
+    QDoubleSpinBox *m_spinBoxEntropy;
+    QCheckBox *m_checkBoxRms;
+    QDoubleSpinBox *m_spinBoxRms;
+    QCheckBox *m_checkBoxBits;
+    QDoubleSpinBox *m_spinBoxPreTrigger;
+    QDoubleSpinBox *m_spinBoxPostTrigger;
+    QLabel *m_labelEvents;
+    QLabel *m_labelLastEvent;
+    QPushButton *m_buttonClose;
+
+private slots:
+    void emitSettingsChanged();
+
+signals:
+    void signalSettingsChanged();
+
+protected:
+    // Enable background-color painting of this widget
+    virtual void paintEvent(QPaintEvent *) override;
+};
+
+#endif // TRIGGERPANEL_H
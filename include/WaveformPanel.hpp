@@ -0,0 +1,65 @@
+/*
+ * WaveformPanel: Window with the scrolling min/max envelope of the input channel
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WAVEFORMPANEL_H
+#define WAVEFORMPANEL_H
+
+#include <QWidget>
+
+#include <cstdint>
+#include <vector>
+
+class QComboBox;
+class QPushButton;
+class QTimer;
+class WaveformPyramid;
+
+class WaveformPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    // "pyramid" is filled by the analysis thread and read with every refresh
+    WaveformPanel(const WaveformPyramid *pyramid, QWidget *parent = 0);
+
+    // Scale of the amplitude and the time axis, set before the stream is started
+    void setFormat(int bitDepth, uint32_t sampleRate);
+
+private:
+    const WaveformPyramid *m_pyramid;
+    QComboBox *m_boxTimeSpan;
+    // Placeholder for the area in which the waveform is painted
+    QWidget *m_waveformArea;
+    QPushButton *m_buttonClose;
+    QTimer *m_refreshTimer;
+    int m_bitDepth;
+    uint32_t m_sampleRate;
+    std::vector<int32_t> m_minimum;
+    std::vector<int32_t> m_maximum;
+
+private slots:
+    void refresh();
+
+protected:
+    // Enable background-color painting of this widget and paint the waveform
+    virtual void paintEvent(QPaintEvent *) override;
+};
+
+#endif // WAVEFORMPANEL_H
@@ -0,0 +1,78 @@
+/*
+ * WaveformPyramid: Min/max decimation pyramid of the incoming samples
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WAVEFORMPYRAMID_H
+#define WAVEFORMPYRAMID_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Level 0 holds the minimum and maximum of every "baseDecimation" samples, every further level combines "levelFactor"
+// entries of the level below. Each level is a ring of "levelCapacity" entries, so the newest part of the stream is
+// available at fine resolution and the whole run (about 27 h at 44.1 kHz) at coarse resolution.
+// A view of any length is read from the level with 1 - 4 entries per pixel, i.e. in O(pixels).
+class WaveformPyramid
+{
+public:
+    static const int baseDecimation = 64;
+    static const int levelFactor = 4;
+    static const int numberOfLevels = 8;
+    static const size_t levelCapacity = 4096;
+
+    WaveformPyramid();
+
+    // Called from the analysis thread
+    void addSamples(const std::vector<int32_t> & signalValues);
+    void clear();
+
+    // Called from any thread: minimum and maximum of "numberOfPixels" columns which cover the last "numberOfSamples"
+    // samples, the newest on the right. Columns without samples (before the start) have a minimum above the maximum.
+    void getEnvelope(uint64_t numberOfSamples, int numberOfPixels, std::vector<int32_t> & minimum, std::vector<int32_t> & maximum) const;
+    // Number of samples which the coarsest level can hold
+    static uint64_t getMaximumNumberOfSamples();
+
+private:
+    struct Entry
+    {
+        int32_t m_minimum;
+        int32_t m_maximum;
+    };
+
+    struct Level
+    {
+        std::vector<Entry> m_entries;
+        // Number of entries written since clear(), the newest one is at (m_count-1) % levelCapacity
+        uint64_t m_count;
+        // Entry which is being combined from the level below (or from the samples for level 0)
+        Entry m_pending;
+        int m_pendingCount;
+    };
+
+    // Add a complete entry to "level" and combine it into the next level
+    void pushEntry(int level, const Entry & entry);
+
+private:
+    mutable std::mutex m_mutex;
+    std::vector<Level> m_levels;
+};
+
+#endif // WAVEFORMPYRAMID_H
@@ -0,0 +1,82 @@
+/*
+ * AmplitudeHistogram: Amplitude distribution with a fixed number of display bins
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AmplitudeHistogram.hpp"
+
+#include <algorithm>
+
+AmplitudeHistogram::AmplitudeHistogram(AmplitudeHistogramListener *listener)
+    : m_amplitudeHistogramListener(listener)
+    , m_bitDepth(16)
+    , m_shift(0)
+    , m_mask(0)
+    , m_signBit(0)
+    , m_numberOfBlocks(50)
+    , m_blockCounter(0)
+{
+    setBitDepth(m_bitDepth);
+}
+
+void AmplitudeHistogram::addSamples(const std::vector<int32_t> & signalValues)
+{
+    if(!m_amplitudeHistogramListener)
+    {
+        return;
+    }
+
+    // Offset binary, so the bins are in the order of the amplitude
+    for(const auto& sample : signalValues)
+    {
+        ++m_counts[((static_cast<uint32_t>(sample) ^ m_signBit) & m_mask) >> m_shift];
+    }
+    ++m_blockCounter;
+
+    if(m_blockCounter >= m_numberOfBlocks)
+    {
+        m_amplitudeHistogramListener->receiveAmplitudeHistogram(m_counts, getCodesPerBin());
+        clear();
+    }
+}
+
+void AmplitudeHistogram::setNumberOfBlocks(int numberOfBlocks)
+{
+    m_numberOfBlocks = numberOfBlocks;
+}
+
+void AmplitudeHistogram::setBitDepth(int bitDepth)
+{
+    m_bitDepth = bitDepth;
+    m_shift = std::max(0, bitDepth - maximumBinBits);
+    m_mask = static_cast<uint32_t>((1ULL << bitDepth) - 1);
+    m_signBit = 1u << (bitDepth - 1);
+    m_counts.assign(static_cast<size_t>(1) << (bitDepth - m_shift), 0);
+    clear();
+}
+
+void AmplitudeHistogram::clear()
+{
+    m_blockCounter = 0;
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+}
+
+int AmplitudeHistogram::getCodesPerBin() const
+{
+    return 1 << m_shift;
+}
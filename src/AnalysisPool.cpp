@@ -0,0 +1,135 @@
+/*
+ * AnalysisPool: Worker threads which analyze the blocks of several sources
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AnalysisPool.hpp"
+#include "RingBuffer.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+AnalysisPool::AnalysisPool(int numberOfThreads)
+    : m_nextEntry(0)
+    , m_running(true)
+{
+    if(numberOfThreads < 1)
+    {
+        // hardware_concurrency() may return 0 if it is unknown
+        numberOfThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    for(int i=0; i<numberOfThreads; i++)
+    {
+        m_workerThreads.push_back(std::thread(&AnalysisPool::runWorkerThread, this));
+    }
+}
+
+AnalysisPool::~AnalysisPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+    }
+    m_condition.notify_all();
+    for(auto& thread : m_workerThreads)
+    {
+        thread.join();
+    }
+    // Buffers which haven't been removed mustn't notify the destroyed condition
+    for(auto& entry : m_entries)
+    {
+        entry->m_buffer->setConsumerCondition(nullptr);
+    }
+}
+
+void AnalysisPool::addBuffer(RingBuffer *buffer)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for(const auto& entry : m_entries)
+    {
+        if(entry->m_buffer == buffer)
+        {
+            return;
+        }
+    }
+    m_entries.push_back(std::unique_ptr<Entry>(new Entry{buffer, false}));
+    buffer->setConsumerCondition(&m_condition);
+    m_condition.notify_all();
+}
+
+void AnalysisPool::removeBuffer(RingBuffer *buffer)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto it = std::find_if(m_entries.begin(), m_entries.end(), [buffer](const std::unique_ptr<Entry> & entry) { return entry->m_buffer == buffer; });
+    if(it == m_entries.end())
+    {
+        return;
+    }
+    buffer->setConsumerCondition(nullptr);
+    Entry *entry = it->get();
+    m_releaseCondition.wait(lock, [entry] { return !entry->m_busy; });
+    // The mutex was released while waiting, so another buffer may have been added (and the vector reallocated)
+    it = std::find_if(m_entries.begin(), m_entries.end(), [entry](const std::unique_ptr<Entry> & other) { return other.get() == entry; });
+    if(it != m_entries.end())
+    {
+        m_entries.erase(it);
+    }
+}
+
+int AnalysisPool::getNumberOfThreads() const
+{
+    return static_cast<int>(m_workerThreads.size());
+}
+
+AnalysisPool::Entry * AnalysisPool::claimEntry()
+{
+    for(size_t i=0; i<m_entries.size(); i++)
+    {
+        const size_t index = (m_nextEntry + i) % m_entries.size();
+        Entry *entry = m_entries[index].get();
+        if(!entry->m_busy && entry->m_buffer->getQueue().getNumberOfQueuedBlocks() > 0)
+        {
+            entry->m_busy = true;
+            m_nextEntry = index + 1;
+            return entry;
+        }
+    }
+    return nullptr;
+}
+
+void AnalysisPool::runWorkerThread()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while(m_running)
+    {
+        Entry *entry = claimEntry();
+        if(!entry)
+        {
+            // The queues notify without the mutex, so a wakeup can be missed
+            m_condition.wait_for(lock, std::chrono::milliseconds(20));
+            continue;
+        }
+
+        lock.unlock();
+        entry->m_buffer->processBlock();
+        lock.lock();
+
+        entry->m_busy = false;
+        m_releaseCondition.notify_all();
+    }
+}
@@ -0,0 +1,147 @@
+/*
+ * BitDepthEstimator: Effective bit depth from trailing zeros and bit toggle rates
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BitDepthEstimator.hpp"
+
+#include <cmath>
+
+// A bit toggles like noise if it differs from the previous sample in about half of the samples
+const double noiseToggleTolerance = 0.1;
+// Below this toggle rate the LSB changes much less than noise would
+const double truncatedToggleRate = 0.25;
+// Samples with nonzero low bits which are ignored when counting the zero LSBs (e.g. single glitches)
+const double paddingTolerance = 1.0e-6;
+
+BitDepthEstimator::BitDepthEstimator(BitDepthEstimatorListener *listener)
+    : m_bitDepthEstimatorListener(listener)
+    , m_reportInterval(50)
+    , m_blockCounter(0)
+{
+}
+
+void BitDepthEstimator::setBitDepth(int bitDepth)
+{
+    m_statistics.setBitDepth(bitDepth);
+    m_blockCounter = 0;
+}
+
+void BitDepthEstimator::setReportInterval(int numberOfBlocks)
+{
+    m_reportInterval = numberOfBlocks;
+}
+
+void BitDepthEstimator::addSamples(const std::vector<int32_t> & signalValues)
+{
+    m_statistics.addSamples(signalValues);
+
+    if(m_bitDepthEstimatorListener && ++m_blockCounter >= m_reportInterval)
+    {
+        const Estimate estimate = getEstimate();
+        m_bitDepthEstimatorListener->receiveBitDepthEstimate(estimate.m_bitDepth, estimate.m_effectiveBitDepth, estimate.m_noiseBits,
+                                                             getVerdictName(estimate.m_verdict));
+        m_blockCounter = 0;
+    }
+}
+
+void BitDepthEstimator::clear()
+{
+    m_statistics.clear();
+    m_blockCounter = 0;
+}
+
+BitDepthEstimator::Estimate BitDepthEstimator::getEstimate() const
+{
+    const int bitDepth = m_statistics.getBitDepth();
+    const uint64_t numberOfSamples = m_statistics.getNumberOfSamples();
+    Estimate estimate;
+    estimate.m_bitDepth = bitDepth;
+    estimate.m_effectiveBitDepth = 0;
+    estimate.m_paddedBits = 0;
+    estimate.m_noiseBits = 0;
+    estimate.m_lsbToggleRate = 0.0;
+    estimate.m_verdict = Verdict::Unknown;
+    estimate.m_numberOfSamples = numberOfSamples;
+    // Silence says nothing about the bit depth
+    uint64_t nonzeroSamples = 0;
+    for(int bit=0; bit<bitDepth; bit++)
+    {
+        nonzeroSamples += m_statistics.getTrailingZeroCount(bit);
+    }
+    if(numberOfSamples < 2 || nonzeroSamples == 0)
+    {
+        return estimate;
+    }
+
+    // Zero LSBs: all (but very few) nonzero samples have at least that many trailing zeros
+    const uint64_t tolerance = static_cast<uint64_t>(paddingTolerance*numberOfSamples);
+    uint64_t samplesBelow = 0;
+    while(estimate.m_paddedBits < bitDepth-1 && samplesBelow + m_statistics.getTrailingZeroCount(estimate.m_paddedBits) <= tolerance)
+    {
+        samplesBelow += m_statistics.getTrailingZeroCount(estimate.m_paddedBits);
+        ++estimate.m_paddedBits;
+    }
+    estimate.m_effectiveBitDepth = bitDepth - estimate.m_paddedBits;
+    estimate.m_lsbToggleRate = m_statistics.getToggleRate(estimate.m_paddedBits);
+
+    for(int bit=estimate.m_paddedBits; bit<bitDepth; bit++)
+    {
+        if(std::abs(m_statistics.getToggleRate(bit) - 0.5) > noiseToggleTolerance || std::abs(m_statistics.getSetRate(bit) - 0.5) > noiseToggleTolerance)
+        {
+            break;
+        }
+        ++estimate.m_noiseBits;
+    }
+
+    if(estimate.m_paddedBits > 0)
+    {
+        estimate.m_verdict = (estimate.m_lsbToggleRate < truncatedToggleRate) ? Verdict::Truncated : Verdict::Padded;
+    }
+    else if(estimate.m_noiseBits > 0 && estimate.m_noiseBits <= bitDepth/4)
+    {
+        estimate.m_verdict = Verdict::Dithered;
+    }
+    else
+    {
+        estimate.m_verdict = Verdict::Full;
+    }
+    return estimate;
+}
+
+const BitStatistics & BitDepthEstimator::getStatistics() const
+{
+    return m_statistics;
+}
+
+const char *BitDepthEstimator::getVerdictName(Verdict verdict)
+{
+    switch(verdict)
+    {
+        case Verdict::Full:
+            return "full";
+        case Verdict::Padded:
+            return "padded";
+        case Verdict::Dithered:
+            return "dithered";
+        case Verdict::Truncated:
+            return "truncated";
+        default:
+            return "unknown";
+    }
+}
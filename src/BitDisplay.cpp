@@ -21,12 +21,15 @@
 #include "BitDisplay.hpp"
 #include <QLayout>
 #include <QGraphicsEllipseItem>
+#include <QGraphicsRectItem>
 #include <QLabel>
 #include <QComboBox>
 #include <QSpinBox>
 #include <QPushButton>
 #include <QMouseEvent>
 
+#include <algorithm>
+
 const QColor colorBitSet(255,180,0);
 const QColor colorBitNotSet(0,100,200);
 const QColor colorBackground(80,80,80);
@@ -36,6 +39,7 @@ const QColor colorBorderDark(30,30,30);
 const QColor colorFont(255,255,255);
 const QColor colorFontDarker(220,220,220);
 const QColor colorBitBorder(255,255,255);
+const QColor colorStuckBit(255,0,0);
 
 const quint32 maxValue8bit = 255;
 const quint32 maxValue16bit = 65535;
@@ -44,6 +48,15 @@ const quint32 flipMsb8bit = 128;
 const quint32 flipMsb16bit = 32768;
 const quint32 flipMsb24bit = 8388608;
 
+// Color between "colorBitNotSet" (0.0) and "colorBitSet" (1.0)
+static QColor getHeatmapColor(double rate)
+{
+    rate = std::max(0.0, std::min(1.0, rate));
+    return QColor(static_cast<int>(colorBitNotSet.red() + rate*(colorBitSet.red()-colorBitNotSet.red())),
+                  static_cast<int>(colorBitNotSet.green() + rate*(colorBitSet.green()-colorBitNotSet.green())),
+                  static_cast<int>(colorBitNotSet.blue() + rate*(colorBitSet.blue()-colorBitNotSet.blue())));
+}
+
 BitDisplay::BitDisplay(QWidget *parent)
     : QWidget(parent)
     , m_holdBits(false)
@@ -82,6 +95,16 @@ BitDisplay::BitDisplay(QWidget *parent)
         }
         m_bitCircles.append(circle);
         m_scene.addItem(m_bitCircles[i]);
+
+        // Upper row: set rate, lower row: toggle rate
+        QGraphicsRectItem *setRateCell = new QGraphicsRectItem(0,0,11,5);
+        setRateCell->setPos(circle->pos() + QPointF(0,15));
+        m_setRateCells.append(setRateCell);
+        m_scene.addItem(setRateCell);
+        QGraphicsRectItem *toggleRateCell = new QGraphicsRectItem(0,0,11,5);
+        toggleRateCell->setPos(circle->pos() + QPointF(0,22));
+        m_toggleRateCells.append(toggleRateCell);
+        m_scene.addItem(toggleRateCell);
     }
 
     for(int i=0; i<24; i++)
@@ -118,6 +141,7 @@ BitDisplay::BitDisplay(QWidget *parent)
     m_spinBoxSamplePosition->setMinimum(1);
     m_labelSamplePosition = new QLabel("Sample position:", this);
     m_spinBoxSamplePosition->setEnabled(false);
+    m_labelBitDepthEstimate = new QLabel(trUtf8("Effective bit depth: -"), this);
 
     QGridLayout *optionsLayout = new QGridLayout();
     optionsLayout->addWidget(m_labelSwitch,0,0);
@@ -128,6 +152,7 @@ BitDisplay::BitDisplay(QWidget *parent)
     optionsLayout->addWidget(m_comboBoxDisplayMode,1,1);
     optionsLayout->addWidget(m_labelSamplePosition,1,2);
     optionsLayout->addWidget(m_spinBoxSamplePosition,1,3);
+    optionsLayout->addWidget(m_labelBitDepthEstimate,2,0,1,4);
 
     QHBoxLayout *viewLayout = new QHBoxLayout();
     viewLayout->addWidget(&m_view);
@@ -270,6 +295,11 @@ void BitDisplay::setNumberOfBits(int numberOfBits)
             m_bitCircles.at(i)->setPen(Qt::NoPen);
             m_bitCircles.at(i)->setBrush(brush);
         }
+        m_setRateCells.at(i)->setPen(Qt::NoPen);
+        m_setRateCells.at(i)->setBrush(brush);
+        m_setRateCells.at(i)->setToolTip(QString());
+        m_toggleRateCells.at(i)->setPen(Qt::NoPen);
+        m_toggleRateCells.at(i)->setBrush(brush);
     }
 }
 
@@ -329,6 +359,48 @@ void BitDisplay::setSampleMaximum(int max)
     m_spinBoxSamplePosition->setMaximum(max);
 }
 
+void BitDisplay::updateBitDepthEstimate(int bitDepth, int effectiveBitDepth, int noiseBits, QString verdict)
+{
+    QString text = trUtf8("Effective bit depth: ") + QString::number(effectiveBitDepth) + trUtf8(" of ") + QString::number(bitDepth)
+            + trUtf8(" bit (") + verdict + ")";
+    if(noiseBits > 0)
+    {
+        text += ", " + QString::number(noiseBits) + trUtf8(" noise LSBs");
+    }
+    m_labelBitDepthEstimate->setText(text);
+}
+
+void BitDisplay::updateBitStatistics(const BitStatistics::Snapshot & statistics)
+{
+    // Same positions as in updateDisplay()
+    const int shift = 24 - statistics.m_bitDepth;
+    if(shift < 0 || statistics.m_numberOfSamples == 0)
+    {
+        return;
+    }
+    for(int bit=0; bit<statistics.m_bitDepth; bit++)
+    {
+        QGraphicsRectItem *setRateCell = m_setRateCells.at(bit+shift);
+        QGraphicsRectItem *toggleRateCell = m_toggleRateCells.at(bit+shift);
+        setRateCell->setBrush(QBrush(getHeatmapColor(statistics.m_setRates[bit])));
+        toggleRateCell->setBrush(QBrush(getHeatmapColor(statistics.m_toggleRates[bit])));
+
+        QString toolTip = trUtf8("Bit ") + QString::number(bit) + trUtf8(": set ") + QString::number(statistics.m_setRates[bit]*100.0, 'f', 2)
+                + trUtf8(" %, toggles ") + QString::number(statistics.m_toggleRates[bit]*100.0, 'f', 2) + " %";
+        if((statistics.m_stuckAtZero | statistics.m_stuckAtOne) & (1U << bit))
+        {
+            setRateCell->setPen(QPen(colorStuckBit));
+            toolTip += (statistics.m_stuckAtZero & (1U << bit)) ? trUtf8(", stuck at 0") : trUtf8(", stuck at 1");
+        }
+        else
+        {
+            setRateCell->setPen(Qt::NoPen);
+        }
+        setRateCell->setToolTip(toolTip);
+        toggleRateCell->setToolTip(toolTip);
+    }
+}
+
 void BitDisplay::paintEvent(QPaintEvent *)
 {
     QStyleOption opt;
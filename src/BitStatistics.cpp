@@ -0,0 +1,277 @@
+/*
+ * BitStatistics: Long-run per-bit set, toggle and stuck-bit statistics
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BitStatistics.hpp"
+
+#include <algorithm>
+
+BitStatistics::BitStatistics()
+{
+    setBitDepth(16);
+}
+
+void BitStatistics::setBitDepth(int bitDepth)
+{
+    m_bitDepth = bitDepth;
+    m_mask = static_cast<uint32_t>((1ULL << bitDepth) - 1);
+    clear();
+}
+
+int BitStatistics::getBitDepth() const
+{
+    return m_bitDepth;
+}
+
+// Two samples per word, see BitCounter
+static inline const uint64_t *packWords(const uint32_t *values, uint64_t *words)
+{
+    for(int i=0; i<16; i++)
+    {
+        words[i] = values[2*i] | (static_cast<uint64_t>(values[2*i+1]) << 32);
+    }
+    return words;
+}
+
+void BitStatistics::addSamples(const std::vector<int32_t> & signalValues)
+{
+    uint32_t codes[BitCounter::groupSize];
+    uint32_t toggles[BitCounter::groupSize];
+    uint32_t lowest[BitCounter::groupSize];
+    uint64_t words[BitCounter::groupSize/2];
+    size_t i = 0;
+    while(i < signalValues.size())
+    {
+        if(m_countSinceFlush >= BitCounter::maximumCount)
+        {
+            flush();
+        }
+        const size_t count = std::min(signalValues.size() - i, static_cast<size_t>(BitCounter::groupSize));
+        for(size_t j=0; j<count; j++)
+        {
+            codes[j] = static_cast<uint32_t>(signalValues[i+j]) & m_mask;
+            // The first sample has no predecessor, it toggles nothing
+            toggles[j] = (m_numberOfSamples + j > 0) ? codes[j] ^ m_previousCode : 0;
+            lowest[j] = codes[j] & (~codes[j] + 1);
+            m_previousCode = codes[j];
+        }
+        if(count == BitCounter::groupSize)
+        {
+            m_setBits.addGroup(packWords(codes, words));
+            m_toggledBits.addGroup(packWords(toggles, words));
+            m_lowestBits.addGroup(packWords(lowest, words));
+        }
+        else
+        {
+            for(size_t j=0; j<count; j++)
+            {
+                m_setBits.add(codes[j]);
+                m_toggledBits.add(toggles[j]);
+                m_lowestBits.add(lowest[j]);
+            }
+        }
+        m_numberOfSamples += count;
+        m_countSinceFlush += static_cast<uint32_t>(count);
+        i += count;
+    }
+
+}
+
+void BitStatistics::clear()
+{
+    m_setBits.clear();
+    m_toggledBits.clear();
+    m_lowestBits.clear();
+    m_countSinceFlush = 0;
+    m_previousCode = 0;
+    m_numberOfSamples = 0;
+}
+
+uint64_t BitStatistics::getNumberOfSamples() const
+{
+    return m_numberOfSamples;
+}
+
+uint64_t BitStatistics::getSetCount(int bit) const
+{
+    return m_setBits.getCount(bit);
+}
+
+uint64_t BitStatistics::getToggleCount(int bit) const
+{
+    return m_toggledBits.getCount(bit);
+}
+
+uint64_t BitStatistics::getTrailingZeroCount(int bit) const
+{
+    return m_lowestBits.getCount(bit);
+}
+
+double BitStatistics::getSetRate(int bit) const
+{
+    if(m_numberOfSamples == 0)
+    {
+        return 0.0;
+    }
+    return static_cast<double>(m_setBits.getCount(bit))/m_numberOfSamples;
+}
+
+double BitStatistics::getToggleRate(int bit) const
+{
+    if(m_numberOfSamples < 2)
+    {
+        return 0.0;
+    }
+    return static_cast<double>(m_toggledBits.getCount(bit))/(m_numberOfSamples-1);
+}
+
+uint32_t BitStatistics::getStuckAtZero() const
+{
+    uint32_t stuck = 0;
+    if(m_numberOfSamples == 0)
+    {
+        return stuck;
+    }
+    for(int bit=0; bit<m_bitDepth; bit++)
+    {
+        if(m_setBits.getCount(bit) == 0)
+        {
+            stuck |= 1U << bit;
+        }
+    }
+    return stuck;
+}
+
+uint32_t BitStatistics::getStuckAtOne() const
+{
+    uint32_t stuck = 0;
+    if(m_numberOfSamples == 0)
+    {
+        return stuck;
+    }
+    for(int bit=0; bit<m_bitDepth; bit++)
+    {
+        if(m_setBits.getCount(bit) == m_numberOfSamples)
+        {
+            stuck |= 1U << bit;
+        }
+    }
+    return stuck;
+}
+
+BitStatistics::Snapshot BitStatistics::getSnapshot() const
+{
+    Snapshot snapshot;
+    snapshot.m_bitDepth = m_bitDepth;
+    snapshot.m_numberOfSamples = m_numberOfSamples;
+    for(int bit=0; bit<m_bitDepth; bit++)
+    {
+        snapshot.m_setRates.push_back(getSetRate(bit));
+        snapshot.m_toggleRates.push_back(getToggleRate(bit));
+    }
+    snapshot.m_stuckAtZero = getStuckAtZero();
+    snapshot.m_stuckAtOne = getStuckAtOne();
+    return snapshot;
+}
+
+void BitStatistics::flush()
+{
+    m_setBits.flush();
+    m_toggledBits.flush();
+    m_lowestBits.flush();
+    m_countSinceFlush = 0;
+}
+
+void BitStatistics::BitCounter::clear()
+{
+    m_planes.fill(0);
+    m_counts.fill(0);
+}
+
+void BitStatistics::BitCounter::add(uint32_t bits)
+{
+    addFromPlane(0, bits);
+}
+
+// Carry-save adder: "high" gets the carries and "low" the sums of a + b + c
+static inline void carrySaveAdd(uint64_t & high, uint64_t & low, uint64_t a, uint64_t b, uint64_t c)
+{
+    const uint64_t u = a ^ b;
+    high = (a & b) | (u & c);
+    low = u ^ c;
+}
+
+void BitStatistics::BitCounter::addGroup(const uint64_t *bits)
+{
+    // Harley-Seal: the planes 0 to 3 are the ones, twos, fours and eights of the tree
+    uint64_t & ones = m_planes[0];
+    uint64_t & twos = m_planes[1];
+    uint64_t & fours = m_planes[2];
+    uint64_t & eights = m_planes[3];
+    uint64_t twosA, twosB, foursA, foursB, eightsA, eightsB, sixteens;
+
+    carrySaveAdd(twosA, ones, ones, bits[0], bits[1]);
+    carrySaveAdd(twosB, ones, ones, bits[2], bits[3]);
+    carrySaveAdd(foursA, twos, twos, twosA, twosB);
+    carrySaveAdd(twosA, ones, ones, bits[4], bits[5]);
+    carrySaveAdd(twosB, ones, ones, bits[6], bits[7]);
+    carrySaveAdd(foursB, twos, twos, twosA, twosB);
+    carrySaveAdd(eightsA, fours, fours, foursA, foursB);
+    carrySaveAdd(twosA, ones, ones, bits[8], bits[9]);
+    carrySaveAdd(twosB, ones, ones, bits[10], bits[11]);
+    carrySaveAdd(foursA, twos, twos, twosA, twosB);
+    carrySaveAdd(twosA, ones, ones, bits[12], bits[13]);
+    carrySaveAdd(twosB, ones, ones, bits[14], bits[15]);
+    carrySaveAdd(foursB, twos, twos, twosA, twosB);
+    carrySaveAdd(eightsB, fours, fours, foursA, foursB);
+    carrySaveAdd(sixteens, eights, eights, eightsA, eightsB);
+
+    addFromPlane(4, sixteens);
+}
+
+void BitStatistics::BitCounter::flush()
+{
+    for(int bit=0; bit<32; bit++)
+    {
+        m_counts[bit] = getCount(bit);
+    }
+    m_planes.fill(0);
+}
+
+uint64_t BitStatistics::BitCounter::getCount(int bit) const
+{
+    // The counts in the planes haven't been added yet
+    uint64_t count = m_counts[bit];
+    for(int plane=0; plane<numberOfPlanes; plane++)
+    {
+        count += (((m_planes[plane] >> bit) & 1) + ((m_planes[plane] >> (bit+32)) & 1)) << plane;
+    }
+    return count;
+}
+
+void BitStatistics::BitCounter::addFromPlane(int plane, uint64_t bits)
+{
+    // Ripple carry adder on all bit positions at once
+    for(; plane<numberOfPlanes && bits; plane++)
+    {
+        const uint64_t carry = m_planes[plane] & bits;
+        m_planes[plane] ^= bits;
+        bits = carry;
+    }
+}
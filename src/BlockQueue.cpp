@@ -0,0 +1,127 @@
+/*
+ * BlockQueue: Lock-free queue of sample blocks between capture and analysis
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BlockQueue.hpp"
+
+BlockQueue::BlockQueue(size_t numberOfBlocks, size_t blockSize)
+    : m_writeCounter(0)
+    , m_readCounter(0)
+    , m_droppedBlocks(0)
+    , m_consumerCondition(nullptr)
+{
+    clearAndResize(numberOfBlocks, blockSize);
+}
+
+void BlockQueue::clearAndResize(size_t numberOfBlocks, size_t blockSize, bool pairChannel)
+{
+    m_blocks.resize(numberOfBlocks);
+    for(auto& block : m_blocks)
+    {
+        block.m_samples.assign(blockSize, 0);
+        block.m_pairSamples.assign(pairChannel ? blockSize : 0, 0);
+        block.m_sampleIndex = 0;
+        block.m_systemTime = 0;
+        block.m_adcTime = 0.0;
+    }
+    m_writeCounter = 0;
+    m_readCounter = 0;
+    m_droppedBlocks = 0;
+}
+
+AudioBlock * BlockQueue::getWriteBlock()
+{
+    uint64_t writeCounter = m_writeCounter.load(std::memory_order_relaxed);
+    if(writeCounter - m_readCounter.load(std::memory_order_acquire) >= m_blocks.size())
+    {
+        return nullptr;
+    }
+    return &m_blocks[writeCounter % m_blocks.size()];
+}
+
+void BlockQueue::pushBlock()
+{
+    m_writeCounter.fetch_add(1, std::memory_order_release);
+    // notify_one() doesn't need the mutex, the consumer waits with a timeout in case of a missed wakeup
+    m_condition.notify_one();
+    std::condition_variable *consumerCondition = m_consumerCondition.load(std::memory_order_acquire);
+    if(consumerCondition)
+    {
+        consumerCondition->notify_one();
+    }
+}
+
+void BlockQueue::dropBlock()
+{
+    m_droppedBlocks.fetch_add(1, std::memory_order_relaxed);
+}
+
+AudioBlock * BlockQueue::getReadBlock()
+{
+    uint64_t readCounter = m_readCounter.load(std::memory_order_relaxed);
+    if(readCounter == m_writeCounter.load(std::memory_order_acquire))
+    {
+        return nullptr;
+    }
+    return &m_blocks[readCounter % m_blocks.size()];
+}
+
+AudioBlock * BlockQueue::waitForReadBlock(std::chrono::milliseconds timeout)
+{
+    AudioBlock *block = getReadBlock();
+    if(block)
+    {
+        return block;
+    }
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait_for(lock, timeout);
+    return getReadBlock();
+}
+
+void BlockQueue::popBlock()
+{
+    m_readCounter.fetch_add(1, std::memory_order_release);
+}
+
+void BlockQueue::wakeUp()
+{
+    m_condition.notify_all();
+}
+
+void BlockQueue::setConsumerCondition(std::condition_variable *condition)
+{
+    m_consumerCondition.store(condition, std::memory_order_release);
+}
+
+size_t BlockQueue::getNumberOfQueuedBlocks() const
+{
+    // Read counter first, it can never overtake the write counter
+    uint64_t readCounter = m_readCounter.load(std::memory_order_acquire);
+    return static_cast<size_t>(m_writeCounter.load(std::memory_order_acquire) - readCounter);
+}
+
+size_t BlockQueue::getNumberOfBlocks() const
+{
+    return m_blocks.size();
+}
+
+uint64_t BlockQueue::getNumberOfDroppedBlocks() const
+{
+    return m_droppedBlocks.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,380 @@
+/*
+ * CaptureSpool: Recording of decoded blocks into memory-mapped segment files
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CaptureSpool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+static const char segmentMagic[8] = {'C', 'E', 'M', 'S', 'P', 'O', 'O', 'L'};
+static const uint32_t segmentVersion = 1;
+static const char segmentExtension[] = ".spool";
+// Number of digits of the sequence number in the file name
+static const size_t sequenceDigits = 6;
+// Blocks which can be queued while the spool thread is rotating segments
+static const size_t numberOfQueuedBlocks = 64;
+
+CaptureSpool::CaptureSpool()
+    : m_segmentSize(64*1024*1024)
+    , m_maximumNumberOfSegments(16)
+    , m_bitDepth(16)
+    , m_sampleRate(44100)
+    , m_blockSize(2048)
+    , m_writtenBlocks(0)
+    , m_spoolRunning(false)
+    , m_open(false)
+{
+    m_segment.m_data = nullptr;
+    m_nextSegment.m_data = nullptr;
+}
+
+CaptureSpool::~CaptureSpool()
+{
+    close();
+}
+
+void CaptureSpool::setFileNamePrefix(const std::string & prefix)
+{
+    m_prefix = prefix;
+}
+
+void CaptureSpool::setSegmentSize(size_t segmentSize)
+{
+    m_segmentSize = segmentSize;
+}
+
+void CaptureSpool::setMaximumNumberOfSegments(int maximumNumberOfSegments)
+{
+    m_maximumNumberOfSegments = maximumNumberOfSegments;
+}
+
+const std::string & CaptureSpool::getFileNamePrefix() const
+{
+    return m_prefix;
+}
+
+bool CaptureSpool::open(int bitDepth, uint32_t sampleRate, uint32_t blockSize)
+{
+    close();
+
+    // A segment must hold at least one block
+    const size_t minimumSize = sizeof(SegmentHeader) + sizeof(RecordHeader) + blockSize*sizeof(int32_t);
+    if(m_segmentSize < minimumSize)
+    {
+        std::cout << "ERROR: Spool segment size must be at least " << minimumSize << " bytes" << std::endl;
+        return false;
+    }
+
+    m_bitDepth = bitDepth;
+    m_sampleRate = sampleRate;
+    m_blockSize = blockSize;
+    m_writtenBlocks = 0;
+    m_queue.clearAndResize(numberOfQueuedBlocks, blockSize);
+
+    if(!createSegment(m_segment, 0))
+    {
+        return false;
+    }
+    if(!createSegment(m_nextSegment, 1))
+    {
+        finishSegment(m_segment);
+        return false;
+    }
+
+    m_open = true;
+    m_spoolRunning = true;
+    m_spoolThread = std::thread(&CaptureSpool::runSpoolThread, this);
+    std::cout << "- Spool opened -" << std::endl;
+    std::cout << "Prefix:" << m_prefix << "| Segment size:" << m_segmentSize << "| Segments:" << m_maximumNumberOfSegments << std::endl;
+    return true;
+}
+
+void CaptureSpool::close()
+{
+    if(!m_open)
+    {
+        return;
+    }
+
+    m_spoolRunning = false;
+    m_queue.wakeUp();
+    if(m_spoolThread.joinable())
+    {
+        m_spoolThread.join();
+    }
+
+    finishSegment(m_segment);
+    // The prepared segment doesn't contain any records
+    if(m_nextSegment.m_data)
+    {
+        finishSegment(m_nextSegment);
+        std::remove(getSegmentFileName(m_prefix, m_nextSegment.m_sequence).c_str());
+    }
+    m_open = false;
+    std::cout << "- Spool closed -" << std::endl;
+    std::cout << "Written blocks:" << m_writtenBlocks << "| Dropped blocks:" << m_queue.getNumberOfDroppedBlocks() << std::endl;
+}
+
+bool CaptureSpool::isOpen() const
+{
+    return m_open;
+}
+
+void CaptureSpool::addBlock(const AudioBlock & block)
+{
+    const size_t numberOfSamples = std::min(block.m_samples.size(), static_cast<size_t>(m_blockSize));
+    AudioBlock *spoolBlock = m_queue.getWriteBlock();
+    if(spoolBlock)
+    {
+        std::copy(block.m_samples.begin(), block.m_samples.begin() + numberOfSamples, spoolBlock->m_samples.begin());
+        // Gaps caused by dropped blocks are visible in the sample index
+        spoolBlock->m_sampleIndex = block.m_sampleIndex;
+        spoolBlock->m_systemTime = block.m_systemTime;
+        spoolBlock->m_adcTime = block.m_adcTime;
+        m_queue.pushBlock();
+    }
+    else
+    {
+        m_queue.dropBlock();
+    }
+}
+
+uint64_t CaptureSpool::getNumberOfWrittenBlocks() const
+{
+    return m_writtenBlocks;
+}
+
+uint64_t CaptureSpool::getNumberOfDroppedBlocks() const
+{
+    return m_queue.getNumberOfDroppedBlocks();
+}
+
+std::string CaptureSpool::getSegmentFileName(const std::string & prefix, uint64_t sequence)
+{
+    std::string number = std::to_string(sequence);
+    if(number.size() < sequenceDigits)
+    {
+        number.insert(0, sequenceDigits - number.size(), '0');
+    }
+    return prefix + "_" + number + segmentExtension;
+}
+
+bool CaptureSpool::splitSegmentFileName(const std::string & fileName, std::string & prefix, uint64_t & sequence)
+{
+    const size_t extensionLength = std::strlen(segmentExtension);
+    if(fileName.size() <= extensionLength || fileName.compare(fileName.size()-extensionLength, extensionLength, segmentExtension) != 0)
+    {
+        return false;
+    }
+    const size_t separator = fileName.rfind('_');
+    if(separator == std::string::npos)
+    {
+        return false;
+    }
+    const std::string number = fileName.substr(separator+1, fileName.size()-extensionLength-separator-1);
+    if(number.empty() || number.find_first_not_of("0123456789") != std::string::npos)
+    {
+        return false;
+    }
+    prefix = fileName.substr(0, separator);
+    sequence = std::strtoull(number.c_str(), nullptr, 10);
+    return true;
+}
+
+bool CaptureSpool::isSegmentHeader(const SegmentHeader & header)
+{
+    return std::memcmp(header.m_magic, segmentMagic, sizeof(segmentMagic)) == 0 && header.m_version == segmentVersion;
+}
+
+bool CaptureSpool::createSegment(Segment & segment, uint64_t sequence)
+{
+    const std::string fileName = getSegmentFileName(m_prefix, sequence);
+    segment.m_data = nullptr;
+    segment.m_size = m_segmentSize;
+    segment.m_position = sizeof(SegmentHeader);
+    segment.m_sequence = sequence;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(file == INVALID_HANDLE_VALUE)
+    {
+        std::cout << "ERROR: Could not create spool segment " << fileName << std::endl;
+        return false;
+    }
+    // The mapping sets the size of the file
+    const uint64_t size = m_segmentSize;
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32), static_cast<DWORD>(size & 0xFFFFFFFF), nullptr);
+    void *data = mapping ? MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, m_segmentSize) : nullptr;
+    if(!data)
+    {
+        std::cout << "ERROR: Could not map spool segment " << fileName << std::endl;
+        if(mapping)
+        {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        return false;
+    }
+    segment.m_fileHandle = file;
+    segment.m_mappingHandle = mapping;
+#else
+    int fileDescriptor = ::open(fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(fileDescriptor < 0)
+    {
+        std::cout << "ERROR: Could not create spool segment " << fileName << std::endl;
+        return false;
+    }
+    void *data = MAP_FAILED;
+    if(ftruncate(fileDescriptor, static_cast<off_t>(m_segmentSize)) == 0)
+    {
+        data = mmap(nullptr, m_segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+    }
+    if(data == MAP_FAILED)
+    {
+        std::cout << "ERROR: Could not map spool segment " << fileName << std::endl;
+        ::close(fileDescriptor);
+        ::unlink(fileName.c_str());
+        return false;
+    }
+    segment.m_fileDescriptor = fileDescriptor;
+#endif
+
+    segment.m_data = static_cast<uint8_t *>(data);
+    SegmentHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.m_magic, segmentMagic, sizeof(segmentMagic));
+    header.m_version = segmentVersion;
+    header.m_bitDepth = static_cast<uint32_t>(m_bitDepth);
+    header.m_sampleRate = m_sampleRate;
+    header.m_blockSize = m_blockSize;
+    header.m_sequence = sequence;
+    header.m_usedBytes = 0;
+    std::memcpy(segment.m_data, &header, sizeof(header));
+
+    // Keep only the newest segments, the prepared segment isn't counted
+    if(m_maximumNumberOfSegments > 0 && sequence > static_cast<uint64_t>(m_maximumNumberOfSegments))
+    {
+        std::remove(getSegmentFileName(m_prefix, sequence - m_maximumNumberOfSegments - 1).c_str());
+    }
+    return true;
+}
+
+void CaptureSpool::finishSegment(Segment & segment)
+{
+    if(!segment.m_data)
+    {
+        return;
+    }
+    const size_t usedSize = segment.m_position;
+
+#ifdef _WIN32
+    FlushViewOfFile(segment.m_data, usedSize);
+    UnmapViewOfFile(segment.m_data);
+    CloseHandle(segment.m_mappingHandle);
+    LARGE_INTEGER size;
+    size.QuadPart = static_cast<LONGLONG>(usedSize);
+    SetFilePointerEx(segment.m_fileHandle, size, nullptr, FILE_BEGIN);
+    SetEndOfFile(segment.m_fileHandle);
+    CloseHandle(segment.m_fileHandle);
+#else
+    munmap(segment.m_data, segment.m_size);
+    if(ftruncate(segment.m_fileDescriptor, static_cast<off_t>(usedSize)) != 0)
+    {
+        std::cout << "ERROR: Could not truncate spool segment " << segment.m_sequence << std::endl;
+    }
+    ::close(segment.m_fileDescriptor);
+#endif
+
+    segment.m_data = nullptr;
+}
+
+bool CaptureSpool::rotateSegment()
+{
+    finishSegment(m_segment);
+    m_segment = m_nextSegment;
+    m_nextSegment.m_data = nullptr;
+    if(!m_segment.m_data)
+    {
+        return false;
+    }
+    return createSegment(m_nextSegment, m_segment.m_sequence + 1);
+}
+
+void CaptureSpool::writeBlock(const AudioBlock & block)
+{
+    const size_t samplesSize = block.m_samples.size()*sizeof(int32_t);
+    const size_t recordSize = sizeof(RecordHeader) + samplesSize;
+    if(m_segment.m_position + recordSize > m_segment.m_size)
+    {
+        // The next segment may have failed to be created earlier (e.g. disk full)
+        if(!rotateSegment() && !m_segment.m_data)
+        {
+            return;
+        }
+    }
+
+    RecordHeader record;
+    record.m_sampleIndex = block.m_sampleIndex;
+    record.m_systemTime = block.m_systemTime;
+    record.m_numberOfSamples = static_cast<uint32_t>(block.m_samples.size());
+    record.m_reserved = 0;
+    std::memcpy(m_segment.m_data + m_segment.m_position, &record, sizeof(record));
+    std::memcpy(m_segment.m_data + m_segment.m_position + sizeof(record), block.m_samples.data(), samplesSize);
+    m_segment.m_position += recordSize;
+
+    // Readers only use complete records
+    const uint64_t usedBytes = m_segment.m_position - sizeof(SegmentHeader);
+    std::memcpy(m_segment.m_data + offsetof(SegmentHeader, m_usedBytes), &usedBytes, sizeof(usedBytes));
+    ++m_writtenBlocks;
+}
+
+void CaptureSpool::runSpoolThread()
+{
+    // Write the remaining blocks after close() has been called
+    while(true)
+    {
+        const AudioBlock *block = m_queue.waitForReadBlock(std::chrono::milliseconds(100));
+        if(block)
+        {
+            if(m_segment.m_data)
+            {
+                writeBlock(*block);
+            }
+            m_queue.popBlock();
+        }
+        else if(!m_spoolRunning)
+        {
+            break;
+        }
+    }
+}
@@ -0,0 +1,213 @@
+/*
+ * ChannelPairEntropy: Joint entropy and mutual information of two channels
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ChannelPairEntropy.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// Initial size of the hash table, it only grows within a run
+static const size_t initialTableBits = 12;
+
+ChannelPairEntropy::ChannelPairEntropy(ChannelPairEntropyListener *listener)
+    : m_channelPairEntropyListener(listener)
+    , m_bitDepth(16)
+    , m_mask(0)
+    , m_signBit(0)
+    , m_numberOfBlocks(50)
+    , m_blockCounter(0)
+    , m_numberOfSamples(0)
+    , m_tableBits(initialTableBits)
+    , m_numberOfUsedSlots(0)
+    , m_maximumNumberOfPairs(0)
+    , m_droppedBits(0)
+{
+    m_slots.assign(static_cast<size_t>(1) << m_tableBits, Slot{0, 0});
+    setBitDepth(m_bitDepth);
+}
+
+void ChannelPairEntropy::addSamples(const std::vector<int32_t> & firstValues, const std::vector<int32_t> & secondValues)
+{
+    // Both channels come from the same frames, so the blocks always have the same size
+    if(!m_channelPairEntropyListener || firstValues.size() != secondValues.size())
+    {
+        return;
+    }
+
+    const size_t numberOfSamples = firstValues.size();
+    // Reset everything if its the first block
+    if(m_blockCounter == 0)
+    {
+        clear();
+        const size_t windowSamples = numberOfSamples*static_cast<size_t>(std::max(1, m_numberOfBlocks));
+        m_maximumNumberOfPairs = std::max<size_t>(1, std::min(windowSamples/samplesPerPair, (static_cast<size_t>(1) << maximumTableBits)/2));
+    }
+
+    for(size_t i=0; i<numberOfSamples; i++)
+    {
+        // At most half of the slots are used, so the probe sequences stay short
+        if(m_numberOfUsedSlots >= m_maximumNumberOfPairs || 2*(m_numberOfUsedSlots + 1) > m_slots.size())
+        {
+            makeRoom();
+        }
+        const uint64_t first = ((static_cast<uint32_t>(firstValues[i]) ^ m_signBit) & m_mask) >> m_droppedBits;
+        const uint64_t second = ((static_cast<uint32_t>(secondValues[i]) ^ m_signBit) & m_mask) >> m_droppedBits;
+        addPair(((first << m_bitDepth) | second) + 1, 1);
+    }
+    m_numberOfSamples += numberOfSamples;
+    ++m_blockCounter;
+
+    // Calculate entropy if all blocks have been processed (the number of blocks may have been reduced meanwhile)
+    if(m_blockCounter >= m_numberOfBlocks)
+    {
+        calculateEntropy();
+        m_blockCounter = 0;
+    }
+}
+
+void ChannelPairEntropy::setNumberOfBlocks(int numberOfBlocks)
+{
+    m_numberOfBlocks = numberOfBlocks;
+}
+
+void ChannelPairEntropy::setBitDepth(int bitDepth)
+{
+    m_bitDepth = bitDepth;
+    m_mask = static_cast<uint32_t>((1ULL << bitDepth) - 1);
+    m_signBit = 1U << (bitDepth - 1);
+    clear();
+}
+
+void ChannelPairEntropy::clear()
+{
+    std::fill(m_slots.begin(), m_slots.end(), Slot{0, 0});
+    m_numberOfUsedSlots = 0;
+    m_droppedBits = 0;
+    m_numberOfSamples = 0;
+    m_blockCounter = 0;
+}
+
+void ChannelPairEntropy::addPair(uint64_t key, uint64_t count)
+{
+    // Linear probing, the table is never full
+    const size_t indexMask = m_slots.size() - 1;
+    size_t index = getSlotIndex(key);
+    while(m_slots[index].m_key != 0 && m_slots[index].m_key != key)
+    {
+        index = (index + 1) & indexMask;
+    }
+    if(m_slots[index].m_key == 0)
+    {
+        m_slots[index].m_key = key;
+        ++m_numberOfUsedSlots;
+    }
+    m_slots[index].m_count += count;
+}
+
+void ChannelPairEntropy::makeRoom()
+{
+    // Each dropped bit merges up to four pairs, with all bits dropped only one pair is left
+    while((m_numberOfUsedSlots >= m_maximumNumberOfPairs || 2*(m_numberOfUsedSlots + 1) > m_slots.size()) && m_droppedBits < m_bitDepth)
+    {
+        if(m_numberOfUsedSlots < m_maximumNumberOfPairs && m_tableBits < static_cast<size_t>(maximumTableBits))
+        {
+            rehash(m_tableBits + 1, m_droppedBits);
+        }
+        else
+        {
+            rehash(m_tableBits, m_droppedBits + 1);
+        }
+    }
+}
+
+void ChannelPairEntropy::rehash(size_t tableBits, int droppedBits)
+{
+    const int shift = droppedBits - m_droppedBits;
+    m_oldSlots.swap(m_slots);
+    m_slots.assign(static_cast<size_t>(1) << tableBits, Slot{0, 0});
+    m_tableBits = tableBits;
+    m_numberOfUsedSlots = 0;
+    m_droppedBits = droppedBits;
+
+    for(const auto& slot : m_oldSlots)
+    {
+        if(slot.m_key == 0)
+        {
+            continue;
+        }
+        const uint64_t pair = slot.m_key - 1;
+        const uint64_t first = (pair >> m_bitDepth) >> shift;
+        const uint64_t second = (pair & m_mask) >> shift;
+        addPair(((first << m_bitDepth) | second) + 1, slot.m_count);
+    }
+}
+
+void ChannelPairEntropy::calculateEntropy()
+{
+    if(m_numberOfSamples == 0)
+    {
+        return;
+    }
+
+    // H = log2(N) - sum(c*log2(c))/N
+    double countLogSum = 0.0;
+    m_firstBins.clear();
+    m_secondBins.clear();
+    for(const auto& slot : m_slots)
+    {
+        if(slot.m_key != 0)
+        {
+            const double count = static_cast<double>(slot.m_count);
+            countLogSum += count*std::log2(count);
+            const uint64_t pair = slot.m_key - 1;
+            m_firstBins.push_back(CodeHistogram::Bin{static_cast<uint32_t>(pair >> m_bitDepth), slot.m_count});
+            m_secondBins.push_back(CodeHistogram::Bin{static_cast<uint32_t>(pair & m_mask), slot.m_count});
+        }
+    }
+    const double numberOfSamples = static_cast<double>(m_numberOfSamples);
+    const double jointEntropy = std::max(0.0, std::log2(numberOfSamples) - countLogSum/numberOfSamples);
+
+    const int resolution = m_bitDepth - m_droppedBits;
+    const double firstEntropy = calculateChannelEntropy(m_firstBins, m_numberOfSamples);
+    const double secondEntropy = calculateChannelEntropy(m_secondBins, m_numberOfSamples);
+    // Rounding can make it slightly negative for independent channels
+    const double mutualInformation = std::max(0.0, firstEntropy + secondEntropy - jointEntropy);
+    m_channelPairEntropyListener->receiveChannelPairEntropy(firstEntropy, secondEntropy, jointEntropy, mutualInformation, resolution);
+}
+
+double ChannelPairEntropy::calculateChannelEntropy(std::vector<CodeHistogram::Bin> & bins, uint64_t numberOfSamples)
+{
+    // Every code of a channel occurs in several pairs
+    std::sort(bins.begin(), bins.end(), [](const CodeHistogram::Bin & a, const CodeHistogram::Bin & b) { return a.m_code < b.m_code; });
+    size_t numberOfBins = 0;
+    for(const auto& bin : bins)
+    {
+        if(numberOfBins > 0 && bins[numberOfBins-1].m_code == bin.m_code)
+        {
+            bins[numberOfBins-1].m_count += bin.m_count;
+        }
+        else
+        {
+            bins[numberOfBins++] = bin;
+        }
+    }
+    bins.resize(numberOfBins);
+    return CodeHistogram::calculateEntropy(bins, numberOfSamples);
+}
@@ -0,0 +1,325 @@
+/*
+ * CodeHistogram: Full resolution histogram of the sample codes
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CodeHistogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// Initial size of the sparse table
+static const size_t initialTableBits = 10;
+
+// Sort by codes of "bitDepth" bits, 12 bits per pass starting with the least significant ones (the window may hold
+// millions of bins, and 4096 buckets per pass keep the scattered writes in the cache)
+static void sortBins(std::vector<CodeHistogram::Bin> & bins, int bitDepth)
+{
+    std::vector<CodeHistogram::Bin> sorted(bins.size());
+    std::vector<size_t> positions(4096);
+    for(int shift=0; shift<bitDepth; shift+=12)
+    {
+        std::fill(positions.begin(), positions.end(), 0);
+        for(const auto& bin : bins)
+        {
+            positions[(bin.m_code >> shift) & 0xFFF]++;
+        }
+        size_t position = 0;
+        for(auto& count : positions)
+        {
+            const size_t next = position + count;
+            count = position;
+            position = next;
+        }
+        for(const auto& bin : bins)
+        {
+            sorted[positions[(bin.m_code >> shift) & 0xFFF]++] = bin;
+        }
+        bins.swap(sorted);
+    }
+}
+
+CodeHistogram::CodeHistogram()
+    : m_bitDepth(0)
+    , m_mask(0)
+    , m_signBit(0)
+    , m_numberOfSamples(0)
+    , m_tableBits(0)
+    , m_numberOfUsedSlots(0)
+    , m_maximumTableBits(0)
+    , m_droppedBits(0)
+{
+    setBitDepth(16);
+}
+
+void CodeHistogram::setBitDepth(int bitDepth)
+{
+    m_bitDepth = bitDepth;
+    m_mask = static_cast<uint32_t>((1ULL << bitDepth) - 1);
+    m_signBit = static_cast<uint32_t>(1ULL << (bitDepth - 1));
+    m_denseCounts.assign(bitDepth <= maximumDenseBitDepth ? (1U << bitDepth) : 0, 0);
+    m_tableBits = bitDepth <= maximumDenseBitDepth ? 0 : initialTableBits;
+    m_slots.assign(bitDepth <= maximumDenseBitDepth ? 0 : (static_cast<size_t>(1) << m_tableBits), Bin{0, 0});
+    m_numberOfUsedSlots = 0;
+    m_droppedBits = 0;
+    m_numberOfSamples = 0;
+}
+
+int CodeHistogram::getBitDepth() const
+{
+    return m_bitDepth;
+}
+
+void CodeHistogram::setMaximumTableBits(int tableBits)
+{
+    m_maximumTableBits = static_cast<size_t>(std::max(0, tableBits));
+}
+
+int CodeHistogram::getDroppedBits() const
+{
+    return m_droppedBits;
+}
+
+void CodeHistogram::addSamples(const std::vector<int32_t> & samples)
+{
+    m_numberOfSamples += samples.size();
+    if(!m_denseCounts.empty())
+    {
+        for(const auto& sample : samples)
+        {
+            m_denseCounts[toCode(sample)]++;
+        }
+        return;
+    }
+
+    for(const auto& sample : samples)
+    {
+        addSparseCode(toCode(sample), 1);
+    }
+}
+
+void CodeHistogram::addCodes(const std::vector<uint32_t> & codes)
+{
+    m_numberOfSamples += codes.size();
+    if(!m_denseCounts.empty())
+    {
+        for(const auto& code : codes)
+        {
+            m_denseCounts[code & m_mask]++;
+        }
+        return;
+    }
+
+    for(const auto& code : codes)
+    {
+        addSparseCode(code & m_mask, 1);
+    }
+}
+
+void CodeHistogram::addHistogram(const CodeHistogram & histogram)
+{
+    m_numberOfSamples += histogram.m_numberOfSamples;
+    if(!m_denseCounts.empty())
+    {
+        for(size_t code=0; code<m_denseCounts.size(); code++)
+        {
+            m_denseCounts[code] += histogram.m_denseCounts[code];
+        }
+        return;
+    }
+
+    if(histogram.m_droppedBits > m_droppedBits)
+    {
+        rehash(m_tableBits, histogram.m_droppedBits);
+    }
+    // The other table is iterated in hash order, so its codes must not pass through a table which is still growing:
+    // they would all land in its first part and form one long probe sequence
+    if(2*(m_numberOfUsedSlots + histogram.m_numberOfUsedSlots) > m_slots.size())
+    {
+        growTable(histogram.m_numberOfUsedSlots);
+    }
+    for(const auto& slot : histogram.m_slots)
+    {
+        if(slot.m_count != 0)
+        {
+            addSparseCode(slot.m_code << histogram.m_droppedBits, slot.m_count);
+        }
+    }
+}
+
+void CodeHistogram::makeRoom()
+{
+    // With all bits dropped only one code is left
+    while(2*(m_numberOfUsedSlots + 1) > m_slots.size() && m_droppedBits < m_bitDepth)
+    {
+        if(m_maximumTableBits == 0 || m_tableBits < m_maximumTableBits)
+        {
+            growTable(1);
+        }
+        else
+        {
+            rehash(m_tableBits, m_droppedBits + 1);
+        }
+    }
+}
+
+void CodeHistogram::growTable(size_t numberOfCodes)
+{
+    size_t tableBits = m_tableBits;
+    while(2*(m_numberOfUsedSlots + numberOfCodes) > (static_cast<size_t>(1) << tableBits)
+          && (m_maximumTableBits == 0 || tableBits < m_maximumTableBits))
+    {
+        ++tableBits;
+    }
+    if(tableBits > m_tableBits)
+    {
+        rehash(tableBits, m_droppedBits);
+    }
+}
+
+void CodeHistogram::rehash(size_t tableBits, int droppedBits)
+{
+    const int shift = droppedBits - m_droppedBits;
+    std::vector<Bin> oldSlots;
+    oldSlots.swap(m_slots);
+    m_slots.assign(static_cast<size_t>(1) << tableBits, Bin{0, 0});
+    m_tableBits = tableBits;
+    m_numberOfUsedSlots = 0;
+    m_droppedBits = droppedBits;
+    for(const auto& slot : oldSlots)
+    {
+        if(slot.m_count != 0)
+        {
+            insertCode(slot.m_code >> shift, slot.m_count);
+        }
+    }
+}
+
+void CodeHistogram::clear()
+{
+    std::fill(m_denseCounts.begin(), m_denseCounts.end(), 0);
+    std::fill(m_slots.begin(), m_slots.end(), Bin{0, 0});
+    m_numberOfUsedSlots = 0;
+    m_droppedBits = 0;
+    m_numberOfSamples = 0;
+}
+
+uint64_t CodeHistogram::getNumberOfSamples() const
+{
+    return m_numberOfSamples;
+}
+
+double CodeHistogram::getEntropy() const
+{
+    if(m_denseCounts.empty())
+    {
+        return calculateEntropy(m_slots, m_numberOfSamples);
+    }
+    if(m_numberOfSamples == 0)
+    {
+        return 0.0;
+    }
+    double entropy = 0.0;
+    for(const auto& count : m_denseCounts)
+    {
+        if(count > 0)
+        {
+            const double probability = static_cast<double>(count)/m_numberOfSamples;
+            entropy -= probability*std::log2(probability);
+        }
+    }
+    return entropy;
+}
+
+void CodeHistogram::getBins(std::vector<Bin> & bins) const
+{
+    bins.clear();
+    if(m_denseCounts.empty())
+    {
+        bins.reserve(m_numberOfUsedSlots);
+        for(const auto& slot : m_slots)
+        {
+            if(slot.m_count != 0)
+            {
+                bins.push_back(slot);
+            }
+        }
+        sortBins(bins, m_bitDepth - m_droppedBits);
+        return;
+    }
+    for(size_t code=0; code<m_denseCounts.size(); code++)
+    {
+        if(m_denseCounts[code] > 0)
+        {
+            Bin bin = {static_cast<uint32_t>(code), m_denseCounts[code]};
+            bins.push_back(bin);
+        }
+    }
+}
+
+void CodeHistogram::getEntropyProfile(std::vector<double> & profile) const
+{
+    profile.assign(m_bitDepth, 0.0);
+    getBins(m_profileBins);
+    const int resolution = m_bitDepth - m_droppedBits;
+    for(int bits=m_bitDepth; bits>resolution; bits--)
+    {
+        profile[bits-1] = bits - resolution + (resolution > 0 ? calculateEntropy(m_profileBins, m_numberOfSamples) : 0.0);
+    }
+    for(int bits=resolution; bits>=1; bits--)
+    {
+        profile[bits-1] = calculateEntropy(m_profileBins, m_numberOfSamples);
+
+        // Dropping the LSB merges the bins 2k and 2k+1, which are neighbours in the sorted bins
+        size_t numberOfBins = 0;
+        for(const auto& bin : m_profileBins)
+        {
+            const uint32_t code = bin.m_code >> 1;
+            if(numberOfBins > 0 && m_profileBins[numberOfBins-1].m_code == code)
+            {
+                m_profileBins[numberOfBins-1].m_count += bin.m_count;
+            }
+            else
+            {
+                m_profileBins[numberOfBins].m_code = code;
+                m_profileBins[numberOfBins].m_count = bin.m_count;
+                ++numberOfBins;
+            }
+        }
+        m_profileBins.resize(numberOfBins);
+    }
+}
+
+double CodeHistogram::calculateEntropy(const std::vector<Bin> & bins, uint64_t numberOfSamples)
+{
+    if(numberOfSamples == 0)
+    {
+        return 0.0;
+    }
+    double entropy = 0.0;
+    for(const auto& bin : bins)
+    {
+        if(bin.m_count == 0)
+        {
+            continue;
+        }
+        const double probability = static_cast<double>(bin.m_count)/numberOfSamples;
+        entropy -= probability*std::log2(probability);
+    }
+    return entropy;
+}
@@ -0,0 +1,948 @@
+/*
+ * ConsoleRunner: Analysis without GUI for benchmarks and regression tests
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ConsoleRunner.hpp"
+#include "FileSource.hpp"
+#include "SyntheticSource.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+const double INF = -999.0;
+
+static void printMoments(const char *title, const RunningMoments::Result & moments)
+{
+    std::cout << title << " (" << moments.m_numberOfSamples << " samples): DC offset: " << std::setprecision(3) << moments.m_dcOffset
+              << " LSB (" << std::setprecision(2) << moments.m_dcOffsetDb << " dBFS) | AC RMS: " << std::setprecision(3) << moments.m_acRms
+              << " LSB (" << std::setprecision(2) << moments.m_acRmsDb << " dBFS) | Skewness: " << std::setprecision(3) << moments.m_skewness
+              << " | Kurtosis: " << moments.m_kurtosis << std::endl;
+}
+
+// Parse a comma separated list of numbers, e.g. "3,5"
+static std::vector<int> parseNumberList(const std::string & value)
+{
+    std::vector<int> numbers;
+    size_t begin = 0;
+    while(begin <= value.size())
+    {
+        size_t end = value.find(',', begin);
+        if(end == std::string::npos)
+        {
+            end = value.size();
+        }
+        numbers.push_back(std::atoi(value.substr(begin, end-begin).c_str()));
+        begin = end+1;
+    }
+    return numbers;
+}
+
+ConsoleRunner::ConsoleRunner()
+    : m_sourceType("synthetic")
+    , m_patternName("sine")
+    , m_deviceNumber(0)
+    , m_channel(1)
+    , m_pairChannel(0)
+    , m_channelCount(1)
+    , m_bitDepth(16)
+    , m_sampleRate(44100)
+    , m_blockSize(2048)
+    , m_framesPerBuffer(0)
+    , m_duration(10.0)
+    , m_realTime(false)
+    , m_numberOfBlocks(50)
+    , m_entropyDecaying(false)
+    , m_sketchCounters(0)
+    , m_sketchMemory(1.0)
+    , m_triggerEnabled(false)
+    , m_missingCodesEnabled(false)
+    , m_numberOfSamples(0)
+    , m_portAudioControl(nullptr)
+    , m_entropy(this)
+    , m_entropyProfile(this)
+    , m_predictionEntropy(this)
+    , m_losslessBitrate(this)
+    , m_multiResolutionEntropy(this)
+    , m_channelPairEntropy(this)
+    , m_peakMeter(this)
+    , m_rmsMeter(this)
+    , m_runningMoments(this)
+    , m_receivedSamples(0)
+    , m_receivedBlocks(0)
+    , m_minimumBlockTime(0.0)
+    , m_maximumBlockTime(0.0)
+    , m_totalBlockTime(0.0)
+    , m_entropyValue(-1.0)
+    , m_entropyTime(0.0)
+    , m_distinctSymbolsValue(0.0)
+    , m_conditionalEntropyValue(0.0)
+    , m_conditionalResolution(0)
+    , m_losslessBitrateValue(-1.0)
+    , m_pairResolution(0)
+    , m_pairFirstEntropy(0.0)
+    , m_pairSecondEntropy(0.0)
+    , m_pairJointEntropy(0.0)
+    , m_mutualInformation(0.0)
+    , m_blockEndTime(0.0)
+    , m_peakValue(INF)
+    , m_rmsValue(INF)
+    , m_momentsWindow()
+{
+}
+
+ConsoleRunner::~ConsoleRunner()
+{
+    if(m_source)
+    {
+        m_source->close();
+    }
+}
+
+bool ConsoleRunner::isConsoleMode(int argc, char *argv[])
+{
+    for(int i=1; i<argc; i++)
+    {
+        if(std::string(argv[i]) == "--console")
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ConsoleRunner::parseArguments(int argc, char *argv[])
+{
+    for(int i=1; i<argc; i++)
+    {
+        std::string option = argv[i];
+        if(option == "--console")
+        {
+            continue;
+        }
+        if(option == "--help")
+        {
+            // The usage is printed by the caller
+            return false;
+        }
+        if(option == "--realtime")
+        {
+            m_realTime = true;
+            continue;
+        }
+        if(option == "--missing-codes")
+        {
+            m_missingCodesEnabled = true;
+            continue;
+        }
+        if(option == "--entropy-decay")
+        {
+            m_entropyDecaying = true;
+            continue;
+        }
+        // All other options are followed by a value
+        if(i+1 >= argc)
+        {
+            std::cout << "ERROR: Unknown option or missing value: " << option << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+        if(option == "--source")
+        {
+            m_sourceType = value;
+        }
+        else if(option == "--pattern")
+        {
+            m_patternName = value;
+        }
+        else if(option == "--file")
+        {
+            m_fileName = value;
+        }
+        else if(option == "--device")
+        {
+            m_deviceNumbers = parseNumberList(value);
+            m_deviceNumber = m_deviceNumbers.front();
+        }
+        else if(option == "--channel")
+        {
+            m_channels = parseNumberList(value);
+            m_channel = m_channels.front();
+        }
+        else if(option == "--pair-channel")
+        {
+            m_pairChannel = std::atoi(value.c_str());
+        }
+        else if(option == "--channels")
+        {
+            m_channelCount = std::atoi(value.c_str());
+        }
+        else if(option == "--bits")
+        {
+            m_bitDepth = std::atoi(value.c_str());
+        }
+        else if(option == "--rate")
+        {
+            m_sampleRate = static_cast<uint32_t>(std::atoi(value.c_str()));
+        }
+        else if(option == "--block")
+        {
+            m_blockSize = static_cast<uint32_t>(std::atoi(value.c_str()));
+        }
+        else if(option == "--hw-buffer")
+        {
+            m_framesPerBuffer = static_cast<unsigned long>(std::atol(value.c_str()));
+        }
+        else if(option == "--duration")
+        {
+            m_duration = std::atof(value.c_str());
+        }
+        else if(option == "--entropy-blocks")
+        {
+            m_numberOfBlocks = std::atoi(value.c_str());
+        }
+        else if(option == "--entropy-sketch")
+        {
+            m_sketchCounters = std::atoi(value.c_str());
+        }
+        else if(option == "--sketch-memory")
+        {
+            m_sketchMemory = std::atof(value.c_str());
+        }
+        else if(option == "--history-output")
+        {
+            m_historyFileName = value;
+        }
+        else if(option == "--spool")
+        {
+            m_spoolPrefix = value;
+        }
+        else if(option == "--trigger")
+        {
+            if(!parseTriggers(value))
+            {
+                return false;
+            }
+        }
+        else if(option == "--trigger-window")
+        {
+            EventTrigger::Settings settings = m_eventTrigger.getSettings();
+            settings.m_preTriggerTime = std::atof(value.c_str());
+            settings.m_postTriggerTime = settings.m_preTriggerTime;
+            m_eventTrigger.setSettings(settings);
+        }
+        else if(option == "--trigger-output")
+        {
+            EventTrigger::Settings settings = m_eventTrigger.getSettings();
+            settings.m_fileNamePrefix = value;
+            m_eventTrigger.setSettings(settings);
+        }
+        else
+        {
+            std::cout << "ERROR: Unknown option " << option << std::endl;
+            return false;
+        }
+    }
+
+    if(m_pairChannel < 0 || (m_pairChannel > 0 && m_pairChannel == m_channel && m_channels.size() <= 1))
+    {
+        std::cout << "ERROR: The pair channel must be another input channel" << std::endl;
+        return false;
+    }
+    if(m_sketchCounters < 0 || m_sketchMemory <= 0.0 || (m_sketchCounters > 0 && m_entropyDecaying))
+    {
+        std::cout << "ERROR: The entropy sketch needs a positive number of counters and memory size and can't decay" << std::endl;
+        return false;
+    }
+    if(m_blockSize == 0 || m_sampleRate == 0 || m_numberOfBlocks < 1 || m_duration <= 0.0)
+    {
+        std::cout << "ERROR: Block size, sample rate, number of entropy blocks and duration must be positive" << std::endl;
+        return false;
+    }
+    if(m_deviceNumbers.size() > 1 && (m_sourceType != "portaudio" || (m_channels.size() > 1 && m_channels.size() != m_deviceNumbers.size())))
+    {
+        std::cout << "ERROR: Several devices need --source portaudio and one channel or one channel per device" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void ConsoleRunner::printUsage() const
+{
+    std::cout << "Usage: code-entropy-meter --console [options]\n"
+                 "  --help                 Show this help\n"
+                 "  --source synthetic|file|portaudio  Sample source (default: synthetic)\n"
+                 "  --pattern sine|noise|silence|truncated|stuckbit|ramp  Synthetic signal (default: sine)\n"
+                 "  --file <path>          WAV or raw PCM file for --source file\n"
+                 "  --device <index>[,...] PortAudio device(s) for --source portaudio, several devices are captured concurrently\n"
+                 "  --channel <n>[,...]    Input channel, or one per device (default: 1)\n"
+                 "  --pair-channel <n>     Joint entropy and mutual information of the input channel and channel <n>\n"
+                 "  --channels <n>         Number of channels of raw PCM files (default: 1)\n"
+                 "  --bits 8|16|24         Bit depth (default: 16)\n"
+                 "  --rate <Hz>            Sample rate (default: 44100)\n"
+                 "  --block <samples>      Block size (default: 2048)\n"
+                 "  --hw-buffer <frames>   Frames per PortAudio buffer, 0 lets the host API choose (default: 0)\n"
+                 "  --duration <s>         Amount of audio to analyze in seconds (default: 10)\n"
+                 "  --entropy-blocks <n>   Number of blocks per entropy value (default: 50)\n"
+                 "  --entropy-decay        Entropy after every block, weighted with a time constant of <n> entropy blocks\n"
+                 "  --entropy-sketch <k>   Estimate the entropy with k sketch counters (error about 2.5/sqrt(k) bit) instead of counting\n"
+                 "  --sketch-memory <MB>   Memory of the entropy sketch, independent of bit depth and duration (default: 1)\n"
+                 "  --history-output <file>  Write entropy, peak and RMS of every window to a CSV file\n"
+                 "  --spool <prefix>       Record the samples into <prefix>_<n>.spool (readable with --source file)\n"
+                 "  --trigger <conditions> Write WAV files around events: clip,entropy:<bit>,rms:<dB>,bits\n"
+                 "  --trigger-window <s>   Seconds before and after an event (default: 5)\n"
+                 "  --trigger-output <prefix>  Path and beginning of the event file names (default: event)\n"
+                 "  --missing-codes        Report missing codes, DNL and INL (code density test with a ramp or uniform noise)\n"
+                 "  --realtime             Deliver synthetic and file samples at the sample rate\n"
+              << std::endl;
+}
+
+bool ConsoleRunner::createSource()
+{
+    if(m_sourceType == "synthetic")
+    {
+        SyntheticSource::Pattern pattern;
+        if(!SyntheticSource::getPatternFromName(m_patternName, pattern))
+        {
+            std::cout << "ERROR: Unknown pattern " << m_patternName << std::endl;
+            return false;
+        }
+        SyntheticSource *source = new SyntheticSource(this);
+        source->setPattern(pattern);
+        // Half of the bits and the MSB are useful defaults for the bit patterns
+        source->setEffectiveBits(m_bitDepth/2);
+        source->setStuckBit(m_bitDepth-2, true);
+        source->setRealTime(m_realTime);
+        m_source.reset(source);
+    }
+    else if(m_sourceType == "file")
+    {
+        FileSource *source = new FileSource(this);
+        source->setFileName(m_fileName);
+        source->setRawChannelCount(m_channelCount);
+        source->setChannel(m_channel);
+        source->setRealTime(m_realTime);
+        m_source.reset(source);
+    }
+    else if(m_sourceType == "portaudio")
+    {
+        PortAudioControl *source = new PortAudioControl(this);
+        m_source.reset(source);
+        m_portAudioControl = source;
+        if(!source->initialize())
+        {
+            return false;
+        }
+        source->setDevice(m_deviceNumber, m_channel);
+        source->setFramesPerBuffer(m_framesPerBuffer);
+    }
+    else
+    {
+        std::cout << "ERROR: Unknown source " << m_sourceType << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool ConsoleRunner::parseTriggers(const std::string & triggers)
+{
+    EventTrigger::Settings settings = m_eventTrigger.getSettings();
+    size_t begin = 0;
+    while(begin <= triggers.size())
+    {
+        size_t end = triggers.find(',', begin);
+        if(end == std::string::npos)
+        {
+            end = triggers.size();
+        }
+        const std::string condition = triggers.substr(begin, end-begin);
+        const size_t separator = condition.find(':');
+        const std::string name = condition.substr(0, separator);
+        const bool hasValue = separator != std::string::npos;
+        const double value = hasValue ? std::atof(condition.c_str()+separator+1) : 0.0;
+        if(name == "clip")
+        {
+            settings.m_clip = true;
+        }
+        else if(name == "bits")
+        {
+            settings.m_bitChange = true;
+        }
+        else if(name == "entropy" && hasValue)
+        {
+            settings.m_entropyDrop = true;
+            settings.m_entropyThreshold = value;
+        }
+        else if(name == "rms" && hasValue)
+        {
+            settings.m_rmsStep = true;
+            settings.m_rmsStepSize = value;
+        }
+        else
+        {
+            std::cout << "ERROR: Unknown trigger condition " << condition << std::endl;
+            return false;
+        }
+        begin = end+1;
+    }
+    m_eventTrigger.setSettings(settings);
+    m_triggerEnabled = true;
+    return true;
+}
+
+void ConsoleRunner::copyOptions(const ConsoleRunner & other, int deviceNumber, int channel, const std::string & suffix)
+{
+    m_sourceType = other.m_sourceType;
+    m_deviceNumber = deviceNumber;
+    m_channel = channel;
+    m_pairChannel = other.m_pairChannel;
+    m_bitDepth = other.m_bitDepth;
+    m_sampleRate = other.m_sampleRate;
+    m_blockSize = other.m_blockSize;
+    m_framesPerBuffer = other.m_framesPerBuffer;
+    m_duration = other.m_duration;
+    m_numberOfBlocks = other.m_numberOfBlocks;
+    m_entropyDecaying = other.m_entropyDecaying;
+    m_sketchCounters = other.m_sketchCounters;
+    m_sketchMemory = other.m_sketchMemory;
+    m_spoolPrefix = other.m_spoolPrefix.empty() ? std::string() : other.m_spoolPrefix + suffix;
+    // e.g. "history.csv" becomes "history-device3.csv"
+    m_historyFileName = other.m_historyFileName;
+    size_t extension = m_historyFileName.rfind('.');
+    const size_t directory = m_historyFileName.find_last_of("/\\");
+    if(extension == std::string::npos || (directory != std::string::npos && extension < directory))
+    {
+        extension = m_historyFileName.size();
+    }
+    if(!m_historyFileName.empty())
+    {
+        m_historyFileName.insert(extension, suffix);
+    }
+    m_triggerEnabled = other.m_triggerEnabled;
+    m_missingCodesEnabled = other.m_missingCodesEnabled;
+    EventTrigger::Settings settings = other.m_eventTrigger.getSettings();
+    settings.m_fileNamePrefix += suffix;
+    m_eventTrigger.setSettings(settings);
+}
+
+bool ConsoleRunner::openSource(AnalysisPool *pool)
+{
+    if(!createSource())
+    {
+        return false;
+    }
+
+    if(!m_spoolPrefix.empty())
+    {
+        m_captureSpool.setFileNamePrefix(m_spoolPrefix);
+        m_source->setCaptureSpool(&m_captureSpool);
+    }
+    m_source->setAnalysisPool(pool);
+    m_source->setPairChannel(m_pairChannel);
+
+    m_entropy.setNumberOfBlocks(m_numberOfBlocks);
+    if(m_sketchCounters > 0)
+    {
+        m_entropy.setSketchSize(m_sketchCounters, static_cast<size_t>(m_sketchMemory*1024.0*1024.0));
+        m_entropy.setMode(Entropy::Mode::Approximate);
+    }
+    else
+    {
+        m_entropy.setMode(m_entropyDecaying ? Entropy::Mode::Decaying : Entropy::Mode::Blocks);
+    }
+    m_entropyProfile.setNumberOfBlocks(m_numberOfBlocks);
+    m_predictionEntropy.setNumberOfBlocks(m_numberOfBlocks);
+    m_losslessBitrate.setNumberOfBlocks(m_numberOfBlocks);
+    m_channelPairEntropy.setNumberOfBlocks(m_numberOfBlocks);
+    m_runningMoments.setNumberOfBlocks(m_numberOfBlocks);
+    m_entropyHistory.setNumberOfBlocks(m_numberOfBlocks);
+    if(!m_source->open(m_bitDepth, m_sampleRate, m_blockSize))
+    {
+        return false;
+    }
+
+    // Files may have another format than given on the command line
+    m_bitDepth = m_source->getBitDepth();
+    m_sampleRate = m_source->getSampleRate();
+    m_numberOfSamples = static_cast<uint64_t>(m_duration*m_sampleRate);
+    return true;
+}
+
+bool ConsoleRunner::isDone() const
+{
+    if(m_receivedSamples >= m_numberOfSamples)
+    {
+        return true;
+    }
+    return m_source->isFinished() && m_source->getQueue().getNumberOfQueuedBlocks() == 0;
+}
+
+StreamStatistics::Snapshot ConsoleRunner::closeSource()
+{
+    // The CPU load is only available while the stream is open
+    StreamStatistics::Snapshot statistics;
+    if(m_portAudioControl)
+    {
+        statistics = m_portAudioControl->getStreamStatistics();
+    }
+
+    // Stop the receiver thread before the results are read
+    m_source->close();
+    if(m_triggerEnabled)
+    {
+        m_eventTrigger.stop();
+    }
+    return statistics;
+}
+
+int ConsoleRunner::run()
+{
+    if(m_deviceNumbers.size() > 1)
+    {
+        return runDevices();
+    }
+
+    if(!openSource(nullptr))
+    {
+        return 1;
+    }
+
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    while(!isDone())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    double wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    StreamStatistics::Snapshot statistics = closeSource();
+    printResults(wallTime);
+    if(m_portAudioControl)
+    {
+        printStreamStatistics(statistics);
+    }
+    return 0;
+}
+
+int ConsoleRunner::runDevices()
+{
+    m_analysisPool.reset(new AnalysisPool());
+    std::cout << "Capturing " << m_deviceNumbers.size() << " devices with " << m_analysisPool->getNumberOfThreads() << " analysis threads" << std::endl;
+
+    for(size_t i=0; i<m_deviceNumbers.size(); i++)
+    {
+        const int channel = (m_channels.size() > 1) ? m_channels[i] : m_channel;
+        std::unique_ptr<ConsoleRunner> runner(new ConsoleRunner());
+        runner->copyOptions(*this, m_deviceNumbers[i], channel, "-device" + std::to_string(m_deviceNumbers[i]));
+        m_deviceRunners.push_back(std::move(runner));
+    }
+    // All streams are opened first, so they start at about the same time
+    for(auto& runner : m_deviceRunners)
+    {
+        if(!runner->openSource(m_analysisPool.get()))
+        {
+            return 1;
+        }
+    }
+
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    while(!std::all_of(m_deviceRunners.begin(), m_deviceRunners.end(), [](const std::unique_ptr<ConsoleRunner> & runner) { return runner->isDone(); }))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    double wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::vector<StreamStatistics::Snapshot> statistics;
+    for(auto& runner : m_deviceRunners)
+    {
+        statistics.push_back(runner->closeSource());
+    }
+    for(size_t i=0; i<m_deviceRunners.size(); i++)
+    {
+        std::cout << std::endl << "Device " << m_deviceNumbers[i] << ":" << std::endl;
+        m_deviceRunners[i]->printResults(wallTime);
+        m_deviceRunners[i]->printStreamStatistics(statistics[i]);
+    }
+    return 0;
+}
+
+void ConsoleRunner::printResults(double wallTime) const
+{
+    const double numberOfSamples = static_cast<double>(m_receivedSamples);
+    const double audioTime = numberOfSamples/m_sampleRate;
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Source: " << m_source->getName() << " | " << m_bitDepth << " bit | " << m_sampleRate
+              << " Hz | Block size: " << m_blockSize << std::endl;
+    std::cout << "Blocks: " << m_receivedBlocks << " | Samples: " << m_receivedSamples
+              << " | Dropped blocks: " << m_source->getQueue().getNumberOfDroppedBlocks() << std::endl;
+    if(wallTime > 0.0)
+    {
+        std::cout << "Wall time: " << wallTime << " s | Throughput: " << numberOfSamples/wallTime/1.0e6
+                  << " MSamples/s (" << audioTime/wallTime << "x real time)" << std::endl;
+    }
+    if(m_receivedBlocks > 0)
+    {
+        std::cout << "Analysis time per block: min " << m_minimumBlockTime*1000.0 << " ms | mean "
+                  << m_totalBlockTime/m_receivedBlocks*1000.0 << " ms | max " << m_maximumBlockTime*1000.0 << " ms" << std::endl;
+    }
+    // The entropy is only calculated after the given number of blocks
+    if(m_entropyValue < 0.0)
+    {
+        std::cout << "Entropy: - (less than " << m_numberOfBlocks << " blocks)";
+    }
+    else
+    {
+        std::cout << "Entropy: " << std::setprecision(5) << m_entropyValue << " bit (at " << std::setprecision(3) << m_entropyTime << " s";
+        if(m_entropyDecaying)
+        {
+            std::cout << ", decaying with " << m_numberOfBlocks << " blocks time constant";
+        }
+        if(m_sketchCounters > 0)
+        {
+            std::cout << ", approximate";
+        }
+        std::cout << ")";
+    }
+    std::cout << " | Peak: " << std::setprecision(2)
+              << m_peakValue << " dB | RMS: " << m_rmsValue << " dB" << std::endl;
+    if(m_momentsWindow.m_numberOfSamples > 0)
+    {
+        printMoments("Moments of the last window", m_momentsWindow);
+    }
+    if(m_runningMoments.getTotal().m_count > 0)
+    {
+        printMoments("Moments of all samples", m_runningMoments.getResult(m_runningMoments.getTotal()));
+    }
+    // The entropy profile counts every code of the same window, so its full resolution value is the exact entropy
+    if(m_sketchCounters > 0 && m_entropyValue >= 0.0)
+    {
+        const EntropySketch & sketch = m_entropy.getSketch();
+        std::cout << "Entropy sketch: " << sketch.getNumberOfCounters() << " counters, " << std::setprecision(1)
+                  << sketch.getMemorySize()/1024.0 << " kB | Standard error: " << std::setprecision(3) << sketch.getEntropyError()
+                  << " bit | Distinct symbols: " << std::setprecision(0) << m_distinctSymbolsValue << " (+-"
+                  << std::setprecision(1) << sketch.getDistinctSymbolsError()*100.0 << " %)";
+        if(!m_entropyProfileValues.empty())
+        {
+            const double exactEntropy = m_entropyProfileValues.back();
+            std::cout << " | Exact: " << std::setprecision(5) << exactEntropy << " bit | Error: "
+                      << std::showpos << m_entropyValue - exactEntropy << std::noshowpos << " bit";
+        }
+        std::cout << std::endl;
+    }
+    // Same window as the entropy, so it belongs to the same blocks
+    if(!m_entropyProfileValues.empty())
+    {
+        std::cout << "Entropy per bit depth (bits: bit):" << std::setprecision(3);
+        for(size_t i=0; i<m_entropyProfileValues.size(); i++)
+        {
+            std::cout << " " << i+1 << ": " << m_entropyProfileValues[i];
+        }
+        std::cout << std::endl;
+    }
+    if(!m_residualEntropyValues.empty())
+    {
+        std::cout << "Residual entropy (order: bit):" << std::setprecision(3);
+        for(size_t i=0; i<m_residualEntropyValues.size(); i++)
+        {
+            std::cout << " " << i+1 << ": " << m_residualEntropyValues[i];
+        }
+        std::cout << " | Conditional entropy: " << m_conditionalEntropyValue << " bit (counted with "
+                  << m_conditionalResolution << " MSBs)" << std::endl;
+    }
+    if(!m_multiResolutionEntropyValues.empty())
+    {
+        std::cout << "Entropy per window (blocks: bit):" << std::setprecision(5);
+        for(size_t level=0; level<m_multiResolutionEntropyValues.size(); level++)
+        {
+            std::cout << " " << MultiResolutionEntropy::getNumberOfBlocks(static_cast<int>(level)) << ": ";
+            if(m_multiResolutionEntropyValues[level] < 0.0)
+            {
+                std::cout << "-";
+            }
+            else
+            {
+                std::cout << m_multiResolutionEntropyValues[level];
+            }
+        }
+        std::cout << std::endl;
+    }
+    if(m_pairResolution > 0)
+    {
+        std::cout << "Channel pair " << m_channel << "/" << m_pairChannel << " (" << m_pairResolution << " bit): Entropy "
+                  << std::setprecision(5) << m_pairFirstEntropy << " / " << m_pairSecondEntropy << " bit | Joint entropy: "
+                  << m_pairJointEntropy << " bit | Mutual information: " << m_mutualInformation << " bit" << std::endl;
+    }
+    if(m_losslessBitrateValue >= 0.0)
+    {
+        std::cout << "Lossless bitrate (FLAC-like estimate): " << std::setprecision(4) << m_losslessBitrateValue << " bit/sample"
+                  << " | Ratio: " << std::setprecision(3) << m_losslessBitrateValue/m_bitDepth << " | Predictor: " << m_losslessPredictor << std::endl;
+    }
+    const BitDepthEstimator::Estimate estimate = m_bitDepthEstimator.getEstimate();
+    if(estimate.m_verdict != BitDepthEstimator::Verdict::Unknown)
+    {
+        std::cout << "Effective bit depth: " << estimate.m_effectiveBitDepth << " of " << estimate.m_bitDepth << " bit ("
+                  << BitDepthEstimator::getVerdictName(estimate.m_verdict) << ") | Zero LSBs: " << estimate.m_paddedBits
+                  << " | Noise LSBs: " << estimate.m_noiseBits << " | LSB toggle rate: " << std::setprecision(3) << estimate.m_lsbToggleRate << std::endl;
+    }
+    // Without a verdict (silence, a dead input) the stuck bits are the interesting part
+    const BitStatistics::Snapshot statistics = m_bitDepthEstimator.getStatistics().getSnapshot();
+    if(statistics.m_numberOfSamples > 0)
+    {
+        // MSB first, as in the GUI
+        std::cout << "Bit set rate (bit: %):" << std::setprecision(1);
+        for(int bit=statistics.m_bitDepth-1; bit>=0; bit--)
+        {
+            std::cout << " " << bit << ": " << statistics.m_setRates[bit]*100.0;
+        }
+        std::cout << std::endl << "Bit toggle rate (bit: %):";
+        for(int bit=statistics.m_bitDepth-1; bit>=0; bit--)
+        {
+            std::cout << " " << bit << ": " << statistics.m_toggleRates[bit]*100.0;
+        }
+        std::cout << std::endl << "Stuck bits:";
+        if(!statistics.m_stuckAtZero && !statistics.m_stuckAtOne)
+        {
+            std::cout << " none";
+        }
+        for(int bit=statistics.m_bitDepth-1; bit>=0; bit--)
+        {
+            if((statistics.m_stuckAtZero | statistics.m_stuckAtOne) & (1U << bit))
+            {
+                std::cout << " " << bit << "=" << ((statistics.m_stuckAtOne & (1U << bit)) ? 1 : 0);
+            }
+        }
+        std::cout << std::endl;
+    }
+    // Sources which deliver as fast as possible have no meaningful sample rate
+    const DriftEstimator & driftEstimator = m_source->getDriftEstimator();
+    if((m_portAudioControl || m_realTime) && driftEstimator.getMeasurementTime() >= DriftEstimator::minimumTime)
+    {
+        std::cout << "Measured sample rate: " << std::setprecision(3) << driftEstimator.getMeasuredSampleRate() << " Hz | Drift: "
+                  << std::setprecision(1) << driftEstimator.getDrift() << " ppm over " << driftEstimator.getMeasurementTime() << " s" << std::endl;
+    }
+    if(!m_historyFileName.empty())
+    {
+        if(m_entropyHistory.writeCsv(m_historyFileName))
+        {
+            std::cout << "History: " << m_entropyHistory.getNumberOfWindows() << " windows written to " << m_historyFileName << std::endl;
+        }
+        else
+        {
+            std::cout << "ERROR: Could not write the history to " << m_historyFileName << std::endl;
+        }
+    }
+    if(m_triggerEnabled)
+    {
+        std::cout << "Trigger events: " << m_eventTrigger.getNumberOfEvents() << std::endl;
+    }
+    if(m_missingCodesEnabled)
+    {
+        const MissingCodes::Result result = m_missingCodes.getResult();
+        std::cout << "Missing codes: " << result.m_missingCodes << " in [" << result.m_minimumValue << ", " << result.m_maximumValue << "]";
+        for(size_t i=0; i<result.m_firstMissingValues.size(); i++)
+        {
+            std::cout << (i == 0 ? " | First: " : ", ") << result.m_firstMissingValues[i];
+        }
+        if(result.m_missingCodes > result.m_firstMissingValues.size())
+        {
+            std::cout << ", ...";
+        }
+        std::cout << std::endl << "DNL (" << result.m_densityBits << " bit LSB): " << std::setprecision(3) << result.m_minimumDnl << " to " << result.m_maximumDnl
+                  << " | INL: " << result.m_minimumInl << " to " << result.m_maximumInl << std::endl;
+    }
+}
+
+void ConsoleRunner::printStreamStatistics(const StreamStatistics::Snapshot & statistics) const
+{
+    std::cout << std::setprecision(3);
+    std::cout << "Callbacks: " << statistics.m_numberOfCallbacks << " | Frames: " << statistics.m_numberOfFrames
+              << " | Input overflows: " << statistics.m_inputOverflows << " | Input underflows: " << statistics.m_inputUnderflows << std::endl;
+    std::cout << "Callback duration: min " << statistics.m_minimumDuration*1000.0 << " ms | mean " << statistics.m_meanDuration*1000.0
+              << " ms | max " << statistics.m_maximumDuration*1000.0 << " ms" << std::endl;
+    std::cout << "Callback jitter: mean " << statistics.m_meanJitter*1000.0 << " ms | max " << statistics.m_maximumJitter*1000.0 << " ms" << std::endl;
+    std::cout << "CPU load: " << statistics.m_cpuLoad*100.0 << " % | Queue: max " << statistics.m_maximumQueuedBlocks
+              << " of " << statistics.m_numberOfBlocks << " blocks" << std::endl;
+
+    // Only bins with entries, lower bound in milliseconds
+    std::cout << "Duration histogram (ms: count):";
+    for(int i=0; i<StreamStatistics::numberOfBins; i++)
+    {
+        if(statistics.m_durationHistogram[i] > 0)
+        {
+            std::cout << " " << StreamStatistics::getBinLowerBound(i)*1000.0 << ": " << statistics.m_durationHistogram[i];
+        }
+    }
+    std::cout << std::endl << "Jitter histogram (ms: count):";
+    for(int i=0; i<StreamStatistics::numberOfBins; i++)
+    {
+        if(statistics.m_jitterHistogram[i] > 0)
+        {
+            std::cout << " " << StreamStatistics::getBinLowerBound(i)*1000.0 << ": " << statistics.m_jitterHistogram[i];
+        }
+    }
+    std::cout << std::endl;
+}
+
+void ConsoleRunner::receiveSourceSamples(const AudioBlock & block)
+{
+    const std::vector<int32_t> & samples = block.m_samples;
+    // The receiver thread may already run when open() returns, so the analyzers are configured here
+    if(m_receivedBlocks == 0)
+    {
+        const int bitDepth = m_source->getBitDepth();
+        m_entropy.setNumberOfSymbols(bitDepth);
+        m_entropyProfile.setBitDepth(bitDepth);
+        m_predictionEntropy.setBitDepth(bitDepth);
+        m_losslessBitrate.setBitDepth(bitDepth);
+        m_multiResolutionEntropy.setBitDepth(bitDepth);
+        m_channelPairEntropy.setBitDepth(bitDepth);
+        m_bitDepthEstimator.setBitDepth(bitDepth);
+        m_peakMeter.updateBitdepth(bitDepth);
+        m_rmsMeter.updateBitdepth(bitDepth);
+        m_runningMoments.setBitDepth(bitDepth);
+        m_entropyHistory.start(m_source->getSampleRate());
+        if(m_triggerEnabled)
+        {
+            m_eventTrigger.start(bitDepth, m_source->getSampleRate(), m_blockSize);
+        }
+        if(m_missingCodesEnabled)
+        {
+            m_missingCodes.setBitDepth(bitDepth);
+        }
+    }
+
+    // The analyzers report their results synchronously, so they belong to this block
+    m_blockEndTime = block.m_adcTime + static_cast<double>(samples.size())/m_source->getSampleRate();
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    m_peakMeter.updateMeter(samples);
+    m_rmsMeter.updateMeter(samples);
+    // Before the entropy, which ends the window of the history
+    m_entropyHistory.addLevels(m_peakMeter.getBlockPeak(), m_rmsMeter.getBlockRms(), samples.size(), block.m_sampleIndex, block.m_adcTime);
+    m_runningMoments.addSamples(samples);
+    m_entropy.addSamples(samples);
+    m_entropyProfile.addSamples(samples);
+    m_predictionEntropy.addSamples(samples);
+    m_losslessBitrate.addSamples(samples);
+    m_multiResolutionEntropy.addSamples(samples);
+    if(!block.m_pairSamples.empty())
+    {
+        m_channelPairEntropy.addSamples(samples, block.m_pairSamples);
+    }
+    m_bitDepthEstimator.addSamples(samples);
+    if(m_triggerEnabled)
+    {
+        m_eventTrigger.addBlock(samples, m_peakMeter.isClipping(), m_rmsMeter.getBlockRms());
+    }
+    if(m_missingCodesEnabled)
+    {
+        m_missingCodes.addSamples(samples);
+    }
+    double blockTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    m_minimumBlockTime = (m_receivedBlocks == 0) ? blockTime : std::min(m_minimumBlockTime, blockTime);
+    m_maximumBlockTime = std::max(m_maximumBlockTime, blockTime);
+    m_totalBlockTime += blockTime;
+    ++m_receivedBlocks;
+    m_receivedSamples += samples.size();
+}
+
+void ConsoleRunner::receiveSupportedSampleRates(int deviceNumber, const std::vector<uint32_t> & sampleRates)
+{
+    (void) deviceNumber;
+    (void) sampleRates;
+}
+
+void ConsoleRunner::receiveProbingFinished(bool completed)
+{
+    (void) completed;
+}
+
+void ConsoleRunner::receiveEntropy(double entropy)
+{
+    m_entropyValue = entropy;
+    m_entropyTime = m_blockEndTime;
+    m_distinctSymbolsValue = m_entropy.getNumberOfDistinctSymbols();
+    m_entropyHistory.addEntropy(entropy);
+    if(m_triggerEnabled)
+    {
+        m_eventTrigger.addEntropy(entropy);
+    }
+}
+
+void ConsoleRunner::receiveEntropyProfile(const std::vector<double> & profile)
+{
+    m_entropyProfileValues = profile;
+}
+
+void ConsoleRunner::receivePredictionEntropy(const std::vector<double> & residualEntropy, double conditionalEntropy, int conditionalResolution)
+{
+    m_residualEntropyValues = residualEntropy;
+    m_conditionalEntropyValue = conditionalEntropy;
+    m_conditionalResolution = conditionalResolution;
+}
+
+void ConsoleRunner::receiveLosslessBitrate(double bitsPerSample, const char *predictor)
+{
+    m_losslessBitrateValue = bitsPerSample;
+    m_losslessPredictor = predictor;
+}
+
+void ConsoleRunner::receiveMultiResolutionEntropy(const std::vector<double> & entropies)
+{
+    m_multiResolutionEntropyValues = entropies;
+}
+
+void ConsoleRunner::receiveRunningMoments(const RunningMoments::Result & window, const RunningMoments::Result & total)
+{
+    // The total is read from the analyzer at the end, it includes the incomplete window
+    (void) total;
+    m_momentsWindow = window;
+}
+
+void ConsoleRunner::receiveChannelPairEntropy(double firstEntropy, double secondEntropy, double jointEntropy,
+                                              double mutualInformation, int resolution)
+{
+    m_pairFirstEntropy = firstEntropy;
+    m_pairSecondEntropy = secondEntropy;
+    m_pairJointEntropy = jointEntropy;
+    m_mutualInformation = mutualInformation;
+    m_pairResolution = resolution;
+}
+
+void ConsoleRunner::receivePeakHolderValue(double value)
+{
+    m_peakValue = std::max(m_peakValue, value);
+}
+
+void ConsoleRunner::receivePeakMeterValue(double value)
+{
+    (void) value;
+}
+
+void ConsoleRunner::receiveRmsHolderValue(double rms)
+{
+    m_rmsValue = std::max(m_rmsValue, rms);
+}
+
+void ConsoleRunner::receiveRmsMeterValue(double rms)
+{
+    (void) rms;
+}
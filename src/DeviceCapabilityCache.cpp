@@ -0,0 +1,193 @@
+/*
+ * DeviceCapabilityCache: On-disk cache of probed device capabilities
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DeviceCapabilityCache.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+// First line of the cache file, increment the version if the format changes
+static const std::string cacheFileHeader = "code-entropy-meter device cache 1";
+
+// Tabs and line breaks are used as separators in the cache file
+static std::string sanitize(const std::string & text)
+{
+    std::string result = text;
+    std::replace(result.begin(), result.end(), '\t', ' ');
+    std::replace(result.begin(), result.end(), '\n', ' ');
+    std::replace(result.begin(), result.end(), '\r', ' ');
+    return result;
+}
+
+DeviceCapabilityCache::DeviceCapabilityCache(const std::string & fileName)
+    : m_fileName(fileName)
+{
+}
+
+void DeviceCapabilityCache::setFileName(const std::string & fileName)
+{
+    m_fileName = fileName;
+}
+
+bool DeviceCapabilityCache::load()
+{
+    clear();
+
+    std::ifstream file(m_fileName);
+    if(!file)
+    {
+        return false;
+    }
+
+    std::string line;
+    if(!std::getline(file, line) || line != cacheFileHeader)
+    {
+        std::cout << "Ignoring device cache with unknown format" << std::endl;
+        return false;
+    }
+    std::getline(file, m_deviceSetSignature);
+
+    // One device per line: key <tab> comma separated sample rates
+    while(std::getline(file, line))
+    {
+        size_t separator = line.find('\t');
+        if(separator == std::string::npos)
+        {
+            continue;
+        }
+        std::vector<uint32_t> sampleRates;
+        std::stringstream stream(line.substr(separator+1));
+        std::string sampleRate;
+        while(std::getline(stream, sampleRate, ','))
+        {
+            if(!sampleRate.empty())
+            {
+                sampleRates.push_back(static_cast<uint32_t>(std::strtoul(sampleRate.c_str(), nullptr, 10)));
+            }
+        }
+        m_supportedSampleRates[line.substr(0, separator)] = sampleRates;
+    }
+
+    std::cout << "Device cache loaded:" << m_supportedSampleRates.size() << " devices" << std::endl;
+    return true;
+}
+
+bool DeviceCapabilityCache::save() const
+{
+    std::ofstream file(m_fileName, std::ios::trunc);
+    if(!file)
+    {
+        std::cout << "ERROR: Could not write device cache " << m_fileName << std::endl;
+        return false;
+    }
+
+    file << cacheFileHeader << "\n";
+    file << m_deviceSetSignature << "\n";
+    for(const auto& device : m_supportedSampleRates)
+    {
+        file << device.first << "\t";
+        for(size_t i=0; i<device.second.size(); i++)
+        {
+            file << (i > 0 ? "," : "") << device.second[i];
+        }
+        file << "\n";
+    }
+    return static_cast<bool>(file);
+}
+
+bool DeviceCapabilityCache::getSupportedSampleRates(const std::string & key, std::vector<uint32_t> & sampleRates) const
+{
+    auto device = m_supportedSampleRates.find(key);
+    if(device == m_supportedSampleRates.end())
+    {
+        return false;
+    }
+    sampleRates = device->second;
+    return true;
+}
+
+void DeviceCapabilityCache::setSupportedSampleRates(const std::string & key, const std::vector<uint32_t> & sampleRates)
+{
+    m_supportedSampleRates[key] = sampleRates;
+}
+
+const std::string & DeviceCapabilityCache::getDeviceSetSignature() const
+{
+    return m_deviceSetSignature;
+}
+
+void DeviceCapabilityCache::setDeviceSetSignature(const std::string & signature)
+{
+    m_deviceSetSignature = signature;
+}
+
+void DeviceCapabilityCache::removeOtherDevices(const std::vector<std::string> & keys)
+{
+    std::set<std::string> keySet(keys.begin(), keys.end());
+    for(auto device = m_supportedSampleRates.begin(); device != m_supportedSampleRates.end();)
+    {
+        if(keySet.count(device->first) == 0)
+        {
+            device = m_supportedSampleRates.erase(device);
+        }
+        else
+        {
+            ++device;
+        }
+    }
+}
+
+void DeviceCapabilityCache::clear()
+{
+    m_deviceSetSignature.clear();
+    m_supportedSampleRates.clear();
+}
+
+std::string DeviceCapabilityCache::createKey(const std::string & hostApiName, const std::string & deviceName)
+{
+    return sanitize(hostApiName) + "|" + sanitize(deviceName);
+}
+
+std::string DeviceCapabilityCache::createDeviceSetSignature(std::vector<std::string> keys)
+{
+    // Device order may change between runs, the set itself matters
+    std::sort(keys.begin(), keys.end());
+
+    // FNV-1a, stable across runs and platforms (unlike std::hash)
+    uint64_t hash = 14695981039346656037ULL;
+    for(const auto& key : keys)
+    {
+        for(const auto& character : key)
+        {
+            hash ^= static_cast<uint8_t>(character);
+            hash *= 1099511628211ULL;
+        }
+        hash ^= '\n';
+        hash *= 1099511628211ULL;
+    }
+
+    std::stringstream signature;
+    signature << keys.size() << "-" << std::hex << hash;
+    return signature.str();
+}
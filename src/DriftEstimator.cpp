@@ -0,0 +1,89 @@
+/*
+ * DriftEstimator: Measurement of the actual sample rate against the system clock
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DriftEstimator.hpp"
+
+constexpr double DriftEstimator::minimumTime;
+
+DriftEstimator::DriftEstimator()
+    : m_measuredSampleRate(0.0)
+    , m_measurementTime(0.0)
+{
+    reset(44100);
+}
+
+void DriftEstimator::reset(uint32_t nominalSampleRate)
+{
+    m_nominalSampleRate = nominalSampleRate;
+    m_firstIndex = 0;
+    m_firstTime = 0;
+    m_count = 0;
+    m_meanX = 0.0;
+    m_meanY = 0.0;
+    m_comomentXY = 0.0;
+    m_comomentXX = 0.0;
+    m_measuredSampleRate = 0.0;
+    m_measurementTime = 0.0;
+}
+
+void DriftEstimator::addBlock(uint64_t endIndex, int64_t systemTime)
+{
+    if(m_count == 0)
+    {
+        m_firstIndex = endIndex;
+        m_firstTime = systemTime;
+    }
+
+    // Welford's update, sums of squares of absolute values would lose all precision after a few minutes
+    const double x = static_cast<double>(systemTime - m_firstTime)*1.0e-9;
+    const double y = static_cast<double>(endIndex - m_firstIndex);
+    ++m_count;
+    const double dx = x - m_meanX;
+    m_meanX += dx/m_count;
+    m_meanY += (y - m_meanY)/m_count;
+    m_comomentXY += dx*(y - m_meanY);
+    m_comomentXX += dx*(x - m_meanX);
+
+    m_measurementTime = x;
+    if(x >= minimumTime && m_comomentXX > 0.0)
+    {
+        m_measuredSampleRate = m_comomentXY/m_comomentXX;
+    }
+}
+
+double DriftEstimator::getMeasuredSampleRate() const
+{
+    return m_measuredSampleRate;
+}
+
+double DriftEstimator::getDrift() const
+{
+    const double measuredSampleRate = m_measuredSampleRate;
+    if(measuredSampleRate <= 0.0 || m_nominalSampleRate == 0)
+    {
+        return 0.0;
+    }
+    return (measuredSampleRate/m_nominalSampleRate - 1.0)*1.0e6;
+}
+
+double DriftEstimator::getMeasurementTime() const
+{
+    return m_measurementTime;
+}
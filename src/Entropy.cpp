@@ -19,9 +19,19 @@
  */
 
 #include "Entropy.hpp"
+#include <algorithm>
 #include <cmath>
 
 const double LOG2 = log10(2);
+// The weights are normalized before they get large enough to lose precision
+const double maximumWeightIncrement = 1e12;
+// Weights below this (relative to a new sample) are dropped when normalizing
+const double minimumWeight = 1e-9;
+
+static double weightLog(double weight)
+{
+    return weight > 0.0 ? weight*std::log2(weight) : 0.0;
+}
 
 Entropy::Entropy(EntropyListener *listener)
     : m_entropyListener(listener)
@@ -32,6 +42,11 @@ Entropy::Entropy(EntropyListener *listener)
     , m_blockCounter(0)
     , m_numberOfBlocks(50)
     , m_blockSize(0)
+    , m_mode(Mode::Blocks)
+    , m_weightIncrement(1.0)
+    , m_totalWeight(0.0)
+    , m_weightLogSum(0.0)
+    , m_numberOfDistinctSymbols(0.0)
 {
 }
 
@@ -42,6 +57,12 @@ void Entropy::addSamples(const std::vector<int32_t> & signalValues)
         return;
     }
 
+    if(m_mode == Mode::Decaying)
+    {
+        addDecayingSamples(signalValues);
+        return;
+    }
+
     // Reset everything if its the first block
     if(m_blockCounter == 0)
     {
@@ -49,16 +70,32 @@ void Entropy::addSamples(const std::vector<int32_t> & signalValues)
     }
 
     // Count how often each symbol occurs
-    for(const auto& signalValue : signalValues)
+    if(m_mode == Mode::Approximate)
+    {
+        m_sketch.addSamples(signalValues);
+    }
+    else
     {
-        m_mapSymbolsToOccurrence[signalValue]++;
+        for(const auto& signalValue : signalValues)
+        {
+            m_mapSymbolsToOccurrence[signalValue]++;
+        }
     }
     ++m_blockCounter;
 
-    // Calculate entropy if all blocks have been processed
-    if(m_blockCounter == m_numberOfBlocks)
+    // Calculate entropy if all blocks have been processed (the number of blocks may have been reduced meanwhile)
+    if(m_blockCounter >= m_numberOfBlocks)
     {
-        calculateEntropy(static_cast<int>(signalValues.size()));
+        if(m_mode == Mode::Approximate)
+        {
+            m_entropy = m_sketch.getEntropy();
+            m_numberOfDistinctSymbols = m_sketch.getNumberOfDistinctSymbols();
+        }
+        else
+        {
+            calculateEntropy(static_cast<int>(signalValues.size()));
+            m_numberOfDistinctSymbols = static_cast<double>(m_mapSymbolsToOccurrence.size());
+        }
         m_entropyListener->receiveEntropy(m_entropy);
         m_blockCounter = 0;
     }
@@ -79,6 +116,65 @@ void Entropy::calculateEntropy(int blockSize)
     m_entropy = -m_entropy/LOG2;
 }
 
+void Entropy::addDecayingSamples(const std::vector<int32_t> & signalValues)
+{
+    if(signalValues.empty())
+    {
+        return;
+    }
+
+    // Relative to the new block every older block has lost a factor exp(-1/numberOfBlocks)
+    m_weightIncrement *= std::exp(1.0/std::max(1, m_numberOfBlocks));
+    if(m_weightIncrement > maximumWeightIncrement)
+    {
+        normalizeDecayingWeights();
+    }
+
+    // Sorted, so every symbol of the block is updated once
+    m_sortedSamples.assign(signalValues.begin(), signalValues.end());
+    std::sort(m_sortedSamples.begin(), m_sortedSamples.end());
+    size_t i = 0;
+    while(i < m_sortedSamples.size())
+    {
+        const int32_t symbol = m_sortedSamples[i];
+        size_t count = 0;
+        for(; i < m_sortedSamples.size() && m_sortedSamples[i] == symbol; i++)
+        {
+            ++count;
+        }
+        double & weight = m_decayingWeights[symbol];
+        const double added = count*m_weightIncrement;
+        m_weightLogSum += weightLog(weight + added) - weightLog(weight);
+        weight += added;
+        m_totalWeight += added;
+    }
+
+    m_entropy = std::max(0.0, std::log2(m_totalWeight) - m_weightLogSum/m_totalWeight);
+    m_numberOfDistinctSymbols = static_cast<double>(m_decayingWeights.size());
+    m_entropyListener->receiveEntropy(m_entropy);
+}
+
+void Entropy::normalizeDecayingWeights()
+{
+    // Also recalculates the sums, so rounding errors of the incremental updates don't accumulate
+    m_totalWeight = 0.0;
+    m_weightLogSum = 0.0;
+    for(auto symbolWeight = m_decayingWeights.begin(); symbolWeight != m_decayingWeights.end();)
+    {
+        const double weight = symbolWeight->second/m_weightIncrement;
+        if(weight < minimumWeight)
+        {
+            symbolWeight = m_decayingWeights.erase(symbolWeight);
+            continue;
+        }
+        symbolWeight->second = weight;
+        m_totalWeight += weight;
+        m_weightLogSum += weightLog(weight);
+        ++symbolWeight;
+    }
+    m_weightIncrement = 1.0;
+}
+
 void Entropy::setNumberOfBlocks(int numberOfBlocks)
 {
     m_numberOfBlocks = numberOfBlocks;
@@ -96,9 +192,45 @@ void Entropy::clear()
     m_entropy = 0.0;
     m_blockCounter = 0;
     m_mapSymbolsToOccurrence.clear();
+    m_decayingWeights.clear();
+    m_weightIncrement = 1.0;
+    m_totalWeight = 0.0;
+    m_weightLogSum = 0.0;
+    // The hash table of the sketch has about 1 MB
+    if(m_mode == Mode::Approximate)
+    {
+        m_sketch.clear();
+    }
 }
 
 void Entropy::reset()
 {
     clear();
 }
+
+void Entropy::setMode(Mode mode)
+{
+    m_mode = mode;
+    clear();
+}
+
+Entropy::Mode Entropy::getMode() const
+{
+    return m_mode;
+}
+
+void Entropy::setSketchSize(int numberOfCounters, size_t memorySize)
+{
+    m_sketch.setSize(numberOfCounters, memorySize);
+    clear();
+}
+
+const EntropySketch & Entropy::getSketch() const
+{
+    return m_sketch;
+}
+
+double Entropy::getNumberOfDistinctSymbols() const
+{
+    return m_numberOfDistinctSymbols;
+}
@@ -19,7 +19,9 @@
  */
 
 #include "EntropyDisplay.hpp"
+#include "MultiResolutionEntropy.hpp"
 
+#include <QCheckBox>
 #include <QLabel>
 #include <QSpinBox>
 #include <QLayout>
@@ -27,32 +29,55 @@
 #include <QPainter>
 
 const QColor colorFont(255,255,255);
+const QColor colorProfile(0,200,0);
+const QColor colorReference(110,110,110);
 
 EntropyDisplay::EntropyDisplay(QWidget *parent)
     : QWidget(parent)
 {
     m_labelEntropy = new QLabel(trUtf8("Entropy: 0.00000 bit"), this);
     m_labelEntropy->setFont(QFont("Sans", 20, QFont::Bold));
+    m_labelLossless = new QLabel(trUtf8("Lossless: -"), this);
+    m_labelLossless->setFont(QFont("Sans", 11, QFont::Bold));
     m_labelNumberOfBlocks = new QLabel(trUtf8("Number of blocks to process: "), this);
     m_boxNumberOfBlocks = new QSpinBox(this);
     m_boxNumberOfBlocks->setMinimum(1);
     m_boxNumberOfBlocks->setMaximum(10000);
     m_boxNumberOfBlocks->setValue(50);
+    m_boxDecaying = new QCheckBox(trUtf8("Decaying"), this);
+    m_boxDecaying->setToolTip(trUtf8("New value after every block, older blocks fade out with the number of blocks as time constant"));
     m_labelIntegrationTime = new QLabel(trUtf8("[Corresponds to 0 ms integration time]"), this);
+    m_labelPrediction = new QLabel(trUtf8("Residual entropy: -"), this);
+    m_labelMultiResolution = new QLabel(trUtf8("Entropy over 1 / 10 / 100 / 1000 blocks: -"), this);
+    m_labelChannelPair = new QLabel(trUtf8("Channel pair: -"), this);
+    m_labelMoments = new QLabel(trUtf8("DC offset: -"), this);
+    m_profileArea = new QWidget(this);
+    m_profileArea->setMinimumHeight(90);
 
     setStyleSheet("QLabel { color: " + colorFont.name() + "}");
 
+    QHBoxLayout *entropyLayout = new QHBoxLayout();
+    entropyLayout->addWidget(m_labelEntropy);
+    entropyLayout->addWidget(m_labelLossless, 0, Qt::AlignRight | Qt::AlignBottom);
+
     QHBoxLayout *mainHLayout = new QHBoxLayout();
     mainHLayout->addWidget(m_labelNumberOfBlocks);
     mainHLayout->addWidget(m_boxNumberOfBlocks);
+    mainHLayout->addWidget(m_boxDecaying);
     mainHLayout->setAlignment(Qt::AlignLeft);
 
     QVBoxLayout *mainLayout = new QVBoxLayout(this);
-    mainLayout->addWidget(m_labelEntropy);
+    mainLayout->addLayout(entropyLayout);
     mainLayout->addLayout(mainHLayout);
     mainLayout->addWidget(m_labelIntegrationTime);
+    mainLayout->addWidget(m_labelMultiResolution);
+    mainLayout->addWidget(m_labelPrediction);
+    mainLayout->addWidget(m_labelChannelPair);
+    mainLayout->addWidget(m_labelMoments);
+    mainLayout->addWidget(m_profileArea, 1);
 
     connect(m_boxNumberOfBlocks, SIGNAL(valueChanged(int)), this, SLOT(emitNumberOfBlocksChanged(int)));
+    connect(m_boxDecaying, SIGNAL(toggled(bool)), this, SLOT(emitDecayingChanged(bool)));
 }
 
 void EntropyDisplay::updateEntropy(double entropy)
@@ -62,7 +87,71 @@ void EntropyDisplay::updateEntropy(double entropy)
 
 void EntropyDisplay::updateIntegrationTimeLabel(double blockDuration)
 {
-    m_labelIntegrationTime->setText("[Corresponds to " + QString::number(blockDuration*m_boxNumberOfBlocks->value(),'f',2) + " ms integration time]");
+    const QString time = QString::number(blockDuration*m_boxNumberOfBlocks->value(),'f',2);
+    if(m_boxDecaying->isChecked())
+    {
+        m_labelIntegrationTime->setText("[Corresponds to " + time + " ms time constant]");
+        return;
+    }
+    m_labelIntegrationTime->setText("[Corresponds to " + time + " ms integration time]");
+}
+
+void EntropyDisplay::updateEntropyProfile(const std::vector<double> & profile)
+{
+    m_profile = profile;
+    update();
+}
+
+void EntropyDisplay::updatePredictionEntropy(const std::vector<double> & residualEntropy, double conditionalEntropy, int conditionalResolution)
+{
+    // Order 1 and 2 are the first and second difference
+    QString text = trUtf8("Residual entropy (order): ");
+    for(size_t i=0; i<residualEntropy.size(); i++)
+    {
+        text += QString::number(i+1) + ": " + QString::number(residualEntropy[i],'f',2) + "  ";
+    }
+    text += trUtf8("| Conditional (") + QString::number(conditionalResolution) + trUtf8(" bit): ") + QString::number(conditionalEntropy,'f',2) + " bit";
+    m_labelPrediction->setText(text);
+}
+
+void EntropyDisplay::updateLosslessBitrate(double bitsPerSample, QString predictor)
+{
+    m_labelLossless->setText("Lossless: " + QString::number(bitsPerSample,'f',2) + " bit/sample");
+    m_labelLossless->setToolTip(trUtf8("Estimated FLAC-like encoding, mostly ") + predictor);
+}
+
+void EntropyDisplay::updateMultiResolutionEntropy(const std::vector<double> & entropies)
+{
+    QString windows;
+    QString values;
+    for(size_t level=0; level<entropies.size(); level++)
+    {
+        const QString separator = level > 0 ? " / " : "";
+        windows += separator + QString::number(MultiResolutionEntropy::getNumberOfBlocks(static_cast<int>(level)));
+        values += separator + (entropies[level] < 0.0 ? QString("-") : QString::number(entropies[level],'f',3));
+    }
+    m_labelMultiResolution->setText(trUtf8("Entropy over ") + windows + trUtf8(" blocks: ") + values + " bit");
+}
+
+void EntropyDisplay::updateChannelPairEntropy(double firstEntropy, double secondEntropy, double jointEntropy, double mutualInformation, int resolution)
+{
+    m_labelChannelPair->setText(trUtf8("Channel pair (") + QString::number(resolution) + trUtf8(" bit): ")
+                                + QString::number(firstEntropy,'f',2) + " / " + QString::number(secondEntropy,'f',2)
+                                + trUtf8(" bit | Joint: ") + QString::number(jointEntropy,'f',2)
+                                + trUtf8(" bit | Mutual information: ") + QString::number(mutualInformation,'f',2) + " bit");
+}
+
+void EntropyDisplay::updateRunningMoments(RunningMoments::Result window, RunningMoments::Result total)
+{
+    m_labelMoments->setText(trUtf8("DC offset: ") + QString::number(window.m_dcOffset,'f',2) + " LSB ("
+                            + QString::number(window.m_dcOffsetDb,'f',1) + trUtf8(" dBFS) | AC RMS: ")
+                            + QString::number(window.m_acRmsDb,'f',2) + trUtf8(" dBFS | Skew: ") + QString::number(window.m_skewness,'f',3)
+                            + trUtf8(" | Kurt: ") + QString::number(window.m_kurtosis,'f',3));
+    m_labelMoments->setToolTip(trUtf8("Since the start (") + QString::number(total.m_numberOfSamples) + trUtf8(" samples): DC offset ")
+                               + QString::number(total.m_dcOffset,'f',3) + " LSB (" + QString::number(total.m_dcOffsetDb,'f',1)
+                               + trUtf8(" dBFS), AC RMS ") + QString::number(total.m_acRms,'f',2) + " LSB ("
+                               + QString::number(total.m_acRmsDb,'f',2) + trUtf8(" dBFS), skewness ") + QString::number(total.m_skewness,'f',3)
+                               + trUtf8(", kurtosis ") + QString::number(total.m_kurtosis,'f',3) + trUtf8(" (Gaussian: 3)"));
 }
 
 void EntropyDisplay::emitNumberOfBlocksChanged(int value)
@@ -70,17 +159,55 @@ void EntropyDisplay::emitNumberOfBlocksChanged(int value)
     emit signalNumberOfBlocksChanged(value);
 }
 
+void EntropyDisplay::emitDecayingChanged(bool decaying)
+{
+    emit signalDecayingChanged(decaying);
+}
+
 quint32 EntropyDisplay::getNumberOfBlocks()
 {
     return m_boxNumberOfBlocks->value();
 }
 
+bool EntropyDisplay::isDecaying()
+{
+    return m_boxDecaying->isChecked();
+}
+
 void EntropyDisplay::paintEvent(QPaintEvent *)
 {
     QStyleOption opt;
     opt.init(this);
     QPainter p(this);
     style()->drawPrimitive(QStyle::PE_Widget, &opt, &p, this);
+
+    if(m_profile.size() < 2)
+    {
+        return;
+    }
+
+    // x: kept bits (1 ... bit depth), y: entropy (0 ... bit depth bit)
+    const int titleHeight = p.fontMetrics().height();
+    const QRect area = m_profileArea->geometry();
+    const QRect plot(area.left(), area.top()+titleHeight, area.width(), area.height()-titleHeight);
+    const int bitDepth = static_cast<int>(m_profile.size());
+    const double stepX = static_cast<double>(plot.width())/(bitDepth-1);
+    const double scaleY = static_cast<double>(plot.height())/bitDepth;
+    p.setPen(colorFont);
+    p.drawText(area.left(), area.top(), area.width(), titleHeight, Qt::AlignLeft, trUtf8("Entropy per bit depth (1 - ") + QString::number(bitDepth) + " bit)");
+
+    // A bit which carries information adds one bit of entropy, so the reference is the diagonal
+    p.setPen(colorReference);
+    p.drawRect(plot);
+    p.drawLine(plot.left(), static_cast<int>(plot.bottom()-scaleY), plot.right(), plot.top());
+
+    QPolygonF curve;
+    for(int i=0; i<bitDepth; i++)
+    {
+        curve << QPointF(plot.left()+i*stepX, plot.bottom()-m_profile[i]*scaleY);
+    }
+    p.setPen(QPen(colorProfile, 2));
+    p.drawPolyline(curve);
 }
 
 void EntropyDisplay::disableUI(bool disable)
@@ -0,0 +1,253 @@
+/*
+ * EntropyHistory: Entropy, peak and RMS of every window with decimated levels for long sessions
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EntropyHistory.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+
+const double INF = -999.0;
+
+// Power of a level in dB, -999 dB (no signal) becomes 0
+static double toPower(double level)
+{
+    return level > INF ? std::pow(10.0, level/10.0) : 0.0;
+}
+
+static double toLevel(double power)
+{
+    return power > 0.0 ? 10.0*std::log10(power) : INF;
+}
+
+EntropyHistory::EntropyHistory()
+    : m_levels(numberOfLevels)
+    , m_sampleRate(44100)
+    , m_numberOfSamples(0)
+    , m_numberOfBlocks(50)
+    , m_blockCounter(0)
+    , m_windowStartSample(0)
+    , m_windowSamples(0)
+    , m_windowPeak(INF)
+    , m_windowPower(0.0)
+    , m_windowEntropySum(0.0)
+    , m_windowEntropyCount(0)
+    , m_windowEndSampleIndex(0)
+    , m_windowEndAdcTime(0.0)
+{
+    for(auto& level : m_levels)
+    {
+        level.m_records.resize(levelCapacity);
+    }
+    start(m_sampleRate);
+}
+
+void EntropyHistory::start(uint32_t sampleRate)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_sampleRate = sampleRate;
+    }
+    clear();
+}
+
+void EntropyHistory::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_numberOfSamples = 0;
+    m_blockCounter = 0;
+    m_windowStartSample = 0;
+    m_windowSamples = 0;
+    m_windowPeak = INF;
+    m_windowPower = 0.0;
+    m_windowEntropySum = 0.0;
+    m_windowEntropyCount = 0;
+    for(auto& level : m_levels)
+    {
+        level.m_count = 0;
+        level.m_pendingCount = 0;
+    }
+}
+
+void EntropyHistory::setNumberOfBlocks(int numberOfBlocks)
+{
+    // The levels of the incomplete window are kept, so the records have no gaps
+    m_numberOfBlocks = numberOfBlocks;
+    m_blockCounter = 0;
+}
+
+void EntropyHistory::addLevels(double peak, double rms, size_t numberOfSamples, uint64_t sampleIndex, double adcTime)
+{
+    // Only used by the analysis thread
+    ++m_blockCounter;
+    m_windowPeak = std::max(m_windowPeak, peak);
+    m_windowPower += toPower(rms)*numberOfSamples;
+    m_windowSamples += numberOfSamples;
+    m_numberOfSamples += numberOfSamples;
+    m_windowEndSampleIndex = sampleIndex + numberOfSamples;
+    m_windowEndAdcTime = adcTime + static_cast<double>(numberOfSamples)/m_sampleRate;
+}
+
+void EntropyHistory::addEntropy(double entropy)
+{
+    m_windowEntropySum += entropy;
+    ++m_windowEntropyCount;
+    // Decaying entropy is reported after every block, but a record is still one window
+    if(m_blockCounter < m_numberOfBlocks)
+    {
+        return;
+    }
+
+    Record record;
+    record.m_startTime = static_cast<double>(m_windowStartSample)/m_sampleRate;
+    record.m_endTime = static_cast<double>(m_numberOfSamples)/m_sampleRate;
+    record.m_numberOfWindows = 1;
+    record.m_entropy = m_windowEntropySum/m_windowEntropyCount;
+    record.m_peak = m_windowPeak;
+    record.m_rms = m_windowSamples > 0 ? toLevel(m_windowPower/m_windowSamples) : INF;
+    record.m_endSampleIndex = m_windowEndSampleIndex;
+    record.m_endAdcTime = m_windowEndAdcTime;
+
+    m_blockCounter = 0;
+    m_windowStartSample = m_numberOfSamples;
+    m_windowSamples = 0;
+    m_windowPeak = INF;
+    m_windowPower = 0.0;
+    m_windowEntropySum = 0.0;
+    m_windowEntropyCount = 0;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    pushRecord(0, record);
+}
+
+void EntropyHistory::getRecords(std::vector<Record> & records) const
+{
+    records.clear();
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // The finest level whose ring still holds the first record, the top level drops the oldest ones
+    int levelIndex = 0;
+    while(levelIndex < numberOfLevels-1 && m_levels[levelIndex].m_count > levelCapacity)
+    {
+        ++levelIndex;
+    }
+    const Level & level = m_levels[levelIndex];
+    const uint64_t first = level.m_count > levelCapacity ? level.m_count - levelCapacity : 0;
+    for(uint64_t index=first; index<level.m_count; index++)
+    {
+        records.push_back(level.m_records[index % levelCapacity]);
+    }
+    // The newer records haven't been combined into this level yet, they are pending in the levels up to this one
+    for(int pendingLevel=levelIndex; pendingLevel>0; pendingLevel--)
+    {
+        if(m_levels[pendingLevel].m_pendingCount > 0)
+        {
+            records.push_back(m_levels[pendingLevel].m_pending);
+        }
+    }
+}
+
+uint64_t EntropyHistory::getNumberOfWindows() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_levels[0].m_count;
+}
+
+bool EntropyHistory::writeCsv(const std::string & fileName) const
+{
+    std::ofstream file(fileName);
+    if(!file)
+    {
+        return false;
+    }
+    file << "start_s,end_s,windows,entropy_bit,peak_dBFS,rms_dBFS,end_sample,end_adc_s\n" << std::fixed;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // From the coarsest level to the finest: a coarse record is only written if it begins before the oldest record
+    // which the next finer level still holds, finer records only after the last written one
+    double writtenUntil = 0.0;
+    for(int levelIndex=numberOfLevels-1; levelIndex>=0; levelIndex--)
+    {
+        const Level & level = m_levels[levelIndex];
+        double finerBegin = 0.0;
+        if(levelIndex > 0)
+        {
+            const Level & finer = m_levels[levelIndex-1];
+            const uint64_t finerFirst = finer.m_count > levelCapacity ? finer.m_count - levelCapacity : 0;
+            finerBegin = finer.m_count > 0 ? finer.m_records[finerFirst % levelCapacity].m_startTime : 0.0;
+        }
+        const uint64_t first = level.m_count > levelCapacity ? level.m_count - levelCapacity : 0;
+        for(uint64_t index=first; index<level.m_count; index++)
+        {
+            const Record & record = level.m_records[index % levelCapacity];
+            if(record.m_startTime < writtenUntil || (levelIndex > 0 && record.m_startTime >= finerBegin))
+            {
+                continue;
+            }
+            file << std::setprecision(3) << record.m_startTime << ',' << record.m_endTime << ',' << record.m_numberOfWindows << ','
+                 << std::setprecision(5) << record.m_entropy << ',' << std::setprecision(2) << record.m_peak << ',' << record.m_rms << ','
+                 << record.m_endSampleIndex << ',' << std::setprecision(6) << record.m_endAdcTime << '\n';
+            writtenUntil = record.m_endTime;
+        }
+    }
+    return static_cast<bool>(file);
+}
+
+void EntropyHistory::pushRecord(int levelIndex, const Record & record)
+{
+    Level & level = m_levels[levelIndex];
+    level.m_records[level.m_count % levelCapacity] = record;
+    ++level.m_count;
+
+    if(levelIndex+1 >= numberOfLevels)
+    {
+        return;
+    }
+    Level & next = m_levels[levelIndex+1];
+    if(next.m_pendingCount == 0)
+    {
+        next.m_pending = record;
+    }
+    else
+    {
+        mergeRecord(next.m_pending, record);
+    }
+    if(++next.m_pendingCount == levelFactor)
+    {
+        const Record combined = next.m_pending;
+        next.m_pendingCount = 0;
+        pushRecord(levelIndex+1, combined);
+    }
+}
+
+void EntropyHistory::mergeRecord(Record & record, const Record & other)
+{
+    const double duration = record.m_endTime - record.m_startTime;
+    const double otherDuration = other.m_endTime - other.m_startTime;
+    const double weight = duration + otherDuration > 0.0 ? otherDuration/(duration + otherDuration) : 0.5;
+    record.m_entropy += (other.m_entropy - record.m_entropy)*weight;
+    record.m_rms = toLevel(toPower(record.m_rms)*(1.0-weight) + toPower(other.m_rms)*weight);
+    record.m_peak = std::max(record.m_peak, other.m_peak);
+    record.m_endTime = other.m_endTime;
+    record.m_endSampleIndex = other.m_endSampleIndex;
+    record.m_endAdcTime = other.m_endAdcTime;
+    record.m_numberOfWindows += other.m_numberOfWindows;
+}
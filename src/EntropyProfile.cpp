@@ -0,0 +1,63 @@
+/*
+ * EntropyProfile: Entropy for every bit depth from 1 bit up to the stream's bit depth
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EntropyProfile.hpp"
+
+EntropyProfile::EntropyProfile(EntropyProfileListener *listener)
+    : m_entropyProfileListener(listener)
+    , m_blockCounter(0)
+    , m_numberOfBlocks(50)
+{
+}
+
+void EntropyProfile::addSamples(const std::vector<int32_t> & signalValues)
+{
+    if(!m_entropyProfileListener)
+    {
+        return;
+    }
+
+    m_histogram.addSamples(signalValues);
+    ++m_blockCounter;
+
+    if(m_blockCounter >= m_numberOfBlocks)
+    {
+        m_histogram.getEntropyProfile(m_profile);
+        m_entropyProfileListener->receiveEntropyProfile(m_profile);
+        clear();
+    }
+}
+
+void EntropyProfile::setNumberOfBlocks(int numberOfBlocks)
+{
+    m_numberOfBlocks = numberOfBlocks;
+}
+
+void EntropyProfile::setBitDepth(int bitDepth)
+{
+    m_histogram.setBitDepth(bitDepth);
+    m_blockCounter = 0;
+}
+
+void EntropyProfile::clear()
+{
+    m_histogram.clear();
+    m_blockCounter = 0;
+}
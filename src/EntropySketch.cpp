@@ -0,0 +1,232 @@
+/*
+ * EntropySketch: Fixed-memory estimates of the entropy and the number of distinct symbols
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EntropySketch.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+static const double PI = 3.14159265358979323846;
+
+// splitmix64 finalizer, every output bit depends on every input bit
+static uint64_t mix(uint64_t value)
+{
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30))*0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27))*0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+// Maximally skewed 1-stable value from 64 random bits (Chambers-Mallows-Stuck), scaled so that E[exp(t*R)] = t^t
+static double stableValue(uint64_t random)
+{
+    const double u = (static_cast<double>(random >> 32) + 0.5)/4294967296.0;
+    const double v = (static_cast<double>(random & 0xFFFFFFFFULL) + 0.5)/4294967296.0;
+    const double angle = PI*(u - 0.5);
+    const double exponential = -std::log(v);
+    const double cosine = std::cos(angle);
+    const double remaining = PI/2.0 - angle;
+    return remaining*std::sin(angle)/cosine + std::log(exponential*cosine/remaining);
+}
+
+EntropySketch::EntropySketch()
+    : m_tableBits(0)
+    , m_numberOfUsedSlots(0)
+    , m_numberOfSamples(0)
+    , m_pendingSamples(0)
+{
+    setSize(256, 1 << 20);
+}
+
+void EntropySketch::setSize(int numberOfCounters, size_t memorySize)
+{
+    m_counters.assign(static_cast<size_t>(std::max(1, numberOfCounters)), 0.0);
+    m_registers.assign(static_cast<size_t>(1) << precision, 0);
+    // The remaining memory is used for the largest power of two of slots, at least 2^12
+    const size_t sketchSize = m_counters.size()*sizeof(double) + m_registers.size();
+    const size_t tableSize = memorySize > sketchSize ? memorySize - sketchSize : 0;
+    m_tableBits = 12;
+    while((static_cast<size_t>(2) << m_tableBits)*sizeof(Slot) <= tableSize && m_tableBits < 30)
+    {
+        ++m_tableBits;
+    }
+    m_slots.assign(static_cast<size_t>(1) << m_tableBits, Slot{0, 0});
+    m_numberOfUsedSlots = 0;
+    m_numberOfSamples = 0;
+    m_pendingSamples = 0;
+}
+
+int EntropySketch::getNumberOfCounters() const
+{
+    return static_cast<int>(m_counters.size());
+}
+
+size_t EntropySketch::getMemorySize() const
+{
+    return m_counters.size()*sizeof(double) + m_registers.size() + m_slots.size()*sizeof(Slot);
+}
+
+void EntropySketch::addSamples(const std::vector<int32_t> & samples)
+{
+    // The counts of the table must not overflow
+    if(m_pendingSamples + samples.size() > 0xFFFFFFFFULL)
+    {
+        flush();
+    }
+
+    const size_t indexMask = m_slots.size() - 1;
+    for(const auto& sample : samples)
+    {
+        // At most half of the slots are used, so the probe sequences stay short
+        if(2*(m_numberOfUsedSlots + 1) > m_slots.size())
+        {
+            flush();
+        }
+        size_t index = static_cast<size_t>((static_cast<uint32_t>(sample)*0x9E3779B97F4A7C15ULL) >> (64 - m_tableBits));
+        while(m_slots[index].m_count != 0 && m_slots[index].m_symbol != sample)
+        {
+            index = (index + 1) & indexMask;
+        }
+        if(m_slots[index].m_count == 0)
+        {
+            m_slots[index].m_symbol = sample;
+            ++m_numberOfUsedSlots;
+        }
+        ++m_slots[index].m_count;
+    }
+    m_numberOfSamples += samples.size();
+    m_pendingSamples += samples.size();
+}
+
+void EntropySketch::flush()
+{
+    if(m_numberOfUsedSlots > 0)
+    {
+        for(auto& slot : m_slots)
+        {
+            if(slot.m_count != 0)
+            {
+                addSymbol(slot.m_symbol, slot.m_count);
+                slot.m_count = 0;
+            }
+        }
+    }
+    m_numberOfUsedSlots = 0;
+    m_pendingSamples = 0;
+}
+
+void EntropySketch::addSymbol(int32_t symbol, uint32_t count)
+{
+    // HyperLogLog: the register is selected by the upper bits, the rank is the position of the first set bit after them
+    const uint64_t hash = mix(static_cast<uint32_t>(symbol));
+    const size_t index = static_cast<size_t>(hash >> (64 - precision));
+    const int maximumRank = 64 - precision + 1;
+    uint64_t remaining = hash << precision;
+    int rank = 1;
+    while(rank < maximumRank && !(remaining & 0x8000000000000000ULL))
+    {
+        remaining <<= 1;
+        ++rank;
+    }
+    m_registers[index] = static_cast<uint8_t>(std::max<int>(m_registers[index], rank));
+
+    // Stable sketch: independent random values for every counter
+    const uint64_t seed = mix(hash);
+    const double weight = static_cast<double>(count);
+    const size_t numberOfCounters = m_counters.size();
+    for(size_t j=0; j<numberOfCounters; j++)
+    {
+        m_counters[j] += weight*stableValue(mix(seed + j));
+    }
+}
+
+void EntropySketch::clear()
+{
+    std::fill(m_counters.begin(), m_counters.end(), 0.0);
+    std::fill(m_registers.begin(), m_registers.end(), 0);
+    std::fill(m_slots.begin(), m_slots.end(), Slot{0, 0});
+    m_numberOfUsedSlots = 0;
+    m_numberOfSamples = 0;
+    m_pendingSamples = 0;
+}
+
+uint64_t EntropySketch::getNumberOfSamples() const
+{
+    return m_numberOfSamples;
+}
+
+double EntropySketch::getEntropy()
+{
+    if(m_numberOfSamples == 0)
+    {
+        return 0.0;
+    }
+    flush();
+
+    // H = -ln(mean(exp(counter/N))), the largest term is factored out so nothing overflows
+    const double numberOfSamples = static_cast<double>(m_numberOfSamples);
+    double maximum = m_counters[0]/numberOfSamples;
+    for(const auto& counter : m_counters)
+    {
+        maximum = std::max(maximum, counter/numberOfSamples);
+    }
+    double sum = 0.0;
+    for(const auto& counter : m_counters)
+    {
+        sum += std::exp(counter/numberOfSamples - maximum);
+    }
+    const double entropy = -(maximum + std::log(sum/static_cast<double>(m_counters.size())));
+    return std::max(0.0, entropy/std::log(2.0));
+}
+
+double EntropySketch::getEntropyError() const
+{
+    return std::sqrt(3.0/static_cast<double>(m_counters.size()))/std::log(2.0);
+}
+
+double EntropySketch::getNumberOfDistinctSymbols()
+{
+    flush();
+    const double numberOfRegisters = static_cast<double>(m_registers.size());
+    double sum = 0.0;
+    size_t zeroRegisters = 0;
+    for(const auto& value : m_registers)
+    {
+        sum += std::ldexp(1.0, -value);
+        if(value == 0)
+        {
+            ++zeroRegisters;
+        }
+    }
+    const double alpha = (m_registers.size() >= 128) ? 0.7213/(1.0 + 1.079/numberOfRegisters)
+                                                     : (m_registers.size() >= 64 ? 0.709 : (m_registers.size() >= 32 ? 0.697 : 0.673));
+    const double estimate = alpha*numberOfRegisters*numberOfRegisters/sum;
+    // Linear counting is more accurate while many registers are empty
+    if(estimate <= 2.5*numberOfRegisters && zeroRegisters > 0)
+    {
+        return numberOfRegisters*std::log(numberOfRegisters/static_cast<double>(zeroRegisters));
+    }
+    return estimate;
+}
+
+double EntropySketch::getDistinctSymbolsError() const
+{
+    return 1.04/std::sqrt(static_cast<double>(m_registers.size()));
+}
@@ -0,0 +1,313 @@
+/*
+ * EventTrigger: Writes the samples around analyzer events to WAV files
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EventTrigger.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+
+// WAV header fields are little endian
+static void writeUInt32(std::ofstream & file, uint32_t value)
+{
+    const char bytes[4] = {static_cast<char>(value & 0xFF), static_cast<char>((value >> 8) & 0xFF),
+                           static_cast<char>((value >> 16) & 0xFF), static_cast<char>((value >> 24) & 0xFF)};
+    file.write(bytes, 4);
+}
+
+static void writeUInt16(std::ofstream & file, uint16_t value)
+{
+    const char bytes[2] = {static_cast<char>(value & 0xFF), static_cast<char>((value >> 8) & 0xFF)};
+    file.write(bytes, 2);
+}
+
+EventTrigger::EventTrigger(EventTriggerListener *listener)
+    : m_triggerListener(listener)
+    , m_settingsChanged(false)
+    , m_bitDepth(16)
+    , m_sampleRate(44100)
+    , m_blockIndex(0)
+    , m_previousBits(0)
+    , m_previousRms(0.0)
+    , m_previousEntropy(0.0)
+    , m_firstBlock(true)
+    , m_eventPending(false)
+    , m_triggerIndex(0)
+    , m_writerRunning(true)
+    , m_numberOfEvents(0)
+{
+    m_settings.m_clip = false;
+    m_settings.m_entropyDrop = false;
+    m_settings.m_entropyThreshold = 8.0;
+    m_settings.m_rmsStep = false;
+    m_settings.m_rmsStepSize = 20.0;
+    m_settings.m_bitChange = false;
+    m_settings.m_preTriggerTime = 5.0;
+    m_settings.m_postTriggerTime = 5.0;
+    m_settings.m_fileNamePrefix = "event";
+    m_newSettings = m_settings;
+
+    m_writerThread = std::thread(&EventTrigger::runWriterThread, this);
+}
+
+EventTrigger::~EventTrigger()
+{
+    // Events which are already queued are still written
+    {
+        std::lock_guard<std::mutex> lock(m_eventMutex);
+        m_writerRunning = false;
+    }
+    m_eventCondition.notify_one();
+    m_writerThread.join();
+}
+
+void EventTrigger::setSettings(const Settings & settings)
+{
+    std::lock_guard<std::mutex> lock(m_settingsMutex);
+    m_newSettings = settings;
+    m_settingsChanged = true;
+}
+
+EventTrigger::Settings EventTrigger::getSettings() const
+{
+    std::lock_guard<std::mutex> lock(m_settingsMutex);
+    return m_newSettings;
+}
+
+void EventTrigger::start(int bitDepth, uint32_t sampleRate, uint32_t blockSize)
+{
+    applySettings();
+    m_bitDepth = bitDepth;
+    m_sampleRate = sampleRate;
+
+    // The whole pre- and post-trigger window must still be available when the last block after the trigger arrives
+    const double windowTime = std::max(0.0, m_settings.m_preTriggerTime) + std::max(0.0, m_settings.m_postTriggerTime);
+    m_history.resize(static_cast<size_t>(std::ceil(windowTime*sampleRate)) + blockSize);
+
+    m_blockIndex = 0;
+    m_firstBlock = true;
+    m_eventPending = false;
+}
+
+void EventTrigger::stop()
+{
+    if(m_eventPending)
+    {
+        finishEvent();
+    }
+}
+
+void EventTrigger::addBlock(const std::vector<int32_t> & samples, bool clipping, double rms)
+{
+    if(m_settingsChanged)
+    {
+        applySettings();
+    }
+
+    m_blockIndex = m_history.getEndIndex();
+    m_history.addSamples(samples);
+
+    // Same as the "Block" mode of BitDisplay: all bits which are set in at least one sample
+    const uint32_t bitMask = static_cast<uint32_t>((1ULL << m_bitDepth) - 1);
+    uint32_t bits = 0;
+    for(const auto& sample : samples)
+    {
+        bits |= static_cast<uint32_t>(sample);
+    }
+    bits &= bitMask;
+
+    if(m_settings.m_clip && clipping)
+    {
+        fire("clip");
+    }
+    if(!m_firstBlock)
+    {
+        if(m_settings.m_rmsStep && std::abs(rms - m_previousRms) >= m_settings.m_rmsStepSize)
+        {
+            fire("rms");
+        }
+        if(m_settings.m_bitChange && bits != m_previousBits)
+        {
+            fire("bits");
+        }
+    }
+    m_previousBits = bits;
+    m_previousRms = rms;
+    m_firstBlock = false;
+
+    const uint64_t postTriggerSamples = static_cast<uint64_t>(std::max(0.0, m_settings.m_postTriggerTime)*m_sampleRate);
+    if(m_eventPending && m_history.getEndIndex() >= m_triggerIndex + postTriggerSamples)
+    {
+        finishEvent();
+    }
+}
+
+void EventTrigger::addEntropy(double entropy)
+{
+    if(m_settingsChanged)
+    {
+        applySettings();
+    }
+
+    // Only the transition below the threshold is an event
+    if(m_settings.m_entropyDrop && entropy < m_settings.m_entropyThreshold && m_previousEntropy >= m_settings.m_entropyThreshold)
+    {
+        fire("entropy");
+    }
+    m_previousEntropy = entropy;
+}
+
+uint64_t EventTrigger::getNumberOfEvents() const
+{
+    return m_numberOfEvents;
+}
+
+void EventTrigger::applySettings()
+{
+    std::lock_guard<std::mutex> lock(m_settingsMutex);
+    // The size of the history buffer is only changed by start()
+    const double preTriggerTime = m_settings.m_preTriggerTime;
+    const double postTriggerTime = m_settings.m_postTriggerTime;
+    m_settings = m_newSettings;
+    if(m_history.getCapacity() > 0)
+    {
+        m_settings.m_preTriggerTime = preTriggerTime;
+        m_settings.m_postTriggerTime = postTriggerTime;
+    }
+    m_settingsChanged = false;
+}
+
+void EventTrigger::fire(const std::string & reason)
+{
+    if(m_eventPending)
+    {
+        return;
+    }
+    m_eventPending = true;
+    m_triggerIndex = m_blockIndex;
+    m_triggerReason = reason;
+}
+
+void EventTrigger::finishEvent()
+{
+    m_eventPending = false;
+
+    const uint64_t preTriggerSamples = static_cast<uint64_t>(std::max(0.0, m_settings.m_preTriggerTime)*m_sampleRate);
+    const uint64_t postTriggerSamples = static_cast<uint64_t>(std::max(0.0, m_settings.m_postTriggerTime)*m_sampleRate);
+    // Less history is available shortly after the start
+    const uint64_t first = std::max(m_history.getBeginIndex(), m_triggerIndex > preTriggerSamples ? m_triggerIndex - preTriggerSamples : 0);
+    const uint64_t last = std::min(m_history.getEndIndex(), m_triggerIndex + postTriggerSamples);
+
+    Event event;
+    if(!m_history.copySamples(first, static_cast<size_t>(last - first), event.m_samples))
+    {
+        return;
+    }
+    event.m_number = ++m_numberOfEvents;
+    event.m_reason = m_triggerReason;
+    event.m_fileNamePrefix = m_settings.m_fileNamePrefix;
+    event.m_bitDepth = m_bitDepth;
+    event.m_sampleRate = m_sampleRate;
+
+    {
+        std::lock_guard<std::mutex> lock(m_eventMutex);
+        m_events.push_back(std::move(event));
+    }
+    m_eventCondition.notify_one();
+}
+
+void EventTrigger::runWriterThread()
+{
+    std::unique_lock<std::mutex> lock(m_eventMutex);
+    while(true)
+    {
+        m_eventCondition.wait(lock, [this] { return !m_events.empty() || !m_writerRunning; });
+        if(m_events.empty())
+        {
+            break;
+        }
+        Event event = std::move(m_events.front());
+        m_events.pop_front();
+        lock.unlock();
+
+        // e.g. "event-20140612-153012-3-clip.wav"
+        char time[32];
+        std::time_t now = std::time(nullptr);
+        std::strftime(time, sizeof(time), "%Y%m%d-%H%M%S", std::localtime(&now));
+        std::string fileName = event.m_fileNamePrefix + "-" + time + "-" + std::to_string(event.m_number) + "-" + event.m_reason + ".wav";
+
+        if(writeWaveFile(fileName, event.m_samples, event.m_bitDepth, event.m_sampleRate))
+        {
+            std::cout << "Trigger event (" << event.m_reason << ") written to " << fileName << std::endl;
+        }
+        else
+        {
+            std::cout << "ERROR: Could not write trigger event to " << fileName << std::endl;
+            fileName.clear();
+        }
+        if(m_triggerListener)
+        {
+            m_triggerListener->receiveTriggerEvent(event.m_reason, fileName);
+        }
+
+        lock.lock();
+    }
+}
+
+bool EventTrigger::writeWaveFile(const std::string & fileName, const std::vector<int32_t> & samples, int bitDepth, uint32_t sampleRate)
+{
+    std::ofstream file(fileName, std::ios::binary);
+    if(!file)
+    {
+        return false;
+    }
+
+    const uint16_t bytesPerSample = static_cast<uint16_t>(bitDepth/8);
+    const uint32_t dataSize = static_cast<uint32_t>(samples.size()*bytesPerSample);
+    file.write("RIFF", 4);
+    writeUInt32(file, 36 + dataSize);
+    file.write("WAVE", 4);
+    file.write("fmt ", 4);
+    writeUInt32(file, 16);
+    // PCM, mono
+    writeUInt16(file, 1);
+    writeUInt16(file, 1);
+    writeUInt32(file, sampleRate);
+    writeUInt32(file, sampleRate*bytesPerSample);
+    writeUInt16(file, bytesPerSample);
+    writeUInt16(file, static_cast<uint16_t>(bitDepth));
+    file.write("data", 4);
+    writeUInt32(file, dataSize);
+
+    std::vector<char> data(dataSize);
+    for(size_t i=0; i<samples.size(); i++)
+    {
+        // 8 bit WAV samples are unsigned
+        const uint32_t value = static_cast<uint32_t>(bitDepth == 8 ? samples[i] + 128 : samples[i]);
+        for(uint16_t j=0; j<bytesPerSample; j++)
+        {
+            data[i*bytesPerSample+j] = static_cast<char>((value >> (8*j)) & 0xFF);
+        }
+    }
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(file);
+}
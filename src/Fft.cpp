@@ -0,0 +1,105 @@
+/*
+ * Fft: Radix-2 fast Fourier transform
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Fft.hpp"
+
+#include <cmath>
+
+static const double pi = 3.14159265358979323846;
+
+Fft::Fft(size_t size)
+    : m_size(0)
+{
+    setSize(size);
+}
+
+void Fft::setSize(size_t size)
+{
+    m_size = size;
+    m_twiddles.resize(size/2);
+    for(size_t k=0; k<size/2; k++)
+    {
+        m_twiddles[k] = std::polar(1.0, -2.0*pi*k/size);
+    }
+
+    int bits = 0;
+    while((static_cast<size_t>(1) << bits) < size)
+    {
+        ++bits;
+    }
+    m_bitReverse.resize(size);
+    for(size_t i=0; i<size; i++)
+    {
+        size_t reversed = 0;
+        for(int bit=0; bit<bits; bit++)
+        {
+            reversed |= ((i >> bit) & 1) << (bits-1-bit);
+        }
+        m_bitReverse[i] = reversed;
+    }
+    m_buffer.resize(size);
+}
+
+size_t Fft::getSize() const
+{
+    return m_size;
+}
+
+void Fft::transform(std::vector<std::complex<double>> & data) const
+{
+    for(size_t i=0; i<m_size; i++)
+    {
+        if(i < m_bitReverse[i])
+        {
+            std::swap(data[i], data[m_bitReverse[i]]);
+        }
+    }
+
+    // Butterflies of length 2, 4, ... size, the twiddle factors of a length are every (size/length)th one
+    for(size_t length=2; length<=m_size; length*=2)
+    {
+        const size_t half = length/2;
+        const size_t step = m_size/length;
+        for(size_t start=0; start<m_size; start+=length)
+        {
+            for(size_t k=0; k<half; k++)
+            {
+                const std::complex<double> product = data[start+k+half]*m_twiddles[k*step];
+                data[start+k+half] = data[start+k] - product;
+                data[start+k] += product;
+            }
+        }
+    }
+}
+
+void Fft::calculatePowerSpectrum(const std::vector<double> & input, std::vector<double> & power)
+{
+    for(size_t i=0; i<m_size; i++)
+    {
+        m_buffer[i] = std::complex<double>(input[i], 0.0);
+    }
+    transform(m_buffer);
+
+    power.resize(m_size/2 + 1);
+    for(size_t k=0; k<power.size(); k++)
+    {
+        power[k] = std::norm(m_buffer[k]);
+    }
+}
@@ -0,0 +1,352 @@
+/*
+ * FileSource: Samples read from WAV or raw PCM files
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FileSource.hpp"
+#include "CaptureSpool.hpp"
+#include "PortAudioIO.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+// WAV header fields are little endian
+static uint32_t readUInt32(const char *data)
+{
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(data);
+    return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8)
+         | (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+static uint16_t readUInt16(const char *data)
+{
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(data);
+    return static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+}
+
+FileSource::FileSource(SampleSourceListener *listener)
+    : SampleSource(listener)
+    , m_channelCount(1)
+    , m_channel(1)
+    , m_realTime(false)
+    , m_loop(false)
+    , m_dataStart(0)
+    , m_dataSize(0)
+    , m_dataPosition(0)
+    , m_spool(false)
+    , m_firstSequence(0)
+    , m_sequence(0)
+    , m_recordRemaining(0)
+    , m_nextSampleIndex(UINT64_MAX)
+{
+}
+
+FileSource::~FileSource()
+{
+    // The generator thread must not call generateSamples() of a destroyed object
+    close();
+}
+
+void FileSource::setFileName(const std::string & fileName)
+{
+    m_fileName = fileName;
+}
+
+void FileSource::setRawChannelCount(int channelCount)
+{
+    m_channelCount = channelCount;
+}
+
+void FileSource::setChannel(int channel)
+{
+    m_channel = channel;
+}
+
+void FileSource::setRealTime(bool realTime)
+{
+    m_realTime = realTime;
+}
+
+void FileSource::setLoop(bool loop)
+{
+    m_loop = loop;
+}
+
+bool FileSource::open(int bitDepth, uint32_t sampleRate, uint32_t blockSize)
+{
+    close();
+
+    m_file.open(m_fileName, std::ios::binary);
+    if(!m_file)
+    {
+        std::cout << "ERROR: Could not open " << m_fileName << std::endl;
+        return false;
+    }
+
+    char magic[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    m_file.read(magic, 8);
+    m_file.clear();
+    m_file.seekg(0);
+
+    m_spool = (std::memcmp(magic, "CEMSPOOL", 8) == 0);
+    if(m_spool)
+    {
+        // Without a segment file name only this segment is read
+        if(!CaptureSpool::splitSegmentFileName(m_fileName, m_spoolPrefix, m_firstSequence))
+        {
+            m_spoolPrefix.clear();
+            m_firstSequence = 0;
+        }
+        m_file.close();
+        if(!openSpoolSegment(m_firstSequence, bitDepth, sampleRate))
+        {
+            std::cout << "ERROR: Unsupported spool file " << m_fileName << std::endl;
+            close();
+            return false;
+        }
+        m_recordRemaining = 0;
+        m_nextSampleIndex = UINT64_MAX;
+    }
+    else if(std::memcmp(magic, "RIFF", 4) == 0)
+    {
+        int waveChannelCount = 0;
+        if(!readWaveHeader(bitDepth, sampleRate, waveChannelCount))
+        {
+            std::cout << "ERROR: Unsupported WAV file " << m_fileName << std::endl;
+            close();
+            return false;
+        }
+        m_channelCount = waveChannelCount;
+    }
+    else
+    {
+        // Raw PCM, the whole file is sample data
+        m_file.clear();
+        m_file.seekg(0, std::ios::end);
+        m_dataStart = 0;
+        m_dataSize = m_file.tellg();
+    }
+
+    if(bitDepth != 8 && bitDepth != 16 && bitDepth != 24)
+    {
+        std::cout << "ERROR: Unsupported bit depth " << bitDepth << std::endl;
+        close();
+        return false;
+    }
+    // Spool segments contain only the recorded channel
+    if(!m_spool && (m_channel < 1 || m_channel > m_channelCount))
+    {
+        std::cout << "ERROR: File has no channel " << m_channel << std::endl;
+        close();
+        return false;
+    }
+    if(m_pairChannel > 0 && (m_spool || m_pairChannel > m_channelCount))
+    {
+        std::cout << "ERROR: File has no channel " << m_pairChannel << " for the channel pair" << std::endl;
+        close();
+        return false;
+    }
+
+    m_file.clear();
+    m_file.seekg(m_dataStart);
+    m_dataPosition = 0;
+
+    startReceiving(bitDepth, sampleRate, blockSize);
+    startGeneratorThread(m_realTime);
+    std::cout << "- File opened -" << std::endl;
+    std::cout << "Name:" << m_fileName << "| Sample rate:" << sampleRate << "| Bitdepth:" << bitDepth
+              << "| Input channel:" << m_channel << "/" << m_channelCount << std::endl;
+    return true;
+}
+
+void FileSource::close()
+{
+    stopGeneratorThread();
+    stopReceiving();
+    if(m_file.is_open())
+    {
+        m_file.close();
+    }
+}
+
+std::string FileSource::getName() const
+{
+    return "File " + m_fileName;
+}
+
+size_t FileSource::generateSamples(int32_t *samples, size_t count)
+{
+    if(m_spool)
+    {
+        return readSpoolSamples(samples, count);
+    }
+
+    const std::streamoff frameSize = static_cast<std::streamoff>(m_bitDepth/8*m_channelCount);
+    std::streamoff availableFrames = (m_dataSize - m_dataPosition)/frameSize;
+    if(availableFrames == 0 && m_loop)
+    {
+        m_file.clear();
+        m_file.seekg(m_dataStart);
+        m_dataPosition = 0;
+        availableFrames = m_dataSize/frameSize;
+    }
+
+    size_t frames = static_cast<size_t>(std::min<std::streamoff>(availableFrames, static_cast<std::streamoff>(count)));
+    if(frames == 0)
+    {
+        return 0;
+    }
+
+    m_readBuffer.resize(frames*static_cast<size_t>(frameSize));
+    m_file.read(m_readBuffer.data(), static_cast<std::streamsize>(m_readBuffer.size()));
+    frames = static_cast<size_t>(m_file.gcount()/frameSize);
+    m_dataPosition += static_cast<std::streamoff>(frames)*frameSize;
+
+    PortAudioIO::decodeFrames(m_readBuffer.data(), frames, m_bitDepth, true, m_channelCount, m_channel, samples);
+    // Called by the generator thread right after getWritePointer(), so the pair samples are at the same position
+    int32_t *pairSamples = m_buffer->getPairWritePointer();
+    if(pairSamples)
+    {
+        PortAudioIO::decodeFrames(m_readBuffer.data(), frames, m_bitDepth, true, m_channelCount, m_pairChannel, pairSamples);
+    }
+    return frames;
+}
+
+bool FileSource::readWaveHeader(int & bitDepth, uint32_t & sampleRate, int & channelCount)
+{
+    char header[12];
+    if(!m_file.read(header, 12) || std::memcmp(header, "RIFF", 4) != 0 || std::memcmp(header+8, "WAVE", 4) != 0)
+    {
+        return false;
+    }
+
+    bool formatFound = false;
+    char chunkHeader[8];
+    while(m_file.read(chunkHeader, 8))
+    {
+        uint32_t chunkSize = readUInt32(chunkHeader+4);
+        if(std::memcmp(chunkHeader, "fmt ", 4) == 0)
+        {
+            std::vector<char> format(chunkSize);
+            if(chunkSize < 16 || !m_file.read(format.data(), chunkSize))
+            {
+                return false;
+            }
+            // 1 = PCM, 0xFFFE = WAVE_FORMAT_EXTENSIBLE (assumed to contain PCM)
+            uint16_t formatTag = readUInt16(format.data());
+            if(formatTag != 1 && formatTag != 0xFFFE)
+            {
+                std::cout << "ERROR: Only integer PCM WAV files are supported" << std::endl;
+                return false;
+            }
+            channelCount = readUInt16(format.data()+2);
+            sampleRate = readUInt32(format.data()+4);
+            bitDepth = readUInt16(format.data()+14);
+            formatFound = true;
+        }
+        else if(std::memcmp(chunkHeader, "data", 4) == 0)
+        {
+            m_dataStart = m_file.tellg();
+            m_dataSize = chunkSize;
+            return formatFound;
+        }
+        else
+        {
+            // Skip unknown chunk (chunks are padded to an even size)
+            m_file.seekg(chunkSize + (chunkSize & 1), std::ios::cur);
+        }
+    }
+    return false;
+}
+
+bool FileSource::openSpoolSegment(uint64_t sequence, int & bitDepth, uint32_t & sampleRate)
+{
+    const std::string fileName = m_spoolPrefix.empty() ? m_fileName : CaptureSpool::getSegmentFileName(m_spoolPrefix, sequence);
+    if(m_file.is_open())
+    {
+        m_file.close();
+    }
+    m_file.clear();
+    m_file.open(fileName, std::ios::binary);
+
+    CaptureSpool::SegmentHeader header;
+    if(!m_file || !m_file.read(reinterpret_cast<char *>(&header), sizeof(header)) || !CaptureSpool::isSegmentHeader(header))
+    {
+        return false;
+    }
+    bitDepth = static_cast<int>(header.m_bitDepth);
+    sampleRate = header.m_sampleRate;
+    m_sequence = sequence;
+    m_dataStart = sizeof(header);
+    m_dataSize = static_cast<std::streamoff>(header.m_usedBytes);
+    m_dataPosition = 0;
+    return true;
+}
+
+size_t FileSource::readSpoolSamples(int32_t *samples, size_t count)
+{
+    size_t written = 0;
+    while(written < count)
+    {
+        if(m_recordRemaining == 0)
+        {
+            // Continue with the next segment (a single segment has no successor)
+            if(m_dataPosition + static_cast<std::streamoff>(sizeof(CaptureSpool::RecordHeader)) > m_dataSize)
+            {
+                int bitDepth = m_bitDepth;
+                uint32_t sampleRate = m_sampleRate;
+                bool opened = !m_spoolPrefix.empty() && openSpoolSegment(m_sequence+1, bitDepth, sampleRate);
+                if(!opened && m_loop)
+                {
+                    opened = openSpoolSegment(m_firstSequence, bitDepth, sampleRate);
+                    m_nextSampleIndex = UINT64_MAX;
+                }
+                if(!opened || bitDepth != m_bitDepth || sampleRate != m_sampleRate)
+                {
+                    break;
+                }
+                continue;
+            }
+
+            CaptureSpool::RecordHeader record;
+            if(!m_file.read(reinterpret_cast<char *>(&record), sizeof(record)))
+            {
+                break;
+            }
+            m_dataPosition += sizeof(record);
+            if(m_nextSampleIndex != UINT64_MAX && record.m_sampleIndex != m_nextSampleIndex)
+            {
+                std::cout << "Spool: " << static_cast<int64_t>(record.m_sampleIndex - m_nextSampleIndex)
+                          << " samples missing before sample " << record.m_sampleIndex << std::endl;
+            }
+            m_nextSampleIndex = record.m_sampleIndex + record.m_numberOfSamples;
+            m_recordRemaining = record.m_numberOfSamples;
+        }
+
+        const size_t numberOfSamples = std::min(count - written, static_cast<size_t>(m_recordRemaining));
+        if(!m_file.read(reinterpret_cast<char *>(samples + written), static_cast<std::streamsize>(numberOfSamples*sizeof(int32_t))))
+        {
+            break;
+        }
+        m_dataPosition += static_cast<std::streamoff>(numberOfSamples*sizeof(int32_t));
+        m_recordRemaining -= static_cast<uint32_t>(numberOfSamples);
+        written += numberOfSamples;
+    }
+    return written;
+}
@@ -0,0 +1,116 @@
+/*
+ * HistogramPanel: Window with the amplitude distribution of the input channel
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "HistogramPanel.hpp"
+
+#include <QLabel>
+#include <QPushButton>
+#include <QLayout>
+#include <QFormLayout>
+#include <QStyleOption>
+#include <QPainter>
+
+#include <algorithm>
+#include <cmath>
+
+const QColor colorFont(0,0,0);
+const QColor colorBar(65,105,225);
+const QColor colorFrame(160,160,160);
+
+HistogramPanel::HistogramPanel(QWidget *parent)
+    : QWidget(parent)
+{
+    setStyleSheet("QLabel {color: " + colorFont.name() + ";}");
+
+    m_labelSamples = new QLabel("-", this);
+    m_labelBins = new QLabel("-", this);
+    m_histogramArea = new QWidget(this);
+    m_histogramArea->setMinimumHeight(220);
+    m_buttonClose = new QPushButton(trUtf8("Close"), this);
+
+    QFormLayout *formLayout = new QFormLayout();
+    formLayout->addRow(trUtf8("Samples in the window:"), m_labelSamples);
+    formLayout->addRow(trUtf8("Used bins (codes per bin):"), m_labelBins);
+
+    QVBoxLayout *mainVLayout = new QVBoxLayout(this);
+    mainVLayout->addLayout(formLayout);
+    mainVLayout->addWidget(m_histogramArea, 1);
+    mainVLayout->addWidget(m_buttonClose);
+
+    connect(m_buttonClose, SIGNAL(clicked()), this, SLOT(hide()));
+}
+
+void HistogramPanel::updateHistogram(const std::vector<uint32_t> & counts, int codesPerBin)
+{
+    m_counts = counts;
+
+    uint64_t numberOfSamples = 0;
+    int usedBins = 0;
+    for(const auto& count : counts)
+    {
+        numberOfSamples += count;
+        usedBins += count > 0 ? 1 : 0;
+    }
+    m_labelSamples->setText(QString::number(numberOfSamples));
+    m_labelBins->setText(QString::number(usedBins) + " / " + QString::number(counts.size()) + " (" + QString::number(codesPerBin) + ")");
+    update();
+}
+
+void HistogramPanel::paintEvent(QPaintEvent *)
+{
+    QStyleOption opt;
+    opt.init(this);
+    QPainter p(this);
+    style()->drawPrimitive(QStyle::PE_Widget, &opt, &p, this);
+
+    const QRect area = m_histogramArea->geometry();
+    const int titleHeight = p.fontMetrics().height();
+    const QRect bars(area.left(), area.top()+titleHeight, area.width(), area.height()-2*titleHeight);
+    p.setPen(colorFont);
+    p.drawText(area.left(), area.top(), area.width(), titleHeight, Qt::AlignLeft, trUtf8("Amplitude distribution (logarithmic)"));
+    p.setPen(colorFrame);
+    p.drawRect(bars);
+    p.drawLine(bars.center().x(), bars.top(), bars.center().x(), bars.bottom());
+
+    p.setPen(colorFont);
+    p.drawText(bars.left(), bars.bottom()+1, bars.width(), titleHeight, Qt::AlignLeft, trUtf8("-FS"));
+    p.drawText(bars.left(), bars.bottom()+1, bars.width(), titleHeight, Qt::AlignHCenter, "0");
+    p.drawText(bars.left(), bars.bottom()+1, bars.width(), titleHeight, Qt::AlignRight, trUtf8("+FS"));
+
+    if(m_counts.empty())
+    {
+        return;
+    }
+
+    // Logarithmic height, otherwise the tails of the distribution wouldn't be visible
+    const uint32_t maximum = *std::max_element(m_counts.begin(), m_counts.end());
+    const double scale = (maximum > 0) ? 1.0/std::log10(static_cast<double>(maximum)+1.0) : 0.0;
+    const double barWidth = static_cast<double>(bars.width())/m_counts.size();
+    for(size_t i=0; i<m_counts.size(); i++)
+    {
+        if(m_counts[i] == 0)
+        {
+            continue;
+        }
+        // A single sample is still visible
+        const int height = std::max(1, static_cast<int>(std::log10(static_cast<double>(m_counts[i])+1.0)*scale*bars.height()));
+        p.fillRect(static_cast<int>(bars.left()+i*barWidth), bars.bottom()-height, std::max(1, static_cast<int>(barWidth)), height, colorBar);
+    }
+}
@@ -0,0 +1,98 @@
+/*
+ * HistoryBuffer: Circular buffer with the most recent samples
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "HistoryBuffer.hpp"
+
+#include <algorithm>
+
+HistoryBuffer::HistoryBuffer(size_t capacity)
+    : m_endIndex(0)
+{
+    resize(capacity);
+}
+
+void HistoryBuffer::resize(size_t capacity)
+{
+    m_samples.assign(capacity, 0);
+    m_endIndex = 0;
+}
+
+void HistoryBuffer::clear()
+{
+    m_endIndex = 0;
+}
+
+void HistoryBuffer::addSamples(const std::vector<int32_t> & samples)
+{
+    const size_t capacity = m_samples.size();
+    if(capacity == 0)
+    {
+        m_endIndex += samples.size();
+        return;
+    }
+
+    // Only the last "capacity" samples of a large block are kept
+    size_t first = samples.size() > capacity ? samples.size() - capacity : 0;
+    uint64_t index = m_endIndex + first;
+    while(first < samples.size())
+    {
+        const size_t position = static_cast<size_t>(index % capacity);
+        const size_t count = std::min(samples.size() - first, capacity - position);
+        std::copy(samples.begin() + first, samples.begin() + first + count, m_samples.begin() + position);
+        first += count;
+        index += count;
+    }
+    m_endIndex += samples.size();
+}
+
+size_t HistoryBuffer::getCapacity() const
+{
+    return m_samples.size();
+}
+
+uint64_t HistoryBuffer::getEndIndex() const
+{
+    return m_endIndex;
+}
+
+uint64_t HistoryBuffer::getBeginIndex() const
+{
+    return m_endIndex > m_samples.size() ? m_endIndex - m_samples.size() : 0;
+}
+
+bool HistoryBuffer::copySamples(uint64_t firstIndex, size_t count, std::vector<int32_t> & samples) const
+{
+    if(firstIndex < getBeginIndex() || firstIndex + count > m_endIndex)
+    {
+        return false;
+    }
+
+    samples.resize(count);
+    const size_t capacity = m_samples.size();
+    size_t copied = 0;
+    while(copied < count)
+    {
+        const size_t position = static_cast<size_t>((firstIndex + copied) % capacity);
+        const size_t length = std::min(count - copied, capacity - position);
+        std::copy(m_samples.begin() + position, m_samples.begin() + position + length, samples.begin() + copied);
+        copied += length;
+    }
+    return true;
+}
@@ -0,0 +1,190 @@
+/*
+ * HistoryPanel: Window with the entropy and level history of the whole session
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "HistoryPanel.hpp"
+#include "EntropyHistory.hpp"
+
+#include <QLabel>
+#include <QPushButton>
+#include <QLayout>
+#include <QStyleOption>
+#include <QPainter>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+const QColor colorFont(0,0,0);
+const QColor colorFrame(160,160,160);
+const QColor colorEntropy(0,160,0);
+const QColor colorPeak(220,60,60);
+const QColor colorRms(200,140,0);
+
+// e.g. "45 s", "12 min" or "3.5 h"
+static QString formatDuration(double seconds)
+{
+    if(seconds < 120.0)
+    {
+        return QString::number(seconds,'f',0) + " s";
+    }
+    if(seconds < 7200.0)
+    {
+        return QString::number(seconds/60.0,'f',0) + " min";
+    }
+    return QString::number(seconds/3600.0,'f',1) + " h";
+}
+
+HistoryPanel::HistoryPanel(const EntropyHistory *history, QWidget *parent)
+    : QWidget(parent)
+    , m_history(history)
+    , m_bitDepth(16)
+{
+    setStyleSheet("QLabel {color: " + colorFont.name() + ";}");
+
+    m_labelHistory = new QLabel(trUtf8("History: -"), this);
+    m_historyArea = new QWidget(this);
+    m_historyArea->setMinimumHeight(220);
+    m_buttonExport = new QPushButton(trUtf8("Export"), this);
+    m_buttonExport->setToolTip(trUtf8("Write entropy, peak and RMS of every window to a CSV file"));
+    m_buttonClose = new QPushButton(trUtf8("Close"), this);
+
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    buttonLayout->addWidget(m_buttonExport);
+    buttonLayout->addWidget(m_buttonClose);
+
+    QVBoxLayout *mainVLayout = new QVBoxLayout(this);
+    mainVLayout->addWidget(m_labelHistory);
+    mainVLayout->addWidget(m_historyArea, 1);
+    mainVLayout->addLayout(buttonLayout);
+
+    connect(m_buttonExport, SIGNAL(clicked()), this, SLOT(emitExportRequested()));
+    connect(m_buttonClose, SIGNAL(clicked()), this, SLOT(hide()));
+}
+
+void HistoryPanel::setBitDepth(int bitDepth)
+{
+    m_bitDepth = bitDepth;
+}
+
+void HistoryPanel::updateHistory()
+{
+    updatePaths();
+    update();
+}
+
+void HistoryPanel::updatePaths()
+{
+    m_entropyPath = QPainterPath();
+    m_peakPath = QPainterPath();
+    m_rmsPath = QPainterPath();
+
+    // At most about 1000 records, however long the session is
+    std::vector<EntropyHistory::Record> records;
+    m_history->getRecords(records);
+    if(records.empty())
+    {
+        m_labelHistory->setText(trUtf8("History: -"));
+        return;
+    }
+    const double duration = records.back().m_endTime;
+    m_labelHistory->setText(trUtf8("History: ") + formatDuration(duration) + ", " + QString::number(records.size())
+                            + trUtf8(" points (") + formatDuration(records.back().m_endTime - records.back().m_startTime) + trUtf8(" each)")
+                            + trUtf8(", ends at sample ") + QString::number(records.back().m_endSampleIndex)
+                            + trUtf8(" (ADC time ") + QString::number(records.back().m_endAdcTime,'f',3) + " s)");
+    if(records.size() < 2 || duration <= 0.0)
+    {
+        return;
+    }
+
+    // Levels from the quantization noise floor to full scale
+    const double dynamicRange = 20.0*std::log10(std::pow(2.0, m_bitDepth));
+    for(size_t i=0; i<records.size(); i++)
+    {
+        const EntropyHistory::Record & record = records[i];
+        const double x = 0.5*(record.m_startTime + record.m_endTime)/duration;
+        const QPointF entropy(x, record.m_entropy/m_bitDepth);
+        const QPointF peak(x, std::max(0.0, 1.0 + record.m_peak/dynamicRange));
+        const QPointF rms(x, std::max(0.0, 1.0 + record.m_rms/dynamicRange));
+        if(i == 0)
+        {
+            m_entropyPath.moveTo(entropy);
+            m_peakPath.moveTo(peak);
+            m_rmsPath.moveTo(rms);
+        }
+        else
+        {
+            m_entropyPath.lineTo(entropy);
+            m_peakPath.lineTo(peak);
+            m_rmsPath.lineTo(rms);
+        }
+    }
+}
+
+void HistoryPanel::emitExportRequested()
+{
+    emit signalExportRequested();
+}
+
+void HistoryPanel::updateExport(QString fileName)
+{
+    m_buttonExport->setToolTip(fileName.isEmpty() ? trUtf8("Could not write the history")
+                                                  : trUtf8("History written to ") + fileName);
+}
+
+void HistoryPanel::paintEvent(QPaintEvent *)
+{
+    QStyleOption opt;
+    opt.init(this);
+    QPainter p(this);
+    style()->drawPrimitive(QStyle::PE_Widget, &opt, &p, this);
+
+    // y: entropy (0 ... bit depth bit) and level (noise floor ... 0 dBFS), the paths only have to be scaled
+    const QRect area = m_historyArea->geometry();
+    const int legendHeight = p.fontMetrics().height();
+    const QRect graph(area.left(), area.top()+legendHeight, area.width(), area.height()-legendHeight);
+    p.setPen(colorFrame);
+    p.drawRect(graph);
+    if(!m_entropyPath.isEmpty())
+    {
+        p.save();
+        p.setRenderHint(QPainter::Antialiasing);
+        p.setTransform(QTransform(graph.width(), 0.0, 0.0, -graph.height(), graph.left(), graph.bottom()));
+        // Cosmetic pens keep their width under the transformation
+        QPen pen(colorPeak, 1);
+        pen.setCosmetic(true);
+        p.setPen(pen);
+        p.drawPath(m_peakPath);
+        pen.setColor(colorRms);
+        p.setPen(pen);
+        p.drawPath(m_rmsPath);
+        pen.setColor(colorEntropy);
+        pen.setWidth(2);
+        p.setPen(pen);
+        p.drawPath(m_entropyPath);
+        p.restore();
+    }
+    const QRect legend(area.left(), area.top(), area.width(), legendHeight);
+    p.setPen(colorEntropy);
+    p.drawText(legend, Qt::AlignLeft, trUtf8("Entropy (0 ... ") + QString::number(m_bitDepth) + " bit)");
+    p.setPen(colorPeak);
+    p.drawText(legend, Qt::AlignHCenter, trUtf8("Peak"));
+    p.setPen(colorRms);
+    p.drawText(legend, Qt::AlignRight, trUtf8("RMS (dBFS)"));
+}
@@ -0,0 +1,449 @@
+/*
+ * LosslessBitrate: Estimated bitrate of a FLAC-like lossless encoding
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LosslessBitrate.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+static const double pi = 3.14159265358979323846;
+
+// Branch-free, so the loops over the residuals can be vectorized
+static inline uint64_t absolute(int64_t value)
+{
+    const int64_t sign = value >> 63;
+    return static_cast<uint64_t>((value ^ sign) - sign);
+}
+
+LosslessBitrate::LosslessBitrate(LosslessBitrateListener *listener)
+    : m_losslessBitrateListener(listener)
+    , m_blockCounter(0)
+    , m_numberOfBlocks(50)
+    , m_size(0)
+{
+    setBitDepth(16);
+}
+
+void LosslessBitrate::addSamples(const std::vector<int32_t> & signalValues)
+{
+    if(!m_losslessBitrateListener)
+    {
+        return;
+    }
+
+    Predictor predictor;
+    m_windowBits += estimateBlockBits(signalValues, predictor);
+    m_windowSamples += signalValues.size();
+    ++m_predictorCounts[static_cast<int>(predictor)];
+    ++m_blockCounter;
+
+    if(m_blockCounter >= m_numberOfBlocks)
+    {
+        if(m_windowSamples > 0)
+        {
+            const auto mostFrequent = std::max_element(m_predictorCounts.begin(), m_predictorCounts.end()) - m_predictorCounts.begin();
+            m_losslessBitrateListener->receiveLosslessBitrate(static_cast<double>(m_windowBits)/m_windowSamples,
+                                                              getPredictorName(static_cast<Predictor>(mostFrequent)));
+        }
+        clear();
+    }
+}
+
+void LosslessBitrate::setNumberOfBlocks(int numberOfBlocks)
+{
+    m_numberOfBlocks = numberOfBlocks;
+}
+
+void LosslessBitrate::setBitDepth(int bitDepth)
+{
+    m_bitDepth = bitDepth;
+    // Above 16 bit FLAC needs the 5 bit Rice parameters (RICE2)
+    m_maximumRiceParameter = bitDepth > 16 ? 30 : 14;
+    clear();
+}
+
+void LosslessBitrate::clear()
+{
+    m_blockCounter = 0;
+    m_windowBits = 0;
+    m_windowSamples = 0;
+    m_predictorCounts.fill(0);
+}
+
+uint64_t LosslessBitrate::estimateBlockBits(const std::vector<int32_t> & signalValues, Predictor & predictor)
+{
+    // Every subframe starts with an 8 bit header
+    const uint64_t headerBits = 8;
+    m_size = signalValues.size();
+    predictor = Predictor::Verbatim;
+    if(m_size == 0)
+    {
+        return 0;
+    }
+
+    // One pass for the constant check and the zero LSBs
+    const uint32_t mask = static_cast<uint32_t>((1ULL << m_bitDepth) - 1);
+    const uint32_t first = static_cast<uint32_t>(signalValues[0]);
+    uint32_t usedBits = 0;
+    uint32_t differentBits = 0;
+    for(size_t i=0; i<m_size; i++)
+    {
+        const uint32_t value = static_cast<uint32_t>(signalValues[i]);
+        usedBits |= value;
+        differentBits |= value ^ first;
+    }
+    if((differentBits & mask) == 0)
+    {
+        predictor = Predictor::Constant;
+        return headerBits + m_bitDepth;
+    }
+
+    int wastedBits = 0;
+    while(((usedBits >> wastedBits) & 1) == 0)
+    {
+        ++wastedBits;
+    }
+    const int bitDepth = m_bitDepth - wastedBits;
+    // The number of wasted bits is coded in unary
+    const uint64_t subframeBits = headerBits + wastedBits;
+
+    m_samples.resize(m_size);
+    m_residual.resize(m_size);
+    m_difference.resize(m_size);
+    for(size_t i=0; i<m_size; i++)
+    {
+        m_samples[i] = signalValues[i] >> wastedBits;
+    }
+
+    uint64_t bestBits = subframeBits + m_size*bitDepth;
+
+    // Like FLAC, the fixed order is chosen from the sums of the absolute residuals of all orders, which are
+    // calculated in one pass without storing them. Only the residual of the chosen order is Rice coded.
+    if(m_size > maximumFixedOrder)
+    {
+        const int64_t *samples = m_samples.data();
+        int64_t last0 = samples[3];
+        int64_t last1 = samples[3] - samples[2];
+        int64_t last2 = last1 - (samples[2] - samples[1]);
+        int64_t last3 = last2 - (samples[2] - samples[1] - (samples[1] - samples[0]));
+        uint64_t sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0, sum4 = 0;
+        for(size_t i=maximumFixedOrder; i<m_size; i++)
+        {
+            const int64_t error0 = samples[i];
+            const int64_t error1 = error0 - last0;
+            const int64_t error2 = error1 - last1;
+            const int64_t error3 = error2 - last2;
+            const int64_t error4 = error3 - last3;
+            last0 = error0;
+            last1 = error1;
+            last2 = error2;
+            last3 = error3;
+            sum0 += absolute(error0);
+            sum1 += absolute(error1);
+            sum2 += absolute(error2);
+            sum3 += absolute(error3);
+            sum4 += absolute(error4);
+        }
+        const std::array<uint64_t, maximumFixedOrder + 1> sums = {{sum0, sum1, sum2, sum3, sum4}};
+        const int order = static_cast<int>(std::min_element(sums.begin(), sums.end()) - sums.begin());
+
+        // Order k is the difference of order k-1, the first k samples are stored verbatim ("warm-up")
+        std::copy(m_samples.begin(), m_samples.end(), m_residual.begin());
+        for(int k=1; k<=order; k++)
+        {
+            std::swap(m_residual, m_difference);
+            const int64_t *difference = m_difference.data();
+            int64_t *residual = m_residual.data();
+            for(size_t i=k; i<m_size; i++)
+            {
+                residual[i] = difference[i] - difference[i-1];
+            }
+        }
+        const uint64_t bits = subframeBits + order*bitDepth + estimateResidualBits(order);
+        if(bits < bestBits)
+        {
+            bestBits = bits;
+            predictor = static_cast<Predictor>(static_cast<int>(Predictor::Fixed0) + order);
+        }
+    }
+
+    // Too short blocks would only pay for the coefficients
+    if(m_size > 4*maximumLpcOrder)
+    {
+        const uint64_t bits = subframeBits + estimateLpcBits(bitDepth);
+        if(bits < bestBits)
+        {
+            bestBits = bits;
+            predictor = Predictor::Lpc;
+        }
+    }
+    return bestBits;
+}
+
+const char *LosslessBitrate::getPredictorName(Predictor predictor)
+{
+    switch(predictor)
+    {
+    case Predictor::Verbatim:
+        return "verbatim";
+    case Predictor::Constant:
+        return "constant";
+    case Predictor::Fixed0:
+        return "fixed 0";
+    case Predictor::Fixed1:
+        return "fixed 1";
+    case Predictor::Fixed2:
+        return "fixed 2";
+    case Predictor::Fixed3:
+        return "fixed 3";
+    case Predictor::Fixed4:
+        return "fixed 4";
+    case Predictor::Lpc:
+        return "LPC";
+    default:
+        return "unknown";
+    }
+}
+
+uint64_t LosslessBitrate::estimateResidualBits(int order)
+{
+    // Like FLAC: the block size must be a multiple of the number of partitions and the first partition must hold more than the warm-up
+    int partitionOrder = 0;
+    while(partitionOrder < maximumPartitionOrder && m_size % (2U << partitionOrder) == 0 && (m_size >> (partitionOrder + 1)) > static_cast<size_t>(order))
+    {
+        ++partitionOrder;
+    }
+
+    // Sums of the finest partitions, the coarser ones are merged from them
+    size_t numberOfPartitions = 1U << partitionOrder;
+    size_t partitionSize = m_size >> partitionOrder;
+    m_partitionSums.resize(numberOfPartitions);
+    const int64_t *residual = m_residual.data();
+    for(size_t partition=0; partition<numberOfPartitions; partition++)
+    {
+        const size_t begin = partition == 0 ? order : partition*partitionSize;
+        const size_t end = (partition + 1)*partitionSize;
+        uint64_t sum = 0;
+        for(size_t i=begin; i<end; i++)
+        {
+            sum += absolute(residual[i]);
+        }
+        m_partitionSums[partition] = sum;
+    }
+
+    uint64_t bestBits = std::numeric_limits<uint64_t>::max();
+    while(true)
+    {
+        // 2 bit coding method, 4 bit partition order
+        uint64_t bits = 6;
+        for(size_t partition=0; partition<numberOfPartitions; partition++)
+        {
+            const size_t numberOfSamples = partition == 0 ? partitionSize - order : partitionSize;
+            bits += estimatePartitionBits(m_partitionSums[partition], numberOfSamples);
+        }
+        bestBits = std::min(bestBits, bits);
+
+        if(numberOfPartitions == 1)
+        {
+            break;
+        }
+        numberOfPartitions /= 2;
+        partitionSize *= 2;
+        for(size_t partition=0; partition<numberOfPartitions; partition++)
+        {
+            m_partitionSums[partition] = m_partitionSums[2*partition] + m_partitionSums[2*partition+1];
+        }
+    }
+    return bestBits;
+}
+
+uint64_t LosslessBitrate::estimateLpcBits(int bitDepth)
+{
+    updateWindow();
+    for(size_t i=0; i<m_size; i++)
+    {
+        m_windowed[i] = m_samples[i]*m_window[i];
+    }
+
+    // The windowed block is zero padded, so all lags run over the whole block. Four partial sums per lag
+    // break the dependency chain of the additions.
+    std::array<double, maximumLpcOrder + 1> autocorrelation;
+    const double *windowed = m_windowed.data();
+    const size_t alignedSize = m_size & ~static_cast<size_t>(3);
+    for(int lag=0; lag<=maximumLpcOrder; lag++)
+    {
+        double sum0 = 0.0, sum1 = 0.0, sum2 = 0.0, sum3 = 0.0;
+        for(size_t i=0; i<alignedSize; i+=4)
+        {
+            sum0 += windowed[i]*windowed[i+lag];
+            sum1 += windowed[i+1]*windowed[i+1+lag];
+            sum2 += windowed[i+2]*windowed[i+2+lag];
+            sum3 += windowed[i+3]*windowed[i+3+lag];
+        }
+        for(size_t i=alignedSize; i<m_size; i++)
+        {
+            sum0 += windowed[i]*windowed[i+lag];
+        }
+        autocorrelation[lag] = (sum0 + sum1) + (sum2 + sum3);
+    }
+    if(autocorrelation[0] <= 0.0)
+    {
+        return std::numeric_limits<uint64_t>::max();
+    }
+
+    // Levinson-Durbin, "coefficients[order-1]" predicts x[n] from x[n-1] ... x[n-order]
+    std::array<std::array<double, maximumLpcOrder>, maximumLpcOrder> coefficients;
+    std::array<double, maximumLpcOrder> errors;
+    std::array<double, maximumLpcOrder> lpc;
+    double error = autocorrelation[0];
+    for(int i=0; i<maximumLpcOrder; i++)
+    {
+        double reflection = -autocorrelation[i+1];
+        for(int j=0; j<i; j++)
+        {
+            reflection -= lpc[j]*autocorrelation[i-j];
+        }
+        reflection /= error;
+
+        lpc[i] = reflection;
+        for(int j=0; j<i/2; j++)
+        {
+            const double temporary = lpc[j];
+            lpc[j] += reflection*lpc[i-1-j];
+            lpc[i-1-j] += reflection*temporary;
+        }
+        if(i & 1)
+        {
+            lpc[i/2] += lpc[i/2]*reflection;
+        }
+        error *= 1.0 - reflection*reflection;
+
+        for(int j=0; j<=i; j++)
+        {
+            coefficients[i][j] = -lpc[j];
+        }
+        errors[i] = error;
+    }
+
+    // Coefficient precision of the FLAC reference encoder: by block size for 16 bit, the maximum above
+    int precision = m_size <= 192 ? 7 : m_size <= 384 ? 8 : m_size <= 576 ? 9 : m_size <= 1152 ? 10 : m_size <= 2304 ? 11 : m_size <= 4608 ? 12 : 13;
+    if(m_bitDepth < 16)
+    {
+        precision = std::max(5, 2 + m_bitDepth/2);
+    }
+    else if(m_bitDepth > 16)
+    {
+        precision = 15;
+    }
+
+    // Choose the order from the prediction error like FLAC does, the residual is only calculated for that order
+    int order = 1;
+    double bestEstimate = std::numeric_limits<double>::max();
+    for(int i=1; i<=maximumLpcOrder; i++)
+    {
+        const double bitsPerSample = errors[i-1] > 0.0 ? std::max(0.0, 0.5*std::log2(0.5*errors[i-1]/m_size)) : 0.0;
+        const double estimate = bitsPerSample*(m_size - i) + i*(bitDepth + precision);
+        if(estimate < bestEstimate)
+        {
+            bestEstimate = estimate;
+            order = i;
+        }
+    }
+
+    // Quantize with error feedback, the prediction is shifted right by "shift"
+    double maximumCoefficient = 0.0;
+    for(int j=0; j<order; j++)
+    {
+        maximumCoefficient = std::max(maximumCoefficient, std::abs(coefficients[order-1][j]));
+    }
+    if(maximumCoefficient <= 0.0)
+    {
+        return std::numeric_limits<uint64_t>::max();
+    }
+    int exponent;
+    std::frexp(maximumCoefficient, &exponent);
+    const int shift = std::min(15, precision - 1 - exponent);
+    if(shift < 0)
+    {
+        return std::numeric_limits<uint64_t>::max();
+    }
+    const int64_t maximumQuantized = (1 << (precision - 1)) - 1;
+    std::array<int64_t, maximumLpcOrder> quantized;
+    double quantizationError = 0.0;
+    for(int j=0; j<order; j++)
+    {
+        quantizationError += coefficients[order-1][j]*(1 << shift);
+        quantized[j] = std::max(-maximumQuantized - 1, std::min(maximumQuantized, static_cast<int64_t>(std::lround(quantizationError))));
+        quantizationError -= quantized[j];
+    }
+
+    const int64_t *samples = m_samples.data();
+    int64_t *residual = m_residual.data();
+    for(size_t i=order; i<m_size; i++)
+    {
+        int64_t prediction = 0;
+        for(int j=0; j<order; j++)
+        {
+            prediction += quantized[j]*samples[i-1-j];
+        }
+        residual[i] = samples[i] - (prediction >> shift);
+    }
+
+    // Warm-up, 4 bit precision, 5 bit shift and the coefficients
+    return order*bitDepth + 4 + 5 + order*precision + estimateResidualBits(order);
+}
+
+uint64_t LosslessBitrate::estimatePartitionBits(uint64_t absoluteSum, uint64_t numberOfSamples) const
+{
+    const uint64_t parameterBits = m_maximumRiceParameter > 14 ? 5 : 4;
+    if(numberOfSamples == 0)
+    {
+        return parameterBits;
+    }
+
+    // Smallest parameter with 2^k >= mean absolute residual, the estimate is the one of the FLAC reference encoder
+    int parameter = 0;
+    while(parameter < m_maximumRiceParameter && (numberOfSamples << parameter) < absoluteSum)
+    {
+        ++parameter;
+    }
+    const uint64_t quotientBits = parameter > 0 ? absoluteSum >> (parameter - 1) : absoluteSum << 1;
+    return parameterBits + (1 + parameter)*numberOfSamples + quotientBits - (numberOfSamples >> 1);
+}
+
+void LosslessBitrate::updateWindow()
+{
+    if(m_window.size() == m_size)
+    {
+        return;
+    }
+
+    // Tukey(0.5): cosine tapers over the first and the last quarter
+    m_window.assign(m_size, 1.0);
+    const size_t taper = m_size/4;
+    for(size_t i=0; i<taper; i++)
+    {
+        const double value = 0.5 - 0.5*std::cos(pi*i/taper);
+        m_window[i] = value;
+        m_window[m_size-1-i] = value;
+    }
+    m_windowed.assign(m_size + maximumLpcOrder, 0.0);
+}
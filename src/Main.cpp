@@ -20,9 +20,22 @@
 
 #include <QApplication>
 #include "MainWindow.hpp"
+#include "ConsoleRunner.hpp"
 
 int main(int argc, char *argv[])
 {
+    // Benchmarks and regression tests run without GUI
+    if(ConsoleRunner::isConsoleMode(argc, argv))
+    {
+        ConsoleRunner runner;
+        if(!runner.parseArguments(argc, argv))
+        {
+            runner.printUsage();
+            return 1;
+        }
+        return runner.run();
+    }
+
     QApplication app(argc, argv);
 
     MainWindow mw;
@@ -29,27 +29,52 @@
 #include "EntropyDisplay.hpp"
 
 //#include "Entropy.hpp"
+#include "HistogramPanel.hpp"
+#include "HistoryPanel.hpp"
 #include "InfoWindow.hpp"
+#include "SpectrogramPanel.hpp"
+#include "StatisticsPanel.hpp"
+#include "TriggerPanel.hpp"
+#include "WaveformPanel.hpp"
 
 //#include <QComboBox>
+#include <QApplication>
+#include <QDateTime>
+#include <QDesktopWidget>
 #include <QDebug>
+#include <QDir>
 #include <QLayout>
+#include <QScrollArea>
+#include <QStandardPaths>
+#include <QTimer>
 //#include <QPushButton>
 //#include <QSpinBox>
 //#include <QThread>
 //#include <QVector>
 #include <QGroupBox>
+#include <QStyle>
+
+#include <algorithm>
 
 const QColor colorBackground(50,50,50);
 const QColor colorWidgetBackground(80,80,80);
 const QColor colorFont(255,255,255);
 const QColor colorFrame(80,80,80);
+// Size of the main window content, the layout is designed for it
+const int contentWidth = 510;
+const int contentHeight = 940;
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
 {
     setWindowTitle("Code Entropy Meter");
 
+    // Needed to pass probing results from the probing thread to the UI thread
+    qRegisterMetaType<std::vector<uint32_t>>("std::vector<uint32_t>");
+    qRegisterMetaType<std::vector<double>>("std::vector<double>");
+    qRegisterMetaType<BitStatistics::Snapshot>("BitStatistics::Snapshot");
+    qRegisterMetaType<RunningMoments::Result>("RunningMoments::Result");
+
     initializeUI();
 
     if(!m_portAudioControl->initialize())
@@ -72,11 +97,23 @@ MainWindow::MainWindow(QWidget *parent)
     m_parameters.m_bitDepth = 16;
     m_parameters.m_blockSize = 2048;
     m_parameters.m_channel = 1;
+    m_parameters.m_pairChannel = 0;
     m_parameters.m_device = 0;
     m_parameters.m_deviceIndex = 0;
     m_parameters.m_hostApiId = 0;
     m_parameters.m_sampleFormat = paInt16;
     m_parameters.m_sampleRate = 44100;
+    m_parameters.m_captureMode = PortAudioControl::CaptureMode::Callback;
+    m_parameters.m_framesPerBuffer = 0;
+    m_parameters.m_littleEndian = true;
+    m_parameters.m_meterFallTime = 1.7;
+    m_parameters.m_recording = false;
+
+    m_activeConfiguration.m_numberOfBlocks = 0;
+    m_activeConfiguration.m_decayingEntropy = false;
+    m_activeConfiguration.m_returnTimeValue = 0.0;
+    m_activeConfiguration.m_channel = m_parameters.m_channel;
+    m_activeConfiguration.m_littleEndian = m_parameters.m_littleEndian;
 
     anotherApiSelected(m_devices.at(0).m_hostApi);
     anotherDeviceSelected(0);
@@ -85,21 +122,89 @@ MainWindow::MainWindow(QWidget *parent)
     anotherSampleRateSelected(44100);
     anotherBlockSizeSelected(2048);
     m_bitDisplay->setSampleMaximum(2048);
+
+    probeUnknownDevices();
 }
 
-void MainWindow::receivePortAudioSamples(const std::vector<int32_t> & samples)
+void MainWindow::receiveSourceSamples(const AudioBlock & block)
 {
+    AnalysisConfiguration configuration;
+    if(m_analysisConfiguration.fetch(configuration))
+    {
+        applyAnalysisConfiguration(configuration);
+    }
+
+    const std::vector<int32_t> & samples = block.m_samples;
     m_peakMeter->updateMeter(samples);
     m_rmsMeter->updateMeter(samples);
+    // Before the entropy, which ends the window of the history
+    m_entropyHistory->addLevels(m_peakMeter->getBlockPeak(), m_rmsMeter->getBlockRms(), samples.size(), block.m_sampleIndex, block.m_adcTime);
+    m_runningMoments->addSamples(samples);
     m_bitDisplay->updateDisplay(samples, m_parameters.m_bitDepth);
     m_entropy->addSamples(samples);
+    m_entropyProfile->addSamples(samples);
+    m_predictionEntropy->addSamples(samples);
+    m_losslessBitrate->addSamples(samples);
+    m_multiResolutionEntropy->addSamples(samples);
+    m_amplitudeHistogram->addSamples(samples);
+    m_waveformPyramid->addSamples(samples);
+    m_spectrogram->addSamples(samples);
+    if(!block.m_pairSamples.empty())
+    {
+        m_channelPairEntropy->addSamples(samples, block.m_pairSamples);
+    }
+    m_bitDepthEstimator->addSamples(samples);
+    m_eventTrigger->addBlock(samples, m_peakMeter->isClipping(), m_rmsMeter->getBlockRms());
+}
+
+void MainWindow::receiveSupportedSampleRates(int deviceNumber, const std::vector<uint32_t> & sampleRates)
+{
+    emit signalSupportedSampleRatesReceived(deviceNumber, sampleRates);
+}
+
+void MainWindow::receiveProbingFinished(bool completed)
+{
+    emit signalProbingFinished(completed);
 }
 
 void MainWindow::receiveEntropy(double entropy)
 {
+    m_eventTrigger->addEntropy(entropy);
+    m_entropyHistory->addEntropy(entropy);
     emit signalUpdateEntropyDisplay(entropy);
 }
 
+void MainWindow::receiveEntropyProfile(const std::vector<double> & profile)
+{
+    emit signalUpdateEntropyProfile(profile);
+}
+
+void MainWindow::receivePredictionEntropy(const std::vector<double> & residualEntropy, double conditionalEntropy, int conditionalResolution)
+{
+    emit signalUpdatePredictionEntropy(residualEntropy, conditionalEntropy, conditionalResolution);
+}
+
+void MainWindow::receiveLosslessBitrate(double bitsPerSample, const char *predictor)
+{
+    emit signalUpdateLosslessBitrate(bitsPerSample, QString(predictor));
+}
+
+void MainWindow::receiveMultiResolutionEntropy(const std::vector<double> & entropies)
+{
+    emit signalUpdateMultiResolutionEntropy(entropies);
+}
+
+void MainWindow::receiveChannelPairEntropy(double firstEntropy, double secondEntropy, double jointEntropy,
+                                           double mutualInformation, int resolution)
+{
+    emit signalUpdateChannelPairEntropy(firstEntropy, secondEntropy, jointEntropy, mutualInformation, resolution);
+}
+
+void MainWindow::receiveAmplitudeHistogram(const std::vector<uint32_t> & counts, int codesPerBin)
+{
+    emit signalUpdateAmplitudeHistogram(counts, codesPerBin);
+}
+
 void MainWindow::receivePeakHolderValue(double value)
 {
     emit signalUpdatePeakHolder(value);
@@ -120,6 +225,24 @@ void MainWindow::receiveRmsMeterValue(double rms)
     emit signalUpdateRmsMeter(rms);
 }
 
+void MainWindow::receiveRunningMoments(const RunningMoments::Result & window, const RunningMoments::Result & total)
+{
+    emit signalUpdateRunningMoments(window, total);
+}
+
+void MainWindow::receiveTriggerEvent(const std::string & reason, const std::string & fileName)
+{
+    (void) reason;
+    emit signalTriggerEvent(QString::fromStdString(fileName));
+}
+
+void MainWindow::receiveBitDepthEstimate(int bitDepth, int effectiveBitDepth, int noiseBits, const char *verdict)
+{
+    emit signalUpdateBitDepthEstimate(bitDepth, effectiveBitDepth, noiseBits, QString(verdict));
+    // Called from the analysis thread, so the statistics can't change meanwhile
+    emit signalUpdateBitStatistics(m_bitDepthEstimator->getStatistics().getSnapshot());
+}
+
 void MainWindow::resizeEvent(QResizeEvent *event)
 {
     (void) event;
@@ -130,12 +253,16 @@ void MainWindow::closeEvent(QCloseEvent *event)
 {
     (void) event;
     m_infoWindow->close();
+    m_statisticsPanel->close();
+    m_histogramPanel->close();
+    m_waveformPanel->close();
+    m_spectrogramPanel->close();
+    m_historyPanel->close();
+    m_triggerPanel->close();
 }
 
 void MainWindow::initializeUI()
 {
-    setFixedSize(510,540);
-
     m_optionsPanel = new OptionPanel(this);
     m_optionsPanel->setObjectName("optionsPanel");
     m_optionsPanel->disableStopButton(true);
@@ -168,9 +295,21 @@ void MainWindow::initializeUI()
     boxEntropyDisplay->setLayout(entropyDisplayLayout);
 
     m_entropy.reset(new Entropy(this));
+    m_entropyProfile.reset(new EntropyProfile(this));
+    m_predictionEntropy.reset(new PredictionEntropy(this));
+    m_losslessBitrate.reset(new LosslessBitrate(this));
+    m_multiResolutionEntropy.reset(new MultiResolutionEntropy(this));
+    m_channelPairEntropy.reset(new ChannelPairEntropy(this));
+    m_amplitudeHistogram.reset(new AmplitudeHistogram(this));
+    m_waveformPyramid.reset(new WaveformPyramid());
+    m_spectrogram.reset(new Spectrogram());
+    m_bitDepthEstimator.reset(new BitDepthEstimator(this));
 
     m_peakMeter = new PeakMeter(this);
     m_rmsMeter.reset(new RMSMeter(this));
+    m_runningMoments.reset(new RunningMoments(this));
+    m_entropyHistory.reset(new EntropyHistory());
+    m_eventTrigger.reset(new EventTrigger(this));
 
     m_meterDisplay = new MeterDisplay(this);
     m_meterDisplay->setObjectName("meterDisplay");
@@ -201,14 +340,58 @@ void MainWindow::initializeUI()
     m_mainLayout->addLayout(m_mainHLayout,2);
     m_mainLayout->setSpacing(2);
 
-    QWidget *centralWidget = new QWidget(this);
-    centralWidget->setLayout(m_mainLayout);
-    setCentralWidget(centralWidget);
+    QWidget *contentWidget = new QWidget(this);
+    contentWidget->setObjectName("mainContent");
+    contentWidget->setLayout(m_mainLayout);
+    contentWidget->setMinimumSize(contentWidth, contentHeight);
+    QScrollArea *scrollArea = new QScrollArea(this);
+    scrollArea->setObjectName("mainScrollArea");
+    scrollArea->setFrameShape(QFrame::NoFrame);
+    scrollArea->setWidgetResizable(true);
+    scrollArea->setWidget(contentWidget);
+    setCentralWidget(scrollArea);
+    // The content has a fixed layout, on small screens the window is smaller and scrolls
+    const QRect screen = QApplication::desktop()->availableGeometry(this);
+    resize(contentWidth + style()->pixelMetric(QStyle::PM_ScrollBarExtent), std::min(contentHeight, screen.height() - 40));
 
     m_infoWindow = new InfoWindow();
     m_infoWindow->setObjectName("infoWindow");
     m_infoWindow->setFixedSize(300,330);
     m_infoWindow->setWindowTitle("Information");
+
+    m_statisticsPanel = new StatisticsPanel();
+    m_statisticsPanel->setObjectName("statisticsPanel");
+    m_statisticsPanel->setFixedSize(420,420);
+    m_statisticsPanel->setWindowTitle("Stream statistics");
+
+    m_histogramPanel = new HistogramPanel();
+    m_histogramPanel->setObjectName("histogramPanel");
+    m_histogramPanel->setFixedSize(560,360);
+    m_histogramPanel->setWindowTitle("Amplitude histogram");
+
+    m_waveformPanel = new WaveformPanel(m_waveformPyramid.get());
+    m_waveformPanel->setObjectName("waveformPanel");
+    m_waveformPanel->setFixedSize(560,360);
+    m_waveformPanel->setWindowTitle("Waveform");
+
+    m_spectrogramPanel = new SpectrogramPanel(m_spectrogram.get());
+    m_spectrogramPanel->setObjectName("spectrogramPanel");
+    m_spectrogramPanel->setFixedSize(560,360);
+    m_spectrogramPanel->setWindowTitle("Spectrogram");
+
+    m_historyPanel = new HistoryPanel(m_entropyHistory.get());
+    m_historyPanel->setObjectName("historyPanel");
+    m_historyPanel->setFixedSize(560,360);
+    m_historyPanel->setWindowTitle("Entropy history");
+
+    m_triggerPanel = new TriggerPanel();
+    m_triggerPanel->setObjectName("triggerPanel");
+    m_triggerPanel->setFixedSize(300,330);
+    m_triggerPanel->setWindowTitle("Event triggers");
+    m_triggerPanel->setSettings(m_eventTrigger->getSettings());
+
+    m_streamStatusTimer = new QTimer(this);
+    m_streamStatusTimer->setInterval(500);
     //infoWindow->hide();
 
     boxEntropyDisplay->setStyleSheet("QGroupBox { border: 1px outset " + colorFrame.name() + "; }");
@@ -217,18 +400,27 @@ void MainWindow::initializeUI()
     boxMeters->setStyleSheet("QGroupBox { border: 1px outset " + colorFrame.name() + "; }");
 
     setStyleSheet("QMainWindow { background-color: " + colorBackground.name() + "; }"
+                        "QWidget#mainContent { background-color: " + colorBackground.name() + "; }"
                         "QWidget#optionsPanel { background-color: " + colorWidgetBackground.name() + "; }"
                         "QWidget#bitDisplay { background-color: " + colorWidgetBackground.name() + "; }"
                         "QWidget#meterDisplay { background-color: " + colorWidgetBackground.name() + "; }"
                         "QWidget#infoWindow { background-color: white; border: 2px outset grey }"
+                        "QWidget#statisticsPanel { background-color: white; border: 2px outset grey }"
+                        "QWidget#histogramPanel { background-color: white; border: 2px outset grey }"
+                        "QWidget#waveformPanel { background-color: white; border: 2px outset grey }"
+                        "QWidget#spectrogramPanel { background-color: white; border: 2px outset grey }"
+                        "QWidget#historyPanel { background-color: white; border: 2px outset grey }"
+                        "QWidget#triggerPanel { background-color: white; border: 2px outset grey }"
                         "QWidget#entropyDisplay { background-color: " + colorWidgetBackground.name() + "; }");
 
 }
 
 MainWindow::~MainWindow()
 {
+    // The probing thread must not call this object anymore
+    m_portAudioControl->cancelProbing();
     // Stop portaudio stream
-    stop();
+    m_portAudioControl->closeStream();
 }
 
 bool MainWindow::getDeviceInformation()
@@ -251,23 +443,61 @@ bool MainWindow::getDeviceInformation()
         return false;
     }
 
+    QString cacheDirectory = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(cacheDirectory);
+    m_capabilityCache.setFileName(QDir(cacheDirectory).filePath("device-cache.txt").toStdString());
+    m_capabilityCache.load();
+
+    std::vector<std::string> keys;
     for(size_t i=0; i<deviceInfo.size(); i++)
     {
         if(deviceInfo[i].maxInputChannels > 0)
         {
+            const PaHostApiInfo & apiInfo = m_portAudioControl->getApiInfo(deviceInfo[i].hostApi);
             DeviceInformation d;
             d.m_name = deviceInfo[i].name;
             d.m_deviceIndex = static_cast<int>(i);
-            d.m_hostApi = m_portAudioControl->getApiInfo(deviceInfo[i].hostApi).type;
+            d.m_hostApi = apiInfo.type;
             d.m_maxInputChannels = deviceInfo[i].maxInputChannels;
-            d.m_supportedSampleRates = m_portAudioControl->getSupportedSampleRates(static_cast<int>(i));
+            d.m_cacheKey = DeviceCapabilityCache::createKey(apiInfo.name, d.m_name);
+            // Sample rates are probed in the background if the device isn't cached
+            d.m_probed = m_capabilityCache.getSupportedSampleRates(d.m_cacheKey, d.m_supportedSampleRates);
+            keys.push_back(d.m_cacheKey);
             m_devices.push_back(d);
         }
     }
 
+    // Probe everything again if devices have been added or removed since the cache has been written
+    m_deviceSetSignature = DeviceCapabilityCache::createDeviceSetSignature(keys);
+    if(m_deviceSetSignature != m_capabilityCache.getDeviceSetSignature())
+    {
+        qDebug() << "Device set has changed, probing all devices";
+        for(auto& device : m_devices)
+        {
+            device.m_probed = false;
+        }
+    }
+
     return true;
 }
 
+void MainWindow::probeUnknownDevices()
+{
+    std::vector<int> deviceNumbers;
+    for(const auto& device : m_devices)
+    {
+        if(!device.m_probed)
+        {
+            deviceNumbers.push_back(device.m_deviceIndex);
+        }
+    }
+    if(!deviceNumbers.empty())
+    {
+        qDebug() << "Probing" << deviceNumbers.size() << "devices";
+        m_portAudioControl->probeSupportedSampleRates(deviceNumbers);
+    }
+}
+
 bool MainWindow::setOptions()
 {
     QList<QString> hostList;
@@ -303,13 +533,43 @@ void MainWindow::connectUI()
     connect(m_optionsPanel, SIGNAL(signalHostApiChanged(int)), this, SLOT(anotherApiSelected(int)));
     connect(m_optionsPanel, SIGNAL(signalInputDeviceChanged(int)), this, SLOT(anotherDeviceSelected(int)));
     connect(m_optionsPanel, SIGNAL(signalInputChannelChanged(int)), this, SLOT(anotherChannelSelected(int)));
+    connect(m_optionsPanel, SIGNAL(signalPairChannelChanged(int)), this, SLOT(anotherPairChannelSelected(int)));
+    connect(m_optionsPanel, SIGNAL(signalCaptureModeChanged(int)), this, SLOT(anotherCaptureModeSelected(int)));
+    connect(m_optionsPanel, SIGNAL(signalHardwareBufferChanged(int)), this, SLOT(anotherHardwareBufferSelected(int)));
+    connect(m_optionsPanel, SIGNAL(signalByteOrderChanged(bool)), this, SLOT(anotherByteOrderSelected(bool)));
+    connect(m_optionsPanel, SIGNAL(signalMeterFallTimeChanged(double)), this, SLOT(anotherMeterFallTimeSelected(double)));
+    connect(m_optionsPanel, SIGNAL(signalRecordingChanged(bool)), this, SLOT(recordingChanged(bool)));
+    connect(m_streamStatusTimer, SIGNAL(timeout()), this, SLOT(updateStreamStatus()));
     connect(this, SIGNAL(signalUpdatePeakMeter(double)), this, SLOT(updatePeakMeter(double)));
     connect(this, SIGNAL(signalUpdatePeakHolder(double)), this, SLOT(updatePeakHolder(double)));
     connect(this, SIGNAL(signalUpdateRmsMeter(double)), this, SLOT(updateRmsMeter(double)));
     connect(this, SIGNAL(signalUpdateRmsHolder(double)), this, SLOT(updateRmsHolder(double)));
     connect(this, SIGNAL(signalUpdateEntropyDisplay(double)), this, SLOT(updateEntropyDisplay(double)));
+    connect(this, SIGNAL(signalUpdateEntropyDisplay(double)), m_historyPanel, SLOT(updateHistory()));
+    connect(this, SIGNAL(signalUpdateEntropyProfile(std::vector<double>)), this, SLOT(updateEntropyProfile(std::vector<double>)));
+    connect(this, SIGNAL(signalUpdatePredictionEntropy(std::vector<double>,double,int)), m_entropyDisplay, SLOT(updatePredictionEntropy(std::vector<double>,double,int)));
+    connect(this, SIGNAL(signalUpdateLosslessBitrate(double,QString)), m_entropyDisplay, SLOT(updateLosslessBitrate(double,QString)));
+    connect(this, SIGNAL(signalUpdateMultiResolutionEntropy(std::vector<double>)), m_entropyDisplay, SLOT(updateMultiResolutionEntropy(std::vector<double>)));
+    connect(this, SIGNAL(signalUpdateChannelPairEntropy(double,double,double,double,int)), m_entropyDisplay, SLOT(updateChannelPairEntropy(double,double,double,double,int)));
+    connect(this, SIGNAL(signalUpdateAmplitudeHistogram(std::vector<uint32_t>,int)), m_histogramPanel, SLOT(updateHistogram(std::vector<uint32_t>,int)));
+    connect(this, SIGNAL(signalUpdateRunningMoments(RunningMoments::Result,RunningMoments::Result)), m_entropyDisplay, SLOT(updateRunningMoments(RunningMoments::Result,RunningMoments::Result)));
+    connect(this, SIGNAL(signalUpdateBitDepthEstimate(int,int,int,QString)), m_bitDisplay, SLOT(updateBitDepthEstimate(int,int,int,QString)));
+    connect(this, SIGNAL(signalUpdateBitStatistics(BitStatistics::Snapshot)), m_bitDisplay, SLOT(updateBitStatistics(BitStatistics::Snapshot)));
     connect(m_entropyDisplay, SIGNAL(signalNumberOfBlocksChanged(int)), this, SLOT(setEntropyNumberOfBlocks(int)));
+    connect(m_entropyDisplay, SIGNAL(signalDecayingChanged(bool)), this, SLOT(setEntropyDecaying(bool)));
+    connect(m_historyPanel, SIGNAL(signalExportRequested()), this, SLOT(exportHistory()));
     connect(m_optionsPanel, SIGNAL(signalInfoButtonPressed()), this, SLOT(showInfoWindow()));
+    connect(m_optionsPanel, SIGNAL(signalRescanButtonPressed()), this, SLOT(rescanDevices()));
+    connect(m_optionsPanel, SIGNAL(signalStatisticsButtonPressed()), this, SLOT(showStatisticsPanel()));
+    connect(m_optionsPanel, SIGNAL(signalHistogramButtonPressed()), this, SLOT(showHistogramPanel()));
+    connect(m_optionsPanel, SIGNAL(signalWaveformButtonPressed()), this, SLOT(showWaveformPanel()));
+    connect(m_optionsPanel, SIGNAL(signalSpectrogramButtonPressed()), this, SLOT(showSpectrogramPanel()));
+    connect(m_optionsPanel, SIGNAL(signalHistoryButtonPressed()), this, SLOT(showHistoryPanel()));
+    connect(m_optionsPanel, SIGNAL(signalTriggersButtonPressed()), this, SLOT(showTriggerPanel()));
+    connect(m_triggerPanel, SIGNAL(signalSettingsChanged()), this, SLOT(triggerSettingsChanged()));
+    connect(this, SIGNAL(signalTriggerEvent(QString)), this, SLOT(updateTriggerEvents(QString)));
+    connect(this, SIGNAL(signalSupportedSampleRatesReceived(int,std::vector<uint32_t>)), this, SLOT(updateSupportedSampleRates(int,std::vector<uint32_t>)));
+    connect(this, SIGNAL(signalProbingFinished(bool)), this, SLOT(finishProbing(bool)));
 }
 
 void MainWindow::anotherApiSelected(int api)
@@ -340,16 +600,12 @@ void MainWindow::anotherSampleRateSelected(int sampleRate)
 {
     m_parameters.m_sampleRate = sampleRate;
     setEntropyNumberOfBlocks(m_entropyDisplay->getNumberOfBlocks());
-    m_peakMeter->setReturnTimeValue((static_cast<double>(m_parameters.m_blockSize)/static_cast<double>(sampleRate))*(20.0/1.7));
-    m_rmsMeter->setReturnTimeValue((static_cast<double>(m_parameters.m_blockSize)/static_cast<double>(sampleRate))*(20.0/1.7));
 }
 
 void MainWindow::anotherBlockSizeSelected(int blockSize)
 {
     m_parameters.m_blockSize = blockSize;
     setEntropyNumberOfBlocks(m_entropyDisplay->getNumberOfBlocks());
-    m_peakMeter->setReturnTimeValue((static_cast<double>(blockSize)/static_cast<double>(m_parameters.m_sampleRate))*(20.0/1.7));
-    m_rmsMeter->setReturnTimeValue((static_cast<double>(blockSize)/static_cast<double>(m_parameters.m_sampleRate))*(20.0/1.7));
     m_bitDisplay->setSampleMaximum(blockSize);
 }
 
@@ -358,32 +614,208 @@ void MainWindow::anotherBitDepthSelected(int bits)
     m_parameters.m_bitDepth = bits;
     m_bitDisplay->setNumberOfBits(bits);
     m_entropy->setNumberOfSymbols(bits);
+    m_entropyProfile->setBitDepth(bits);
+    m_predictionEntropy->setBitDepth(bits);
+    m_losslessBitrate->setBitDepth(bits);
+    m_multiResolutionEntropy->setBitDepth(bits);
+    m_amplitudeHistogram->setBitDepth(bits);
+    m_spectrogram->setBitDepth(bits);
+    m_channelPairEntropy->setBitDepth(bits);
+    m_bitDepthEstimator->setBitDepth(bits);
     m_peakMeter->updateBitdepth(bits);
     m_rmsMeter->updateBitdepth(bits);
+    m_runningMoments->setBitDepth(bits);
+    m_historyPanel->setBitDepth(bits);
 }
 
 void MainWindow::anotherChannelSelected(int channel)
 {
+    // While the stream is running only the captured channels can be selected
+    if(!m_portAudioControl->setChannel(channel))
+    {
+        m_optionsPanel->rejectInputChannel(m_parameters.m_channel, trUtf8("Channel ") + QString::number(channel)
+                                           + trUtf8(" isn't captured, restart the stream to select it"));
+        return;
+    }
     m_parameters.m_channel = channel;
+    publishAnalysisConfiguration();
+}
+
+void MainWindow::anotherPairChannelSelected(int pairChannel)
+{
+    m_parameters.m_pairChannel = pairChannel;
+}
+
+void MainWindow::anotherCaptureModeSelected(int captureMode)
+{
+    m_parameters.m_captureMode = static_cast<PortAudioControl::CaptureMode>(captureMode);
+}
+
+void MainWindow::anotherHardwareBufferSelected(int framesPerBuffer)
+{
+    m_parameters.m_framesPerBuffer = static_cast<quint32>(framesPerBuffer);
+}
+
+void MainWindow::anotherByteOrderSelected(bool littleEndian)
+{
+    m_parameters.m_littleEndian = littleEndian;
+    publishAnalysisConfiguration();
+}
+
+void MainWindow::anotherMeterFallTimeSelected(double fallTime)
+{
+    m_parameters.m_meterFallTime = fallTime;
+    publishAnalysisConfiguration();
+}
+
+void MainWindow::publishAnalysisConfiguration()
+{
+    AnalysisConfiguration configuration;
+    configuration.m_numberOfBlocks = static_cast<int>(m_entropyDisplay->getNumberOfBlocks());
+    configuration.m_decayingEntropy = m_entropyDisplay->isDecaying();
+    configuration.m_returnTimeValue = (static_cast<double>(m_parameters.m_blockSize)/static_cast<double>(m_parameters.m_sampleRate))
+            *(20.0/m_parameters.m_meterFallTime);
+    configuration.m_channel = m_parameters.m_channel;
+    configuration.m_littleEndian = m_parameters.m_littleEndian;
+    m_analysisConfiguration.publish(configuration);
+}
+
+void MainWindow::applyAnalysisConfiguration(const AnalysisConfiguration & configuration)
+{
+    // Another channel or byte order is another signal
+    const bool signalChanged = configuration.m_channel != m_activeConfiguration.m_channel
+            || configuration.m_littleEndian != m_activeConfiguration.m_littleEndian;
+    // Entropy values must not mix samples of different windows or channels
+    if(configuration.m_numberOfBlocks != m_activeConfiguration.m_numberOfBlocks || signalChanged)
+    {
+        m_entropy->setNumberOfBlocks(configuration.m_numberOfBlocks);
+        m_entropy->clear();
+        m_entropyProfile->setNumberOfBlocks(configuration.m_numberOfBlocks);
+        m_entropyProfile->clear();
+        m_predictionEntropy->setNumberOfBlocks(configuration.m_numberOfBlocks);
+        m_predictionEntropy->clear();
+        m_losslessBitrate->setNumberOfBlocks(configuration.m_numberOfBlocks);
+        m_losslessBitrate->clear();
+        m_channelPairEntropy->setNumberOfBlocks(configuration.m_numberOfBlocks);
+        m_channelPairEntropy->clear();
+        m_amplitudeHistogram->setNumberOfBlocks(configuration.m_numberOfBlocks);
+        m_amplitudeHistogram->clear();
+        m_runningMoments->setNumberOfBlocks(configuration.m_numberOfBlocks);
+        m_runningMoments->clear();
+        m_entropyHistory->setNumberOfBlocks(configuration.m_numberOfBlocks);
+        m_bitDepthEstimator->setReportInterval(configuration.m_numberOfBlocks);
+    }
+    // Everything which is accumulated beyond one window only belongs to one signal (the channel itself is switched by the
+    // GUI thread, see anotherChannelSelected())
+    if(signalChanged)
+    {
+        m_runningMoments->reset();
+        m_multiResolutionEntropy->clear();
+        m_bitDepthEstimator->clear();
+        m_waveformPyramid->clear();
+        m_spectrogram->clear();
+        m_entropyHistory->clear();
+    }
+    if(configuration.m_decayingEntropy != m_activeConfiguration.m_decayingEntropy)
+    {
+        m_entropy->setMode(configuration.m_decayingEntropy ? Entropy::Mode::Decaying : Entropy::Mode::Blocks);
+    }
+    m_portAudioControl->setLittleEndian(configuration.m_littleEndian);
+    m_peakMeter->setReturnTimeValue(configuration.m_returnTimeValue);
+    m_rmsMeter->setReturnTimeValue(configuration.m_returnTimeValue);
+    m_activeConfiguration = configuration;
+}
+
+void MainWindow::recordingChanged(bool record)
+{
+    m_parameters.m_recording = record;
 }
 
 void MainWindow::start()
 {
     m_optionsPanel->disableUI(true);
-    m_entropyDisplay->disableUI(true);
-    if(m_portAudioControl->openStream(m_parameters.m_deviceIndex, m_parameters.m_channel, m_parameters.m_bitDepth, m_parameters.m_sampleRate, m_parameters.m_blockSize) == false)
+
+    // The analysis thread isn't running yet, the configuration is applied directly
+    publishAnalysisConfiguration();
+    m_analysisConfiguration.fetch(m_activeConfiguration);
+    m_entropy->setNumberOfBlocks(m_activeConfiguration.m_numberOfBlocks);
+    m_entropy->setMode(m_activeConfiguration.m_decayingEntropy ? Entropy::Mode::Decaying : Entropy::Mode::Blocks);
+    m_entropyProfile->setNumberOfBlocks(m_activeConfiguration.m_numberOfBlocks);
+    m_predictionEntropy->setNumberOfBlocks(m_activeConfiguration.m_numberOfBlocks);
+    m_losslessBitrate->setNumberOfBlocks(m_activeConfiguration.m_numberOfBlocks);
+    m_channelPairEntropy->setNumberOfBlocks(m_activeConfiguration.m_numberOfBlocks);
+    m_amplitudeHistogram->setNumberOfBlocks(m_activeConfiguration.m_numberOfBlocks);
+    m_runningMoments->setNumberOfBlocks(m_activeConfiguration.m_numberOfBlocks);
+    m_runningMoments->reset();
+    m_entropyHistory->setNumberOfBlocks(m_activeConfiguration.m_numberOfBlocks);
+    m_entropyHistory->start(m_parameters.m_sampleRate);
+    m_waveformPyramid->clear();
+    m_waveformPanel->setFormat(m_parameters.m_bitDepth, m_parameters.m_sampleRate);
+    m_spectrogram->clear();
+    m_spectrogramPanel->setSampleRate(m_parameters.m_sampleRate);
+    m_spectrogramPanel->clear();
+    // Accumulated over the whole run, reported as often as the entropy
+    m_bitDepthEstimator->clear();
+    m_bitDepthEstimator->setReportInterval(m_activeConfiguration.m_numberOfBlocks);
+    m_portAudioControl->setLittleEndian(m_activeConfiguration.m_littleEndian);
+    m_peakMeter->setReturnTimeValue(m_activeConfiguration.m_returnTimeValue);
+    m_rmsMeter->setReturnTimeValue(m_activeConfiguration.m_returnTimeValue);
+
+    // Every recording gets its own files
+    if(m_parameters.m_recording)
+    {
+        QString spoolDirectory = QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).filePath("spool");
+        QDir().mkpath(spoolDirectory);
+        QString prefix = QDir(spoolDirectory).filePath("capture-" + QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss"));
+        m_captureSpool.setFileNamePrefix(QDir::toNativeSeparators(prefix).toStdString());
+        m_portAudioControl->setCaptureSpool(&m_captureSpool);
+    }
+    else
+    {
+        m_portAudioControl->setCaptureSpool(nullptr);
+    }
+
+    // Events are written next to the spool files
+    QString eventDirectory = QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).filePath("events");
+    QDir().mkpath(eventDirectory);
+    EventTrigger::Settings triggerSettings = m_eventTrigger->getSettings();
+    triggerSettings.m_fileNamePrefix = QDir::toNativeSeparators(QDir(eventDirectory).filePath("event")).toStdString();
+    m_eventTrigger->setSettings(triggerSettings);
+    m_eventTrigger->start(m_parameters.m_bitDepth, m_parameters.m_sampleRate, m_parameters.m_blockSize);
+    m_triggerPanel->disableUI(true);
+
+    m_portAudioControl->setFramesPerBuffer(m_parameters.m_framesPerBuffer);
+    m_portAudioControl->setPairChannel(m_parameters.m_pairChannel);
+    if(m_portAudioControl->openStream(m_parameters.m_deviceIndex, m_parameters.m_channel, m_parameters.m_bitDepth, m_parameters.m_sampleRate, m_parameters.m_blockSize,
+                                      m_parameters.m_captureMode) == false)
     {
         m_optionsPanel->disableUI(false);
-        m_entropyDisplay->disableUI(false);
+        m_triggerPanel->disableUI(false);
+        probeUnknownDevices();
+    }
+    else
+    {
+        m_streamStatusTimer->start();
     }
 }
 
 void MainWindow::stop()
 {
+    m_streamStatusTimer->stop();
     m_portAudioControl->closeStream();
+    m_eventTrigger->stop();
     m_entropy->reset();
+    m_entropyProfile->clear();
+    m_predictionEntropy->clear();
+    m_losslessBitrate->clear();
+    m_multiResolutionEntropy->clear();
+    m_channelPairEntropy->clear();
+    m_amplitudeHistogram->clear();
+    m_runningMoments->clear();
+    m_triggerPanel->disableUI(false);
     m_optionsPanel->disableUI(false);
-    m_entropyDisplay->disableUI(false);
+    // Continue probing if it has been cancelled by opening the stream
+    probeUnknownDevices();
 }
 
 void MainWindow::showAsioPanel()
@@ -393,7 +825,15 @@ void MainWindow::showAsioPanel()
 
 void MainWindow::setEntropyNumberOfBlocks(int numberOfBlocks)
 {
-    m_entropy->setNumberOfBlocks(numberOfBlocks);
+    Q_UNUSED(numberOfBlocks);
+    publishAnalysisConfiguration();
+    m_entropyDisplay->updateIntegrationTimeLabel(static_cast<double>(m_parameters.m_blockSize)/static_cast<double>(m_parameters.m_sampleRate)*1000.0);
+}
+
+void MainWindow::setEntropyDecaying(bool decaying)
+{
+    Q_UNUSED(decaying);
+    publishAnalysisConfiguration();
     m_entropyDisplay->updateIntegrationTimeLabel(static_cast<double>(m_parameters.m_blockSize)/static_cast<double>(m_parameters.m_sampleRate)*1000.0);
 }
 
@@ -413,11 +853,120 @@ void MainWindow::showInfoWindow()
     }
 }
 
+void MainWindow::showStatisticsPanel()
+{
+    if(m_statisticsPanel->isHidden())
+    {
+        m_statisticsPanel->updateStatistics(m_portAudioControl->getStreamStatistics());
+        m_statisticsPanel->show();
+    }
+    else
+    {
+        m_statisticsPanel->hide();
+    }
+}
+
+void MainWindow::showHistogramPanel()
+{
+    if(m_histogramPanel->isHidden())
+    {
+        m_histogramPanel->show();
+    }
+    else
+    {
+        m_histogramPanel->hide();
+    }
+}
+
+void MainWindow::showWaveformPanel()
+{
+    if(m_waveformPanel->isHidden())
+    {
+        m_waveformPanel->show();
+    }
+    else
+    {
+        m_waveformPanel->hide();
+    }
+}
+
+void MainWindow::showSpectrogramPanel()
+{
+    if(m_spectrogramPanel->isHidden())
+    {
+        m_spectrogramPanel->show();
+    }
+    else
+    {
+        m_spectrogramPanel->hide();
+    }
+}
+
+void MainWindow::showHistoryPanel()
+{
+    if(m_historyPanel->isHidden())
+    {
+        m_historyPanel->show();
+    }
+    else
+    {
+        m_historyPanel->hide();
+    }
+}
+
+void MainWindow::rescanDevices()
+{
+    for(auto& device : m_devices)
+    {
+        device.m_probed = false;
+    }
+    probeUnknownDevices();
+}
+
+void MainWindow::updateSupportedSampleRates(int deviceNumber, std::vector<uint32_t> sampleRates)
+{
+    for(size_t i=0; i<m_devices.size(); i++)
+    {
+        if(m_devices[i].m_deviceIndex == deviceNumber)
+        {
+            m_devices[i].m_supportedSampleRates = sampleRates;
+            m_devices[i].m_probed = true;
+            m_capabilityCache.setSupportedSampleRates(m_devices[i].m_cacheKey, sampleRates);
+            // Populate the UI as soon as the selected device has been probed
+            if(m_parameters.m_device == static_cast<int>(i))
+            {
+                m_optionsPanel->setSampleRates(sampleRates);
+            }
+        }
+    }
+}
+
+void MainWindow::finishProbing(bool completed)
+{
+    std::vector<std::string> keys;
+    for(const auto& device : m_devices)
+    {
+        keys.push_back(device.m_cacheKey);
+    }
+    m_capabilityCache.removeOtherDevices(keys);
+    // An incomplete cache must not be accepted on the next start
+    if(completed)
+    {
+        m_capabilityCache.setDeviceSetSignature(m_deviceSetSignature);
+    }
+    m_capabilityCache.save();
+}
+
 void MainWindow::updateEntropyDisplay(double entropy)
 {
     m_entropyDisplay->updateEntropy(entropy);
 }
 
+void MainWindow::updateEntropyProfile(std::vector<double> profile)
+{
+    m_entropyDisplay->updateEntropyProfile(profile);
+}
+
 void MainWindow::updatePeakHolder(double value)
 {
     m_meterDisplay->updatePeakHolder(value);
@@ -437,3 +986,49 @@ void MainWindow::updateRmsMeter(double value)
 {
    m_meterDisplay->updateRmsMeter(value);
 }
+
+void MainWindow::showTriggerPanel()
+{
+    if(m_triggerPanel->isHidden())
+    {
+        m_triggerPanel->show();
+    }
+    else
+    {
+        m_triggerPanel->hide();
+    }
+}
+
+void MainWindow::triggerSettingsChanged()
+{
+    m_eventTrigger->setSettings(m_triggerPanel->getSettings(m_eventTrigger->getSettings()));
+}
+
+void MainWindow::updateTriggerEvents(QString fileName)
+{
+    m_triggerPanel->updateEvents(m_eventTrigger->getNumberOfEvents(), fileName);
+}
+
+void MainWindow::exportHistory()
+{
+    // Next to the events, e.g. "history/history-20140612-153012.csv"
+    QString historyDirectory = QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).filePath("history");
+    QDir().mkpath(historyDirectory);
+    QString fileName = QDir::toNativeSeparators(QDir(historyDirectory).filePath("history-" + QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss") + ".csv"));
+    if(!m_entropyHistory->writeCsv(fileName.toStdString()))
+    {
+        fileName.clear();
+    }
+    m_historyPanel->updateExport(fileName);
+}
+
+void MainWindow::updateStreamStatus()
+{
+    const DriftEstimator & driftEstimator = m_portAudioControl->getDriftEstimator();
+    m_optionsPanel->setStreamStatus(m_portAudioControl->getCpuLoad(), m_portAudioControl->getInputLatency(),
+                                    driftEstimator.getMeasurementTime() >= DriftEstimator::minimumTime, driftEstimator.getDrift());
+    if(m_statisticsPanel->isVisible())
+    {
+        m_statisticsPanel->updateStatistics(m_portAudioControl->getStreamStatistics());
+    }
+}
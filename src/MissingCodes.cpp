@@ -0,0 +1,161 @@
+/*
+ * MissingCodes: Missing code, DNL and INL analysis for ADC linearity tests
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MissingCodes.hpp"
+
+#include <algorithm>
+#include <bitset>
+
+MissingCodes::MissingCodes()
+{
+    setBitDepth(16);
+}
+
+void MissingCodes::setBitDepth(int bitDepth)
+{
+    m_bitDepth = bitDepth;
+    m_densityShift = std::max(0, bitDepth - maximumDensityBits);
+    m_mask = static_cast<uint32_t>((1ULL << bitDepth) - 1);
+    m_signBit = static_cast<uint32_t>(1ULL << (bitDepth - 1));
+    m_occupancy.assign(static_cast<size_t>(((1ULL << bitDepth) + 63)/64), 0);
+    m_density.assign(static_cast<size_t>(1ULL << (bitDepth - m_densityShift)), 0);
+    clear();
+}
+
+void MissingCodes::addSamples(const std::vector<int32_t> & signalValues)
+{
+    uint32_t minimumCode = m_minimumCode;
+    uint32_t maximumCode = m_maximumCode;
+    for(const auto& signalValue : signalValues)
+    {
+        const uint32_t code = toCode(signalValue);
+        m_occupancy[code >> 6] |= 1ULL << (code & 63);
+        m_density[code >> m_densityShift]++;
+        minimumCode = std::min(minimumCode, code);
+        maximumCode = std::max(maximumCode, code);
+    }
+    m_minimumCode = minimumCode;
+    m_maximumCode = maximumCode;
+    m_numberOfSamples += signalValues.size();
+}
+
+void MissingCodes::clear()
+{
+    std::fill(m_occupancy.begin(), m_occupancy.end(), 0);
+    std::fill(m_density.begin(), m_density.end(), 0);
+    m_numberOfSamples = 0;
+    m_minimumCode = m_mask;
+    m_maximumCode = 0;
+}
+
+MissingCodes::Result MissingCodes::getResult() const
+{
+    Result result;
+    result.m_bitDepth = m_bitDepth;
+    result.m_densityBits = m_bitDepth - m_densityShift;
+    result.m_numberOfSamples = m_numberOfSamples;
+    result.m_minimumValue = 0;
+    result.m_maximumValue = 0;
+    result.m_missingCodes = 0;
+    result.m_minimumDnl = 0.0;
+    result.m_maximumDnl = 0.0;
+    result.m_minimumInl = 0.0;
+    result.m_maximumInl = 0.0;
+    if(m_numberOfSamples == 0)
+    {
+        return result;
+    }
+    result.m_minimumValue = toValue(m_minimumCode);
+    result.m_maximumValue = toValue(m_maximumCode);
+
+    // Count the occupied codes word by word, the first and the last word are masked to the range
+    const size_t firstWord = m_minimumCode >> 6;
+    const size_t lastWord = m_maximumCode >> 6;
+    uint64_t occupiedCodes = 0;
+    for(size_t word=firstWord; word<=lastWord; word++)
+    {
+        uint64_t bits = m_occupancy[word];
+        if(word == firstWord)
+        {
+            bits &= ~0ULL << (m_minimumCode & 63);
+        }
+        if(word == lastWord)
+        {
+            bits &= ~0ULL >> (63 - (m_maximumCode & 63));
+        }
+        occupiedCodes += std::bitset<64>(bits).count();
+
+        // Missing codes are the zero bits in the range
+        uint64_t missing = ~m_occupancy[word];
+        for(uint32_t bit=0; bit<64 && missing && result.m_firstMissingValues.size() < maximumListedCodes; bit++, missing >>= 1)
+        {
+            const uint64_t code = (static_cast<uint64_t>(word) << 6) + bit;
+            if((missing & 1) && code > m_minimumCode && code < m_maximumCode)
+            {
+                result.m_firstMissingValues.push_back(toValue(static_cast<uint32_t>(code)));
+            }
+        }
+    }
+    result.m_missingCodes = (static_cast<uint64_t>(m_maximumCode) - m_minimumCode + 1) - occupiedCodes;
+
+    std::vector<double> dnl;
+    std::vector<double> inl;
+    getLinearity(dnl, inl);
+    if(!dnl.empty())
+    {
+        result.m_minimumDnl = *std::min_element(dnl.begin(), dnl.end());
+        result.m_maximumDnl = *std::max_element(dnl.begin(), dnl.end());
+        result.m_minimumInl = *std::min_element(inl.begin(), inl.end());
+        result.m_maximumInl = *std::max_element(inl.begin(), inl.end());
+    }
+    return result;
+}
+
+void MissingCodes::getLinearity(std::vector<double> & dnl, std::vector<double> & inl) const
+{
+    dnl.clear();
+    inl.clear();
+    if(m_numberOfSamples == 0)
+    {
+        return;
+    }
+    // Without the end codes, which also count everything beyond the range of the stimulus
+    const uint32_t first = (m_minimumCode >> m_densityShift) + 1;
+    const uint32_t last = (m_maximumCode >> m_densityShift) - 1;
+    if(last < first || last + 1 == 0)
+    {
+        return;
+    }
+
+    uint64_t numberOfHits = 0;
+    for(uint32_t code=first; code<=last; code++)
+    {
+        numberOfHits += m_density[code];
+    }
+    const double idealHits = static_cast<double>(numberOfHits)/(last - first + 1);
+    double sum = 0.0;
+    for(uint32_t code=first; code<=last; code++)
+    {
+        const double codeDnl = m_density[code]/idealHits - 1.0;
+        dnl.push_back(codeDnl);
+        sum += codeDnl;
+        inl.push_back(sum);
+    }
+}
@@ -0,0 +1,101 @@
+/*
+ * MultiResolutionEntropy: Entropy over several window lengths at once
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MultiResolutionEntropy.hpp"
+
+#include <cstddef>
+
+MultiResolutionEntropy::MultiResolutionEntropy(MultiResolutionEntropyListener *listener)
+    : m_multiResolutionEntropyListener(listener)
+    , m_bitDepth(16)
+{
+    setNumberOfLevels(4);
+}
+
+void MultiResolutionEntropy::addSamples(const std::vector<int32_t> & signalValues)
+{
+    if(!m_multiResolutionEntropyListener || m_levels.empty())
+    {
+        return;
+    }
+
+    m_levels[0].m_histogram.addSamples(signalValues);
+    ++m_levels[0].m_numberOfParts;
+
+    // Level 0 is complete after every block, level k after every levelFactor^k blocks
+    for(size_t level=0; level<m_levels.size(); level++)
+    {
+        Level & current = m_levels[level];
+        if(current.m_numberOfParts < (level == 0 ? 1 : levelFactor))
+        {
+            break;
+        }
+        m_entropies[level] = current.m_histogram.getEntropy();
+        if(level + 1 < m_levels.size())
+        {
+            m_levels[level+1].m_histogram.addHistogram(current.m_histogram);
+            ++m_levels[level+1].m_numberOfParts;
+        }
+        current.m_histogram.clear();
+        current.m_numberOfParts = 0;
+    }
+    m_multiResolutionEntropyListener->receiveMultiResolutionEntropy(m_entropies);
+}
+
+void MultiResolutionEntropy::setNumberOfLevels(int numberOfLevels)
+{
+    m_levels.resize(numberOfLevels);
+    setBitDepth(m_bitDepth);
+}
+
+int MultiResolutionEntropy::getNumberOfLevels() const
+{
+    return static_cast<int>(m_levels.size());
+}
+
+int MultiResolutionEntropy::getNumberOfBlocks(int level)
+{
+    int numberOfBlocks = 1;
+    for(int i=0; i<level; i++)
+    {
+        numberOfBlocks *= levelFactor;
+    }
+    return numberOfBlocks;
+}
+
+void MultiResolutionEntropy::setBitDepth(int bitDepth)
+{
+    m_bitDepth = bitDepth;
+    for(auto& level : m_levels)
+    {
+        level.m_histogram.setBitDepth(bitDepth);
+    }
+    clear();
+}
+
+void MultiResolutionEntropy::clear()
+{
+    for(auto& level : m_levels)
+    {
+        level.m_histogram.clear();
+        level.m_numberOfParts = 0;
+    }
+    m_entropies.assign(m_levels.size(), -1.0);
+}
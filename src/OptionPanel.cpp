@@ -21,13 +21,16 @@
 #include "OptionPanel.hpp"
 
 //#include <QLineEdit>
-//#include <QLabel>
+#include <QLabel>
 #include <QLayout>
 #include <QFormLayout>
+#include <QCheckBox>
 #include <QComboBox>
+#include <QDoubleSpinBox>
 #include <QSpinBox>
 #include <QPushButton>
 #include <QPainter>
+#include <QToolTip>
 //#include <QDebug>
 
 const QColor colorFont(255,255,255);
@@ -43,37 +46,88 @@ OptionPanel::OptionPanel(QWidget *parent)
     m_boxBlockSize->setMinimum(128);
     m_boxBlockSize->setMaximum(65636);
     m_boxBlockSize->setValue(2048);
+    m_boxCaptureMode = new QComboBox(this);
+    m_boxCaptureMode->addItem(trUtf8("Callback"));
+    m_boxCaptureMode->addItem(trUtf8("Blocking read"));
+    // Frames per PortAudio buffer as item data, 0 lets the host API choose
+    m_boxHardwareBuffer = new QComboBox(this);
+    m_boxHardwareBuffer->addItem(trUtf8("Automatic"), 0);
+    for(int frames=64; frames<=4096; frames*=2)
+    {
+        m_boxHardwareBuffer->addItem(QString::number(frames), frames);
+    }
+    m_boxHardwareBuffer->setToolTip(trUtf8("Frames per driver buffer, the blocks are assembled independently of it"));
+    // Byte order, meter fall time and input channel can be changed while the stream is running
+    m_boxByteOrder = new QComboBox(this);
+    m_boxByteOrder->addItem(trUtf8("Little endian"));
+    m_boxByteOrder->addItem(trUtf8("Big endian"));
+    m_boxMeterFallTime = new QDoubleSpinBox(this);
+    m_boxMeterFallTime->setRange(0.1, 10.0);
+    m_boxMeterFallTime->setSingleStep(0.1);
+    m_boxMeterFallTime->setValue(1.7);
+    m_boxMeterFallTime->setSuffix(trUtf8(" s / 20 dB"));
+    m_checkBoxRecord = new QCheckBox(this);
+    m_checkBoxRecord->setToolTip(trUtf8("Record the decoded samples into spool files which can be analyzed later"));
+    m_labelStreamStatus = new QLabel(trUtf8("CPU load: - | Latency: - | Drift: -"), this);
     m_boxHostAPI = new QComboBox(this);
     m_boxSampleRate = new QComboBox(this);
     m_boxInputChannel = new QComboBox(this);
+    m_boxPairChannel = new QComboBox(this);
+    m_boxPairChannel->setToolTip(trUtf8("Second channel for the joint entropy and the mutual information, applied when the stream is started"));
     m_buttonStart = new QPushButton(trUtf8("Start"), this);
     m_buttonStop = new QPushButton(trUtf8("Stop"), this);
     m_buttonInfo = new QPushButton(trUtf8("?"), this);
+    m_buttonRescan = new QPushButton(trUtf8("Rescan devices"), this);
+    m_buttonStatistics = new QPushButton(trUtf8("Statistics"), this);
+    m_buttonHistogram = new QPushButton(trUtf8("Histogram"), this);
+    m_buttonWaveform = new QPushButton(trUtf8("Waveform"), this);
+    m_buttonSpectrogram = new QPushButton(trUtf8("Spectrogram"), this);
+    m_buttonHistory = new QPushButton(trUtf8("History"), this);
+    m_buttonTriggers = new QPushButton(trUtf8("Triggers"), this);
     //m_buttonShowAsioPanel = new QPushButton(trUtf8("Show ASIO Panel"), this);
 
     m_formLayout = new QFormLayout();
     m_formLayout->addRow(trUtf8("Host API:"), m_boxHostAPI);
     m_formLayout->addRow(trUtf8("Input device:"), m_boxAudioInputDevice);
     m_formLayout->addRow(trUtf8("Input channel:"), m_boxInputChannel);
+    m_formLayout->addRow(trUtf8("Pair channel:"), m_boxPairChannel);
     m_formLayout->addRow(trUtf8("Bit depth:"), m_boxBitDepth);
     m_formLayout->addRow(trUtf8("Sample rate:"), m_boxSampleRate);
     m_formLayout->addRow(trUtf8("Block size:"), m_boxBlockSize);
+    m_formLayout->addRow(trUtf8("Capture mode:"), m_boxCaptureMode);
+    m_formLayout->addRow(trUtf8("Hardware buffer:"), m_boxHardwareBuffer);
+    m_formLayout->addRow(trUtf8("Byte order:"), m_boxByteOrder);
+    m_formLayout->addRow(trUtf8("Meter fall time:"), m_boxMeterFallTime);
+    m_formLayout->addRow(trUtf8("Record to disk:"), m_checkBoxRecord);
     //m_formLayout->addRow(trUtf8(""), m_buttonShowAsioPanel);
 
     m_buttonLayout = new QHBoxLayout();
     m_buttonLayout->addWidget(m_buttonStart);
     m_buttonLayout->addWidget(m_buttonStop);
 
-    QVBoxLayout *buttonInfoLayout = new QVBoxLayout();
+    QHBoxLayout *buttonInfoLayout = new QHBoxLayout();
     buttonInfoLayout->addWidget(m_buttonInfo);
+    buttonInfoLayout->addWidget(m_buttonRescan);
+    buttonInfoLayout->addWidget(m_buttonStatistics);
+    buttonInfoLayout->addWidget(m_buttonTriggers);
     buttonInfoLayout->setAlignment(Qt::AlignLeft);
     m_buttonInfo->setMaximumWidth(30);
 
+    // Windows with views of the signal
+    QHBoxLayout *buttonViewLayout = new QHBoxLayout();
+    buttonViewLayout->addWidget(m_buttonHistogram);
+    buttonViewLayout->addWidget(m_buttonWaveform);
+    buttonViewLayout->addWidget(m_buttonSpectrogram);
+    buttonViewLayout->addWidget(m_buttonHistory);
+    buttonViewLayout->setAlignment(Qt::AlignLeft);
+
     QVBoxLayout *mainVLayout = new QVBoxLayout();
     m_mainLayout = new QVBoxLayout(this);
     mainVLayout->addLayout(m_formLayout);
     mainVLayout->addLayout(m_buttonLayout);
+    mainVLayout->addWidget(m_labelStreamStatus);
     mainVLayout->addLayout(buttonInfoLayout);
+    mainVLayout->addLayout(buttonViewLayout);
     mainVLayout->setAlignment(Qt::AlignTop);
 
     m_mainLayout->addLayout(mainVLayout);
@@ -81,12 +135,25 @@ OptionPanel::OptionPanel(QWidget *parent)
     connect(m_boxHostAPI, SIGNAL(currentIndexChanged(int)), this, SLOT(emitHostApiChanged(int)));
     connect(m_boxAudioInputDevice, SIGNAL(currentIndexChanged(int)), this, SLOT(emitInputDeviceChanged(int)));
     connect(m_boxInputChannel, SIGNAL(currentIndexChanged(QString)), this, SLOT(emitInputChannelChanged(QString)));
+    connect(m_boxPairChannel, SIGNAL(currentIndexChanged(int)), this, SLOT(emitPairChannelChanged(int)));
     connect(m_boxBitDepth, SIGNAL(currentIndexChanged(QString)), this, SLOT(emitBitDepthChanged(QString)));
     connect(m_boxSampleRate, SIGNAL(currentIndexChanged(QString)), this, SLOT(emitSampleRateChanged(QString)));
     connect(m_boxBlockSize, SIGNAL(valueChanged(int)), this, SLOT(emitBlockSizeChanged(int)));
+    connect(m_boxCaptureMode, SIGNAL(currentIndexChanged(int)), this, SLOT(emitCaptureModeChanged(int)));
+    connect(m_boxHardwareBuffer, SIGNAL(currentIndexChanged(int)), this, SLOT(emitHardwareBufferChanged(int)));
+    connect(m_boxByteOrder, SIGNAL(currentIndexChanged(int)), this, SLOT(emitByteOrderChanged(int)));
+    connect(m_boxMeterFallTime, SIGNAL(valueChanged(double)), this, SLOT(emitMeterFallTimeChanged(double)));
+    connect(m_checkBoxRecord, SIGNAL(toggled(bool)), this, SLOT(emitRecordingChanged(bool)));
     connect(m_buttonStart, SIGNAL(clicked()), this, SLOT(emitStartButtonPressed()));
     connect(m_buttonStop, SIGNAL(clicked()), this, SLOT(emitStopButtonPressed()));
     connect(m_buttonInfo, SIGNAL(clicked()), this, SLOT(emitInfoButtonPressed()));
+    connect(m_buttonRescan, SIGNAL(clicked()), this, SLOT(emitRescanButtonPressed()));
+    connect(m_buttonStatistics, SIGNAL(clicked()), this, SLOT(emitStatisticsButtonPressed()));
+    connect(m_buttonHistogram, SIGNAL(clicked()), this, SLOT(emitHistogramButtonPressed()));
+    connect(m_buttonWaveform, SIGNAL(clicked()), this, SLOT(emitWaveformButtonPressed()));
+    connect(m_buttonSpectrogram, SIGNAL(clicked()), this, SLOT(emitSpectrogramButtonPressed()));
+    connect(m_buttonHistory, SIGNAL(clicked()), this, SLOT(emitHistoryButtonPressed()));
+    connect(m_buttonTriggers, SIGNAL(clicked()), this, SLOT(emitTriggersButtonPressed()));
 }
 
 void OptionPanel::paintEvent(QPaintEvent *)
@@ -122,6 +189,25 @@ void OptionPanel::setChannels(int numberOfChannels)
     {
         m_boxInputChannel->addItem(QString::number(i+1));
     }
+    m_boxPairChannel->clear();
+    m_boxPairChannel->addItem(trUtf8("None"), 0);
+    for(int i=0; i<numberOfChannels; i++)
+    {
+        m_boxPairChannel->addItem(QString::number(i+1), i+1);
+    }
+}
+
+void OptionPanel::rejectInputChannel(int channel, QString reason)
+{
+    // The box is empty while it's filled again
+    if(m_boxInputChannel->count() == 0)
+    {
+        return;
+    }
+    m_boxInputChannel->blockSignals(true);
+    m_boxInputChannel->setCurrentIndex(channel - 1);
+    m_boxInputChannel->blockSignals(false);
+    QToolTip::showText(m_boxInputChannel->mapToGlobal(QPoint(0, m_boxInputChannel->height())), reason, m_boxInputChannel);
 }
 
 void OptionPanel::setBitDepths(QList<int> bitDepths)
@@ -150,6 +236,12 @@ void OptionPanel::setSampleRates(const std::vector<uint32_t> & sampleRates)
     }
 }
 
+void OptionPanel::setStreamStatus(double cpuLoad, double latency, bool driftValid, double drift)
+{
+    m_labelStreamStatus->setText("CPU load: " + QString::number(cpuLoad*100.0,'f',1) + " % | Latency: " + QString::number(latency*1000.0,'f',1) + " ms"
+                                 + " | Drift: " + (driftValid ? QString::number(drift,'f',1) + " ppm" : QString("-")));
+}
+
 void OptionPanel::disableStartButton(bool disable)
 {
     m_buttonStart->setDisabled(disable);
@@ -165,9 +257,13 @@ void OptionPanel::disableUI(bool disable)
     m_boxAudioInputDevice->setDisabled(disable);
     m_boxBitDepth->setDisabled(disable);
     m_boxBlockSize->setDisabled(disable);
+    m_boxCaptureMode->setDisabled(disable);
+    m_boxHardwareBuffer->setDisabled(disable);
+    m_boxPairChannel->setDisabled(disable);
+    m_checkBoxRecord->setDisabled(disable);
     m_boxHostAPI->setDisabled(disable);
-    m_boxInputChannel->setDisabled(disable);
     m_boxSampleRate->setDisabled(disable);
+    m_buttonRescan->setDisabled(disable);
     m_buttonStart->setDisabled(disable);
     m_buttonStop->setDisabled(!disable);
 }
@@ -187,6 +283,11 @@ void OptionPanel::emitInputChannelChanged(QString channel)
     emit signalInputChannelChanged(channel.toInt());
 }
 
+void OptionPanel::emitPairChannelChanged(int index)
+{
+    emit signalPairChannelChanged(m_boxPairChannel->itemData(index).toInt());
+}
+
 void OptionPanel::emitBitDepthChanged(QString bitDepth)
 {
     emit signalBitDepthChanged(bitDepth.toInt());
@@ -202,6 +303,31 @@ void OptionPanel::emitBlockSizeChanged(int blockSize)
     emit signalBlockSizeChanged(blockSize);
 }
 
+void OptionPanel::emitCaptureModeChanged(int index)
+{
+    emit signalCaptureModeChanged(index);
+}
+
+void OptionPanel::emitHardwareBufferChanged(int index)
+{
+    emit signalHardwareBufferChanged(m_boxHardwareBuffer->itemData(index).toInt());
+}
+
+void OptionPanel::emitByteOrderChanged(int index)
+{
+    emit signalByteOrderChanged(index == 0);
+}
+
+void OptionPanel::emitMeterFallTimeChanged(double fallTime)
+{
+    emit signalMeterFallTimeChanged(fallTime);
+}
+
+void OptionPanel::emitRecordingChanged(bool record)
+{
+    emit signalRecordingChanged(record);
+}
+
 void OptionPanel::emitStartButtonPressed()
 {
     emit signalStartButtonPressed();
@@ -216,3 +342,38 @@ void OptionPanel::emitInfoButtonPressed()
 {
     emit signalInfoButtonPressed();
 }
+
+void OptionPanel::emitRescanButtonPressed()
+{
+    emit signalRescanButtonPressed();
+}
+
+void OptionPanel::emitStatisticsButtonPressed()
+{
+    emit signalStatisticsButtonPressed();
+}
+
+void OptionPanel::emitHistogramButtonPressed()
+{
+    emit signalHistogramButtonPressed();
+}
+
+void OptionPanel::emitWaveformButtonPressed()
+{
+    emit signalWaveformButtonPressed();
+}
+
+void OptionPanel::emitSpectrogramButtonPressed()
+{
+    emit signalSpectrogramButtonPressed();
+}
+
+void OptionPanel::emitHistoryButtonPressed()
+{
+    emit signalHistoryButtonPressed();
+}
+
+void OptionPanel::emitTriggersButtonPressed()
+{
+    emit signalTriggersButtonPressed();
+}
@@ -34,6 +34,7 @@ PeakMeter::PeakMeter(PeakMeterListener *listener)
     , m_maxValue(0)
     , m_absoluteValue(0)
     , m_maximumDynamicRange(0.0)
+    , m_blockPeak(INF)
 {
 }
 
@@ -46,7 +47,19 @@ void PeakMeter::updateMeter(const std::vector<int32_t> & signalValues)
 
     // Get the maximum value of the samples
     m_currentValue = getMaximum(signalValues);
-    emitPeakValue(calculatePeak(m_currentValue, m_referenceValue));
+    m_blockPeak = calculatePeak(m_currentValue, m_referenceValue);
+    emitPeakValue(m_blockPeak);
+}
+
+bool PeakMeter::isClipping() const
+{
+    // The negative full scale value is one step larger than the positive one
+    return m_referenceValue > 0 && m_currentValue >= m_referenceValue-1;
+}
+
+double PeakMeter::getBlockPeak() const
+{
+    return m_blockPeak;
 }
 
 void PeakMeter::updateBitdepth(int bitdepth)
@@ -20,18 +20,65 @@
 
 #include "PortAudioControl.hpp"
 
+#include <chrono>
 #include <iostream>
 
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Number of blocks read at once in CaptureMode::BlockingRead
+static const unsigned long blocksPerRead = 4;
+
+// Raise the priority of the calling thread, failing is not an error (e.g. missing privileges)
+static void setHighThreadPriority()
+{
+#ifdef _WIN32
+    if(!SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL))
+    {
+        std::cout << "Could not raise priority of reader thread" << std::endl;
+    }
+#else
+    sched_param parameters;
+    parameters.sched_priority = sched_get_priority_max(SCHED_FIFO) - 1;
+    if(pthread_setschedparam(pthread_self(), SCHED_FIFO, &parameters) != 0)
+    {
+        std::cout << "Could not raise priority of reader thread" << std::endl;
+    }
+#endif
+}
+
 PortAudioControl::PortAudioControl(PortAudioControlListener *listener)
-    : RingBufferReceiver()
+    : SampleSource(listener)
     , m_controlListener(listener)
     , m_stream(nullptr)
-    , m_buffer(new RingBuffer(50000, this))
+    , m_deviceNumber(0)
+    , m_channel(1)
+    , m_statistics(new StreamStatistics())
+    , m_cancelProbing(false)
+    , m_captureMode(CaptureMode::Callback)
+    , m_framesPerBuffer(paFramesPerBufferUnspecified)
+    , m_readerRunning(false)
+    , m_framesPerRead(0)
+    , m_readerCpuLoad(0.0)
 {
     m_data.m_buffer = m_buffer;
-    m_data.m_littleEndian = true;
+    m_data.m_statistics = m_statistics;
     m_data.m_bitDepth = 16;
-    m_data.m_channel = 0;
+    m_data.m_littleEndian = true;
+    m_data.m_channel = 1;
+    m_data.m_channelCount = 1;
+    m_data.m_pairChannel = 0;
+}
+
+PortAudioControl::~PortAudioControl()
+{
+    cancelProbing();
+    closeStream();
 }
 
 bool PortAudioControl::initialize()
@@ -75,7 +122,29 @@ const PaHostApiInfo & PortAudioControl::getApiInfo(int apiIndex)
 
 const std::vector<uint32_t> & PortAudioControl::getSupportedSampleRates(int deviceNumber)
 {
-    m_supportedSampleRates.clear();
+    m_supportedSampleRates = querySupportedSampleRates(deviceNumber);
+    return m_supportedSampleRates;
+}
+
+void PortAudioControl::probeSupportedSampleRates(const std::vector<int> & deviceNumbers)
+{
+    cancelProbing();
+    m_cancelProbing = false;
+    m_probingThread = std::thread(&PortAudioControl::probeDevices, this, deviceNumbers);
+}
+
+void PortAudioControl::cancelProbing()
+{
+    m_cancelProbing = true;
+    if(m_probingThread.joinable())
+    {
+        m_probingThread.join();
+    }
+}
+
+std::vector<uint32_t> PortAudioControl::querySupportedSampleRates(int deviceNumber)
+{
+    std::vector<uint32_t> supportedSampleRates;
 
     const PaDeviceInfo *deviceInfo = Pa_GetDeviceInfo(deviceNumber);
 
@@ -87,29 +156,68 @@ const std::vector<uint32_t> & PortAudioControl::getSupportedSampleRates(int devi
     inputParameters.hostApiSpecificStreamInfo = nullptr;
 
     // Sample rates to test
-    static std::vector<double> standardSampleRates =
+    static const std::vector<double> standardSampleRates =
     {
         8000.0, 9600.0, 11025.0, 12000.0, 16000.0, 22050.0, 24000.0, 32000.0,
-        44100.0, 48000.0, 88200.0, 96000.0, 192000.0, -1
+        44100.0, 48000.0, 88200.0, 96000.0, 192000.0
     };
 
     PaError err;
 
     for(const auto& sampleRate : standardSampleRates)
     {
+        if(m_cancelProbing)
+        {
+            break;
+        }
         err = Pa_IsFormatSupported(&inputParameters, NULL, sampleRate);
         if(err == paFormatIsSupported)
         {
-            m_supportedSampleRates.push_back(static_cast<uint32_t>(sampleRate));
+            supportedSampleRates.push_back(static_cast<uint32_t>(sampleRate));
         }
     }
 
-    return m_supportedSampleRates;
+    return supportedSampleRates;
 }
 
-bool PortAudioControl::openStream(int deviceNumber, int channel, int bitDepth, uint32_t sampleRate, uint32_t blockSize)
+void PortAudioControl::probeDevices(std::vector<int> deviceNumbers)
 {
-    m_buffer->clearAndResize(blockSize);
+    for(const auto& deviceNumber : deviceNumbers)
+    {
+        std::vector<uint32_t> sampleRates = querySupportedSampleRates(deviceNumber);
+        // Don't pass incomplete results
+        if(m_cancelProbing)
+        {
+            break;
+        }
+        if(m_controlListener)
+        {
+            m_controlListener->receiveSupportedSampleRates(deviceNumber, sampleRates);
+        }
+    }
+
+    if(m_controlListener)
+    {
+        m_controlListener->receiveProbingFinished(!m_cancelProbing);
+    }
+}
+
+bool PortAudioControl::openStream(int deviceNumber, int channel, int bitDepth, uint32_t sampleRate, uint32_t blockSize,
+                                  CaptureMode captureMode)
+{
+    // PortAudio isn't thread-safe, the stream must not be opened while devices are being probed
+    cancelProbing();
+
+    // Pa_OpenStream overwrites the pointer, a stream which is still open would never be closed
+    if(m_stream)
+    {
+        closeStream();
+    }
+    else
+    {
+        stopReceiving();
+    }
+    m_captureMode = captureMode;
 
     PaSampleFormat sampleFormat;
     switch(bitDepth)
@@ -129,65 +237,242 @@ bool PortAudioControl::openStream(int deviceNumber, int channel, int bitDepth, u
             break;
     }
 
+    // Device numbers from the command line aren't validated by the GUI
+    if(!Pa_GetDeviceInfo(deviceNumber))
+    {
+        std::cout << "ERROR: Invalid device " << deviceNumber << std::endl;
+        return false;
+    }
+
+    // All channels are captured, so another channel can be selected without reopening the stream
+    const int requiredChannels = std::max(channel, m_pairChannel);
     PaStreamParameters inputParameters;
     inputParameters.device = deviceNumber;
-    inputParameters.channelCount = channel;
+    inputParameters.channelCount = std::max(requiredChannels, Pa_GetDeviceInfo(deviceNumber)->maxInputChannels);
     inputParameters.sampleFormat = sampleFormat;
     inputParameters.suggestedLatency = Pa_GetDeviceInfo(inputParameters.device)->defaultLowInputLatency;
     inputParameters.hostApiSpecificStreamInfo = nullptr;
 
-    m_data.m_bitDepth = bitDepth;
-    m_data.m_littleEndian = true;
-    m_data.m_channel = channel;
-
     // Test if the chosen input parameters are supported before opening stream
     if(Pa_IsFormatSupported(&inputParameters, nullptr, sampleRate) != paFormatIsSupported)
     {
-        std::cout << "Format not supported" << std::endl;
-        return false;
+        // Some devices only support a few channels in certain formats
+        inputParameters.channelCount = requiredChannels;
+        if(Pa_IsFormatSupported(&inputParameters, nullptr, sampleRate) != paFormatIsSupported)
+        {
+            std::cout << "Format not supported" << std::endl;
+            return false;
+        }
     }
 
+    m_data.m_bitDepth = bitDepth;
+    m_data.m_channel = channel;
+    m_data.m_channelCount = inputParameters.channelCount;
+    m_data.m_pairChannel = m_pairChannel;
+
     std::cout << Pa_GetDeviceInfo(deviceNumber)->name << std::endl;
 
-    PaError err = Pa_OpenStream(&m_stream, &inputParameters, NULL, sampleRate, blockSize, paNoFlag, PortAudioIO::getInputCallback, &m_data);
+    // A stream without callback function is read with Pa_ReadStream
+    PaStreamCallback *callback = nullptr;
+    if(captureMode == CaptureMode::Callback)
+    {
+        callback = PortAudioIO::getInputCallback;
+    }
+
+    // The buffers of PortAudio are re-blocked by the ring buffer, so the host API can use its optimal buffer size
+    // and the callback may be called with a different number of frames every time
+    PaError err = Pa_OpenStream(&m_stream, &inputParameters, NULL, sampleRate, m_framesPerBuffer, paNoFlag, callback, &m_data);
     if(err != paNoError)
     {
         std::cout << Pa_GetErrorText(err) << std::endl;
         std::cout << Pa_GetLastHostErrorInfo()->errorText << std::endl;
+        m_stream = nullptr;
         return false;
     }
     else
     {
         std::cout << "- Stream openend -" << std::endl;
-        std::cout << "Name:" << Pa_GetDeviceInfo(inputParameters.device)->name << "| Sample rate:" << sampleRate << "| Bitdepth:" << bitDepth << "| Input channel:" << channel << std::endl;
+        std::cout << "Name:" << Pa_GetDeviceInfo(inputParameters.device)->name << "| Sample rate:" << sampleRate << "| Bitdepth:" << bitDepth << "| Input channel:" << channel << "/" << inputParameters.channelCount
+                  << "| Pair channel:" << (m_pairChannel > 0 ? std::to_string(m_pairChannel) : std::string("none"))
+                  << "| Capture mode:" << (captureMode == CaptureMode::Callback ? "Callback" : "Blocking read")
+                  << "| Frames per buffer:" << (m_framesPerBuffer == paFramesPerBufferUnspecified ? std::string("automatic") : std::to_string(m_framesPerBuffer))
+                  << "| Block size:" << blockSize << std::endl;
     }
 
+    // Blocks are passed to the listener by the receiver thread of the ring buffer
+    startReceiving(bitDepth, sampleRate, blockSize);
+    m_statistics->reset(sampleRate);
+
     err = Pa_StartStream(m_stream);
     if(err != paNoError)
     {
         std::cout << "ERROR: Could not start stream!" << std::endl;
+        closeStream();
         return false;
     }
+
+    if(captureMode == CaptureMode::BlockingRead)
+    {
+        // Fewer but larger reads, each read decodes several blocks at once
+        m_framesPerRead = blockSize*blocksPerRead;
+        m_readBuffer.assign(m_framesPerRead*m_data.m_channelCount*(bitDepth/8), 0);
+        m_readerCpuLoad = 0.0;
+        m_readerRunning = true;
+        m_readerThread = std::thread(&PortAudioControl::runReaderThread, this);
+    }
     return true;
 }
 
 void PortAudioControl::closeStream()
 {
-    if(Pa_IsStreamActive(m_stream))
+    // Pa_ReadStream must not be called anymore when the stream is closed
+    m_readerRunning = false;
+    if(m_readerThread.joinable())
+    {
+        m_readerThread.join();
+    }
+
+    if(m_stream)
     {
         Pa_CloseStream(m_stream);
+        m_stream = nullptr;
         std::cout << "- Stream closed -" << std::endl;
     }
     else
     {
         std::cout << "- Stream already closed -" << std::endl;
     }
+
+    stopReceiving();
 }
 
-void PortAudioControl::receiveSamples(const std::vector<int32_t> & samples)
+void PortAudioControl::setDevice(int deviceNumber, int channel)
 {
-    if(m_controlListener)
+    m_deviceNumber = deviceNumber;
+    m_channel = channel;
+}
+
+bool PortAudioControl::setChannel(int channel)
+{
+    if(!m_stream)
+    {
+        m_channel = channel;
+        return true;
+    }
+    if(channel < 1 || channel > m_data.m_channelCount)
     {
-        m_controlListener->receivePortAudioSamples(samples);
+        return false;
+    }
+    m_channel = channel;
+    m_data.m_channel = channel;
+    return true;
+}
+
+void PortAudioControl::setLittleEndian(bool littleEndian)
+{
+    m_data.m_littleEndian = littleEndian;
+}
+
+void PortAudioControl::setCaptureMode(CaptureMode captureMode)
+{
+    m_captureMode = captureMode;
+}
+
+void PortAudioControl::setFramesPerBuffer(unsigned long framesPerBuffer)
+{
+    m_framesPerBuffer = framesPerBuffer;
+}
+
+bool PortAudioControl::open(int bitDepth, uint32_t sampleRate, uint32_t blockSize)
+{
+    return openStream(m_deviceNumber, m_channel, bitDepth, sampleRate, blockSize, m_captureMode);
+}
+
+void PortAudioControl::close()
+{
+    closeStream();
+}
+
+std::string PortAudioControl::getName() const
+{
+    const PaDeviceInfo *deviceInfo = Pa_GetDeviceInfo(m_deviceNumber);
+    return std::string("PortAudio ") + (deviceInfo ? deviceInfo->name : "(no device)");
+}
+
+double PortAudioControl::getCpuLoad() const
+{
+    if(!m_stream)
+    {
+        return 0.0;
+    }
+    if(m_captureMode == CaptureMode::BlockingRead)
+    {
+        return m_readerCpuLoad;
+    }
+    return Pa_GetStreamCpuLoad(m_stream);
+}
+
+double PortAudioControl::getInputLatency() const
+{
+    if(!m_stream || m_sampleRate == 0)
+    {
+        return 0.0;
+    }
+    // Null if the stream isn't valid anymore
+    const PaStreamInfo *streamInfo = Pa_GetStreamInfo(m_stream);
+    if(!streamInfo)
+    {
+        return 0.0;
+    }
+    double latency = streamInfo->inputLatency;
+    // Samples wait in the read buffer until the whole batch has been read
+    if(m_captureMode == CaptureMode::BlockingRead)
+    {
+        latency += static_cast<double>(m_framesPerRead)/m_sampleRate;
+    }
+    return latency;
+}
+
+StreamStatistics::Snapshot PortAudioControl::getStreamStatistics() const
+{
+    StreamStatistics::Snapshot snapshot = m_statistics->getSnapshot();
+    snapshot.m_cpuLoad = getCpuLoad();
+    snapshot.m_queuedBlocks = getQueue().getNumberOfQueuedBlocks();
+    snapshot.m_numberOfBlocks = getQueue().getNumberOfBlocks();
+    snapshot.m_droppedBlocks = getQueue().getNumberOfDroppedBlocks();
+    return snapshot;
+}
+
+void PortAudioControl::runReaderThread()
+{
+    setHighThreadPriority();
+
+    std::chrono::steady_clock::time_point lastDecodeEnd = std::chrono::steady_clock::now();
+    while(m_readerRunning)
+    {
+        PaError err = Pa_ReadStream(m_stream, m_readBuffer.data(), m_framesPerRead);
+        // An overflow only means that samples have been lost, the read data is still valid
+        if(err != paNoError && err != paInputOverflowed)
+        {
+            std::cout << "ERROR: Could not read stream: " << Pa_GetErrorText(err) << std::endl;
+            break;
+        }
+
+        // The last sample which has been read has just been captured
+        m_buffer->setInputTime(Pa_GetStreamTime(m_stream) - static_cast<double>(m_framesPerRead)/m_sampleRate);
+        std::chrono::steady_clock::time_point decodeStart = std::chrono::steady_clock::now();
+        PortAudioIO::decodeSamples(m_readBuffer.data(), m_framesPerRead, &m_data);
+        std::chrono::steady_clock::time_point decodeEnd = std::chrono::steady_clock::now();
+        m_statistics->addCallback(m_framesPerRead, err == paInputOverflowed, false, decodeStart, decodeEnd,
+                                  getQueue().getNumberOfQueuedBlocks());
+
+        // Same definition as Pa_GetStreamCpuLoad: processing time relative to the time between two buffers
+        double busy = std::chrono::duration<double>(decodeEnd - decodeStart).count();
+        double period = std::chrono::duration<double>(decodeEnd - lastDecodeEnd).count();
+        lastDecodeEnd = decodeEnd;
+        if(period > 0.0)
+        {
+            m_readerCpuLoad = 0.9*m_readerCpuLoad + 0.1*(busy/period);
+        }
     }
 }
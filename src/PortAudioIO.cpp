@@ -20,15 +20,81 @@
 
 #include "PortAudioIO.hpp"
 #include "RingBuffer.hpp"
+#include "StreamStatistics.hpp"
 
-// static variables
-uint32_t PortAudioIO::sampleCounter = 0;
+#include <algorithm>
+#include <chrono>
 
 // Used to clear the signed bits after converting a signed integer to unsigned (AND operation)
 static const uint32_t clearFirst24BitsOf32BitsAND = 255;
 static const uint32_t clearFirst16BitsOf32BitsAND = 65535;
 static const uint32_t clearFirst8BitsOf32BitsAND = 16777215;
 
+// The decode functions read "count" samples with a distance of "frameSize" bytes
+static void decode8Bit(const int8_t *bufferPointer, size_t frameSize, size_t count, int32_t *samples)
+{
+    for(size_t i=0; i<count; i++)
+    {
+        samples[i] = static_cast<int32_t>(*bufferPointer);
+        bufferPointer += frameSize;
+    }
+}
+
+static void decode16Bit(const int8_t *bufferPointer, size_t frameSize, size_t count, bool littleEndian, int32_t *samples)
+{
+    uint32_t s1 = 0;
+    uint32_t s2 = 0;
+    if(littleEndian)
+    {
+        for(size_t i=0; i<count; i++)
+        {
+            s1 = static_cast<uint32_t>(bufferPointer[0]) & clearFirst24BitsOf32BitsAND;
+            s2 = static_cast<uint32_t>(bufferPointer[1]) << 8;
+            samples[i] = static_cast<int32_t>(s1 | s2);
+            bufferPointer += frameSize;
+        }
+    }
+    else
+    {
+        for(size_t i=0; i<count; i++)
+        {
+            s1 = static_cast<uint32_t>(bufferPointer[0]) << 8;
+            s2 = static_cast<uint32_t>(bufferPointer[1]) & clearFirst24BitsOf32BitsAND;
+            samples[i] = static_cast<int32_t>(s1 | s2);
+            bufferPointer += frameSize;
+        }
+    }
+}
+
+static void decode24Bit(const int8_t *bufferPointer, size_t frameSize, size_t count, bool littleEndian, int32_t *samples)
+{
+    uint32_t s1 = 0;
+    uint32_t s2 = 0;
+    uint32_t s3 = 0;
+    if(littleEndian)
+    {
+        for(size_t i=0; i<count; i++)
+        {
+            s1 = static_cast<uint32_t>(bufferPointer[0]) & clearFirst24BitsOf32BitsAND;
+            s2 = (static_cast<uint32_t>(bufferPointer[1]) << 8) & clearFirst16BitsOf32BitsAND;
+            s3 = static_cast<uint32_t>(bufferPointer[2]) << 16;
+            samples[i] = static_cast<int32_t>(s1 | s2 | s3);
+            bufferPointer += frameSize;
+        }
+    }
+    else
+    {
+        for(size_t i=0; i<count; i++)
+        {
+            s1 = static_cast<uint32_t>(bufferPointer[0]) << 16;
+            s2 = (static_cast<uint32_t>(bufferPointer[1]) << 8) & clearFirst16BitsOf32BitsAND;
+            s3 = static_cast<uint32_t>(bufferPointer[2]) & clearFirst24BitsOf32BitsAND;
+            samples[i] = static_cast<int32_t>(s1 | s2 | s3);
+            bufferPointer += frameSize;
+        }
+    }
+}
+
 PortAudioIO::PortAudioIO()
 {
 
@@ -40,82 +106,60 @@ int PortAudioIO::getInputCallback(const void *input, void *output, unsigned long
 {
     // Prevent compiler warnings
     (void) output;
-    (void) timeInfo;
-    (void) statusFlags;
 
-    int32_t sampleData = 0;
-    uint32_t s1 = 0;
-    uint32_t s2 = 0;
-    uint32_t s3 = 0;
-    PortAudioUserData *data = nullptr;
-    const int8_t *bufferPointer;
+    PortAudioUserData *data = static_cast<PortAudioUserData *>(userData);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    // Some host APIs don't provide the ADC time
+    data->m_buffer->setInputTime(timeInfo->inputBufferAdcTime > 0.0 ? timeInfo->inputBufferAdcTime : timeInfo->currentTime);
+    decodeSamples(input, frameCount, data);
+    data->m_statistics->addCallback(frameCount, (statusFlags & paInputOverflow) != 0, (statusFlags & paInputUnderflow) != 0,
+                                    start, std::chrono::steady_clock::now(), data->m_buffer->getQueue().getNumberOfQueuedBlocks());
+    return 0;
+}
 
-    bufferPointer = static_cast<const int8_t *>(input);
-    data = static_cast<PortAudioUserData *>(userData);
+void PortAudioIO::decodeSamples(const void *input, unsigned long frameCount, PortAudioUserData *data)
+{
+    const size_t frameSize = static_cast<size_t>(data->m_bitDepth/8)*static_cast<size_t>(data->m_channelCount);
+    const bool littleEndian = data->m_littleEndian.load(std::memory_order_relaxed);
+    const int channel = data->m_channel.load(std::memory_order_relaxed);
+    const int8_t *bufferPointer = static_cast<const int8_t *>(input);
 
-    for(unsigned int i=0; i<frameCount; i++)
+    // Decode directly into the blocks of the ring buffer, a call may complete several blocks
+    size_t remaining = frameCount;
+    while(remaining > 0)
     {
-        if(data->m_bitDepth == 8)
-        {
-            for(int i=1; i<data->m_channel; i++)
-            {
-                bufferPointer++;
-            }
-            sampleData = static_cast<int32_t>(*bufferPointer++);
-        }
-        else if(data->m_bitDepth == 16)
+        size_t available = 0;
+        int32_t *samples = data->m_buffer->getWritePointer(available);
+        size_t count = std::min(available, remaining);
+        decodeFrames(bufferPointer, count, data->m_bitDepth, littleEndian, data->m_channelCount, channel, samples);
+        if(data->m_pairChannel > 0)
         {
-            for(int i=1; i<data->m_channel; i++)
-            {
-                bufferPointer++;
-                bufferPointer++;
-            }
-            if(data->m_littleEndian == true)
-            {
-                s1 = static_cast<uint32_t>(*bufferPointer++) & clearFirst24BitsOf32BitsAND;
-                s2 = static_cast<uint32_t>(*bufferPointer++) << 8;
-                sampleData = static_cast<int32_t>(s1 | s2);
-            }
-            else
-            {
-                s1 = static_cast<uint32_t>(*bufferPointer++) << 8;
-                s2 = static_cast<uint32_t>(*bufferPointer++) & clearFirst24BitsOf32BitsAND;
-                sampleData = static_cast<int32_t>(s1 | s2);
-            }
-        }
-        else if(data->m_bitDepth == 24)
-        {
-            for(int i=1; i<data->m_channel; i++)
-            {
-                bufferPointer++;
-                bufferPointer++;
-                bufferPointer++;
-            }
-            if(data->m_littleEndian == true)
-            {
-                s1 = static_cast<uint32_t>(*bufferPointer++) & clearFirst24BitsOf32BitsAND;
-                s2 = (static_cast<uint32_t>(*bufferPointer++) << 8) & clearFirst16BitsOf32BitsAND;
-                s3 = static_cast<uint32_t>(*bufferPointer++) << 16;
-                sampleData = static_cast<int32_t>(s1 | s2 | s3);
-            }
-            else
-            {
-                s1 = static_cast<uint32_t>(*bufferPointer++) << 16;
-                s2 = (static_cast<uint32_t>(*bufferPointer++) << 8) & clearFirst16BitsOf32BitsAND;
-                s3 = static_cast<uint32_t>(*bufferPointer++) & clearFirst24BitsOf32BitsAND;
-                sampleData = static_cast<int32_t>(s1 | s2 | s3);
-            }
+            decodeFrames(bufferPointer, count, data->m_bitDepth, littleEndian, data->m_channelCount, data->m_pairChannel,
+                         data->m_buffer->getPairWritePointer());
         }
+        data->m_buffer->commitItems(count);
+        bufferPointer += count*frameSize;
+        remaining -= count;
+    }
+}
 
-        // Write sample value to the buffer
-        data->m_buffer->insertItem(sampleData, sampleCounter);
-        ++sampleCounter;
+void PortAudioIO::decodeFrames(const void *input, size_t frameCount, int bitDepth, bool littleEndian,
+                               int channelCount, int channel, int32_t *samples)
+{
+    const size_t bytesPerSample = static_cast<size_t>(bitDepth/8);
+    const size_t frameSize = bytesPerSample*static_cast<size_t>(channelCount);
+    const int8_t *bufferPointer = static_cast<const int8_t *>(input) + bytesPerSample*static_cast<size_t>(channel-1);
 
-        // Reset sampleCounter if a whole block has been processed
-        if(sampleCounter == frameCount)
-        {
-            sampleCounter = 0;
-        }
+    if(bitDepth == 8)
+    {
+        decode8Bit(bufferPointer, frameSize, frameCount, samples);
+    }
+    else if(bitDepth == 16)
+    {
+        decode16Bit(bufferPointer, frameSize, frameCount, littleEndian, samples);
+    }
+    else if(bitDepth == 24)
+    {
+        decode24Bit(bufferPointer, frameSize, frameCount, littleEndian, samples);
     }
-    return 0;
 }
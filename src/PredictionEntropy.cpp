@@ -0,0 +1,157 @@
+/*
+ * PredictionEntropy: Entropy of prediction residuals and conditional entropy of consecutive samples
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PredictionEntropy.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+PredictionEntropy::PredictionEntropy(PredictionEntropyListener *listener)
+    : m_predictionEntropyListener(listener)
+    , m_blockCounter(0)
+    , m_numberOfBlocks(50)
+    , m_pairEntropy(this)
+    , m_conditionalEntropy(0.0)
+    , m_conditionalResolution(0)
+{
+    setBitDepth(16);
+}
+
+void PredictionEntropy::addSamples(const std::vector<int32_t> & signalValues)
+{
+    if(!m_predictionEntropyListener)
+    {
+        return;
+    }
+
+    for(auto& residuals : m_residuals)
+    {
+        residuals.clear();
+    }
+    m_previousValues.clear();
+    m_currentValues.clear();
+
+    for(const auto& signalValue : signalValues)
+    {
+        // Each order is the difference of the order below, so the residual of order k needs k previous samples
+        int64_t difference = signalValue;
+        for(int order=1; order<=maximumOrder; order++)
+        {
+            const int64_t previous = m_lastDifferences[order-1];
+            m_lastDifferences[order-1] = difference;
+            if(m_historyLength < order)
+            {
+                break;
+            }
+            difference -= previous;
+            // Fits into bit depth + order bits, wrapped above 32 bit
+            m_residuals[order-1].push_back(static_cast<int32_t>(difference));
+        }
+
+        if(m_historyLength > 0)
+        {
+            m_previousValues.push_back(m_previousValue);
+            m_currentValues.push_back(signalValue);
+            const uint32_t bits = static_cast<uint32_t>(signalValue);
+            for(int bit=0; bit<m_bitDepth; bit++)
+            {
+                m_bitCounts[bit] += (bits >> bit) & 1U;
+            }
+            ++m_numberOfPairs;
+        }
+        m_previousValue = signalValue;
+        m_historyLength = std::min(m_historyLength + 1, maximumOrder);
+    }
+
+    for(int order=0; order<maximumOrder; order++)
+    {
+        m_residualHistograms[order].addSamples(m_residuals[order]);
+    }
+    // Counts the same blocks, so its result arrives with the last block of the window
+    m_pairEntropy.addSamples(m_previousValues, m_currentValues);
+    ++m_blockCounter;
+
+    if(m_blockCounter >= m_numberOfBlocks)
+    {
+        for(int order=0; order<maximumOrder; order++)
+        {
+            m_residualEntropy[order] = m_residualHistograms[order].getEntropy() + m_residualHistograms[order].getDroppedBits();
+        }
+        m_predictionEntropyListener->receivePredictionEntropy(m_residualEntropy, m_conditionalEntropy, m_conditionalResolution);
+        clearHistograms();
+    }
+}
+
+void PredictionEntropy::setNumberOfBlocks(int numberOfBlocks)
+{
+    m_numberOfBlocks = numberOfBlocks;
+    m_pairEntropy.setNumberOfBlocks(numberOfBlocks);
+}
+
+void PredictionEntropy::setBitDepth(int bitDepth)
+{
+    m_bitDepth = bitDepth;
+    for(int order=1; order<=maximumOrder; order++)
+    {
+        m_residualHistograms[order-1].setBitDepth(std::min(32, bitDepth + order));
+        m_residualHistograms[order-1].setMaximumTableBits(maximumTableBits);
+    }
+    m_pairEntropy.setBitDepth(bitDepth);
+    m_residualEntropy.assign(maximumOrder, 0.0);
+    clear();
+}
+
+void PredictionEntropy::clear()
+{
+    clearHistograms();
+    m_lastDifferences.fill(0);
+    m_historyLength = 0;
+    m_previousValue = 0;
+}
+
+void PredictionEntropy::receiveChannelPairEntropy(double firstEntropy, double secondEntropy, double jointEntropy,
+                                                  double mutualInformation, int resolution)
+{
+    (void) secondEntropy;
+    (void) mutualInformation;
+    // H(x|x-1) = H(x-1, x) - H(x-1) at the kept resolution, plus the dropped LSBs of the current sample
+    m_conditionalEntropy = std::max(0.0, jointEntropy - firstEntropy);
+    for(int bit=0; bit<m_bitDepth - resolution && m_numberOfPairs > 0; bit++)
+    {
+        const double p = static_cast<double>(m_bitCounts[bit])/static_cast<double>(m_numberOfPairs);
+        if(p > 0.0 && p < 1.0)
+        {
+            m_conditionalEntropy -= p*std::log2(p) + (1.0 - p)*std::log2(1.0 - p);
+        }
+    }
+    m_conditionalResolution = resolution;
+}
+
+void PredictionEntropy::clearHistograms()
+{
+    for(auto& histogram : m_residualHistograms)
+    {
+        histogram.clear();
+    }
+    m_pairEntropy.clear();
+    m_bitCounts.fill(0);
+    m_numberOfPairs = 0;
+    m_blockCounter = 0;
+}
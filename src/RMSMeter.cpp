@@ -30,6 +30,7 @@ RMSMeter::RMSMeter(RMSMeterListener *listener)
     , m_referenceValue(0)
     , m_i(0)
     , m_maximumDynamicRange(0.0)
+    , m_blockRms(INF)
 {
 }
 
@@ -40,7 +41,13 @@ void RMSMeter::updateMeter(const std::vector<int32_t> & signalValues)
         return;
     }
 
-    emitRmsValue(calculateRootMeanSquare(signalValues));
+    m_blockRms = calculateRootMeanSquare(signalValues);
+    emitRmsValue(m_blockRms);
+}
+
+double RMSMeter::getBlockRms() const
+{
+    return m_blockRms;
 }
 
 void RMSMeter::updateBitdepth(int bitdepth)
@@ -20,30 +20,169 @@
 
 #include "RingBuffer.hpp"
 
+#include <chrono>
+
+// Number of blocks which can be queued while the receiver is busy
+static const size_t numberOfQueuedBlocks = 32;
+
 RingBuffer::RingBuffer(int capacity, RingBufferReceiver *receiver)
-    : m_inBuffer(capacity, 0)
+    : m_queue(numberOfQueuedBlocks, capacity)
+    , m_writeBlock(nullptr)
+    , m_writePosition(0)
+    , m_blockSize(capacity)
+    , m_sampleIndex(0)
+    , m_inputTime(0.0)
+    , m_inputTimeIndex(0)
+    , m_samplePeriod(1.0/44100.0)
     , m_receiverObject(receiver)
+    , m_receiverRunning(false)
+{
+    m_discardBlock.m_samples.assign(capacity, 0);
+}
+
+RingBuffer::~RingBuffer()
+{
+    stopReceiverThread();
+}
+
+void RingBuffer::clearAndResize(int capacity, bool pairChannel)
+{
+    m_blockSize = capacity;
+    m_queue.clearAndResize(numberOfQueuedBlocks, capacity, pairChannel);
+    m_discardBlock.m_samples.assign(capacity, 0);
+    m_discardBlock.m_pairSamples.assign(pairChannel ? capacity : 0, 0);
+    m_writeBlock = nullptr;
+    m_writePosition = 0;
+    m_sampleIndex = 0;
+    m_inputTime = 0.0;
+    m_inputTimeIndex = 0;
+}
+
+void RingBuffer::setSampleRate(uint32_t sampleRate)
+{
+    m_samplePeriod = 1.0/static_cast<double>(sampleRate);
+}
+
+void RingBuffer::setInputTime(double time)
+{
+    m_inputTime = time;
+    m_inputTimeIndex = m_sampleIndex;
+}
+
+void RingBuffer::insertItem(int32_t item)
+{
+    size_t available = 0;
+    *getWritePointer(available) = item;
+    commitItems(1);
+}
+
+int32_t * RingBuffer::getWritePointer(size_t & available)
+{
+    // Start a new block
+    if(m_writePosition == 0)
+    {
+        m_writeBlock = m_queue.getWriteBlock();
+        AudioBlock *block = m_writeBlock ? m_writeBlock : &m_discardBlock;
+        block->m_sampleIndex = m_sampleIndex;
+        block->m_adcTime = m_inputTime + static_cast<double>(m_sampleIndex - m_inputTimeIndex)*m_samplePeriod;
+    }
+    available = m_blockSize - m_writePosition;
+    // Queue is full, the samples are lost
+    if(!m_writeBlock)
+    {
+        return m_discardBlock.m_samples.data() + m_writePosition;
+    }
+    return m_writeBlock->m_samples.data() + m_writePosition;
+}
+
+int32_t * RingBuffer::getPairWritePointer()
+{
+    AudioBlock *block = m_writeBlock ? m_writeBlock : &m_discardBlock;
+    if(block->m_pairSamples.empty())
+    {
+        return nullptr;
+    }
+    return block->m_pairSamples.data() + m_writePosition;
+}
+
+void RingBuffer::commitItems(size_t count)
 {
+    m_writePosition += count;
+    m_sampleIndex += count;
+    // Check if block is full
+    if(m_writePosition >= m_blockSize)
+    {
+        if(m_writeBlock)
+        {
+            // Only once per block, reading the clock takes a few 10 ns
+            m_writeBlock->m_systemTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::system_clock::now().time_since_epoch()).count();
+            m_queue.pushBlock();
+        }
+        else
+        {
+            m_queue.dropBlock();
+        }
+        m_writeBlock = nullptr;
+        m_writePosition = 0;
+    }
 }
 
-void RingBuffer::clearAndResize(int capacity)
+void RingBuffer::startReceiverThread()
 {
-    m_inBuffer.assign(capacity, 0);
+    stopReceiverThread();
+    m_receiverRunning = true;
+    m_receiverThread = std::thread(&RingBuffer::runReceiverThread, this);
 }
 
-void RingBuffer::insertItem(int32_t item, uint32_t position)
+void RingBuffer::stopReceiverThread()
 {
-    // Write sample to buffer
-    m_inBuffer[position] = item;
-    // Check if buffer is full
-    if(static_cast<size_t>(position) == m_inBuffer.size()-1)
+    m_receiverRunning = false;
+    if(m_receiverThread.joinable())
     {
-        // Lock mutex to prevent the callback function from writing new samples to buffer
-        std::lock_guard<std::mutex> lock(m_mutex);
-        // Second buffer is ready to be read
+        m_queue.wakeUp();
+        m_receiverThread.join();
+    }
+}
+
+bool RingBuffer::processBlock()
+{
+    AudioBlock *block = m_queue.getReadBlock();
+    if(!block)
+    {
+        return false;
+    }
+    if(m_receiverObject)
+    {
+        m_receiverObject->receiveSamples(*block);
+    }
+    m_queue.popBlock();
+    return true;
+}
+
+void RingBuffer::setConsumerCondition(std::condition_variable *condition)
+{
+    m_queue.setConsumerCondition(condition);
+}
+
+const BlockQueue & RingBuffer::getQueue() const
+{
+    return m_queue;
+}
+
+void RingBuffer::runReceiverThread()
+{
+    while(m_receiverRunning)
+    {
+        AudioBlock *block = m_queue.waitForReadBlock(std::chrono::milliseconds(20));
+        if(!block)
+        {
+            continue;
+        }
         if(m_receiverObject)
         {
-            m_receiverObject->receiveSamples(m_inBuffer);
+            m_receiverObject->receiveSamples(*block);
         }
+        m_queue.popBlock();
     }
 }
@@ -0,0 +1,212 @@
+/*
+ * RunningMoments: DC offset, AC RMS, skewness and kurtosis in one pass
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "RunningMoments.hpp"
+
+#include <cmath>
+
+const double INF = -999.0;
+
+// Independent sums per lane, so the compiler can vectorize the loop without reordering a single sum
+static const size_t numberOfLanes = 4;
+
+RunningMoments::State::State()
+{
+    clear();
+}
+
+void RunningMoments::State::clear()
+{
+    m_count = 0;
+    m_mean = 0.0;
+    m_m2 = 0.0;
+    m_m3 = 0.0;
+    m_m4 = 0.0;
+}
+
+void RunningMoments::State::merge(const State & other)
+{
+    if(other.m_count == 0)
+    {
+        return;
+    }
+    if(m_count == 0)
+    {
+        *this = other;
+        return;
+    }
+
+    const double na = static_cast<double>(m_count);
+    const double nb = static_cast<double>(other.m_count);
+    const double n = na + nb;
+    const double delta = other.m_mean - m_mean;
+    const double deltaN = delta/n;
+    const double deltaN2 = deltaN*deltaN;
+    const double term = delta*deltaN*na*nb;
+
+    // Pebay, "Formulas for robust, one-pass parallel computation of covariances and arbitrary-order statistical moments"
+    m_m4 += other.m_m4 + term*deltaN2*(na*na - na*nb + nb*nb) + 6.0*deltaN2*(na*na*other.m_m2 + nb*nb*m_m2)
+            + 4.0*deltaN*(na*other.m_m3 - nb*m_m3);
+    m_m3 += other.m_m3 + term*deltaN*(na - nb) + 3.0*deltaN*(na*other.m_m2 - nb*m_m2);
+    m_m2 += other.m_m2 + term;
+    m_mean += nb*deltaN;
+    m_count += other.m_count;
+}
+
+double RunningMoments::State::getVariance() const
+{
+    return m_count > 0 ? m_m2/m_count : 0.0;
+}
+
+double RunningMoments::State::getSkewness() const
+{
+    if(m_m2 <= 0.0)
+    {
+        return 0.0;
+    }
+    return std::sqrt(static_cast<double>(m_count))*m_m3/std::pow(m_m2, 1.5);
+}
+
+double RunningMoments::State::getKurtosis() const
+{
+    if(m_m2 <= 0.0)
+    {
+        return 0.0;
+    }
+    return m_count*m_m4/(m_m2*m_m2);
+}
+
+RunningMoments::RunningMoments(RunningMomentsListener *listener)
+    : m_runningMomentsListener(listener)
+    , m_referenceValue(32768.0)
+    , m_numberOfBlocks(50)
+    , m_blockCounter(0)
+{
+}
+
+void RunningMoments::addSamples(const std::vector<int32_t> & signalValues)
+{
+    if(!m_runningMomentsListener || signalValues.empty())
+    {
+        return;
+    }
+
+    const State block = calculateState(signalValues.data(), signalValues.size());
+    m_window.merge(block);
+    m_total.merge(block);
+    ++m_blockCounter;
+
+    if(m_blockCounter >= m_numberOfBlocks)
+    {
+        m_runningMomentsListener->receiveRunningMoments(getResult(m_window), getResult(m_total));
+        clear();
+    }
+}
+
+void RunningMoments::setNumberOfBlocks(int numberOfBlocks)
+{
+    m_numberOfBlocks = numberOfBlocks;
+}
+
+void RunningMoments::setBitDepth(int bitDepth)
+{
+    m_referenceValue = std::pow(2.0, bitDepth-1);
+}
+
+void RunningMoments::clear()
+{
+    m_blockCounter = 0;
+    m_window.clear();
+}
+
+void RunningMoments::reset()
+{
+    clear();
+    m_total.clear();
+}
+
+const RunningMoments::State & RunningMoments::getTotal() const
+{
+    return m_total;
+}
+
+RunningMoments::Result RunningMoments::getResult(const State & state) const
+{
+    Result result;
+    result.m_numberOfSamples = state.m_count;
+    result.m_dcOffset = state.m_mean;
+    result.m_acRms = std::sqrt(state.getVariance());
+    result.m_dcOffsetDb = result.m_dcOffset != 0.0 ? 20.0*std::log10(std::abs(result.m_dcOffset)/m_referenceValue) : INF;
+    result.m_acRmsDb = result.m_acRms > 0.0 ? 20.0*std::log10(result.m_acRms/m_referenceValue) : INF;
+    result.m_skewness = state.getSkewness();
+    result.m_kurtosis = state.getKurtosis();
+    return result;
+}
+
+RunningMoments::State RunningMoments::calculateState(const int32_t *samples, size_t numberOfSamples)
+{
+    State state;
+    if(numberOfSamples == 0)
+    {
+        return state;
+    }
+
+    // The sum of the samples is exact, so the deviations are taken from the mean of this chunk
+    int64_t sum = 0;
+    for(size_t i=0; i<numberOfSamples; i++)
+    {
+        sum += samples[i];
+    }
+    const double mean = static_cast<double>(sum)/numberOfSamples;
+
+    double m2[numberOfLanes] = {};
+    double m3[numberOfLanes] = {};
+    double m4[numberOfLanes] = {};
+    const size_t end = numberOfSamples - numberOfSamples%numberOfLanes;
+    for(size_t i=0; i<end; i+=numberOfLanes)
+    {
+        for(size_t lane=0; lane<numberOfLanes; lane++)
+        {
+            const double deviation = samples[i+lane] - mean;
+            const double square = deviation*deviation;
+            m2[lane] += square;
+            m3[lane] += square*deviation;
+            m4[lane] += square*square;
+        }
+    }
+    for(size_t i=end; i<numberOfSamples; i++)
+    {
+        const double deviation = samples[i] - mean;
+        const double square = deviation*deviation;
+        m2[0] += square;
+        m3[0] += square*deviation;
+        m4[0] += square*square;
+    }
+
+    state.m_count = numberOfSamples;
+    state.m_mean = mean;
+    for(size_t lane=0; lane<numberOfLanes; lane++)
+    {
+        state.m_m2 += m2[lane];
+        state.m_m3 += m3[lane];
+        state.m_m4 += m4[lane];
+    }
+    return state;
+}
@@ -0,0 +1,213 @@
+/*
+ * SampleSource: Base class of everything which delivers audio samples
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SampleSource.hpp"
+#include "AnalysisPool.hpp"
+#include "CaptureSpool.hpp"
+
+#include <chrono>
+
+SampleSource::SampleSource(SampleSourceListener *listener)
+    : RingBufferReceiver()
+    , m_sourceListener(listener)
+    , m_captureSpool(nullptr)
+    , m_analysisPool(nullptr)
+    , m_pairChannel(0)
+    , m_buffer(new RingBuffer(50000, this))
+    , m_bitDepth(16)
+    , m_sampleRate(44100)
+    , m_blockSize(2048)
+    , m_activeAnalysisPool(nullptr)
+    , m_generatorRunning(false)
+    , m_finished(false)
+{
+}
+
+SampleSource::~SampleSource()
+{
+    stopGeneratorThread();
+    stopReceiving();
+}
+
+bool SampleSource::isFinished() const
+{
+    return m_finished;
+}
+
+void SampleSource::setListener(SampleSourceListener *listener)
+{
+    m_sourceListener = listener;
+}
+
+void SampleSource::setCaptureSpool(CaptureSpool *spool)
+{
+    m_captureSpool = spool;
+}
+
+void SampleSource::setAnalysisPool(AnalysisPool *pool)
+{
+    m_analysisPool = pool;
+}
+
+void SampleSource::setPairChannel(int pairChannel)
+{
+    m_pairChannel = pairChannel;
+}
+
+int SampleSource::getPairChannel() const
+{
+    return m_pairChannel;
+}
+
+int SampleSource::getBitDepth() const
+{
+    return m_bitDepth;
+}
+
+uint32_t SampleSource::getSampleRate() const
+{
+    return m_sampleRate;
+}
+
+uint32_t SampleSource::getBlockSize() const
+{
+    return m_blockSize;
+}
+
+const BlockQueue & SampleSource::getQueue() const
+{
+    return m_buffer->getQueue();
+}
+
+const DriftEstimator & SampleSource::getDriftEstimator() const
+{
+    return m_driftEstimator;
+}
+
+void SampleSource::receiveSamples(const AudioBlock & block)
+{
+    m_driftEstimator.addBlock(block.m_sampleIndex + block.m_samples.size(), block.m_systemTime);
+    if(m_captureSpool && m_captureSpool->isOpen())
+    {
+        m_captureSpool->addBlock(block);
+    }
+    if(m_sourceListener)
+    {
+        m_sourceListener->receiveSourceSamples(block);
+    }
+}
+
+void SampleSource::startReceiving(int bitDepth, uint32_t sampleRate, uint32_t blockSize)
+{
+    stopReceiving();
+    m_buffer->clearAndResize(blockSize, m_pairChannel > 0);
+    m_buffer->setSampleRate(sampleRate);
+    m_driftEstimator.reset(sampleRate);
+    m_bitDepth = bitDepth;
+    m_sampleRate = sampleRate;
+    m_blockSize = blockSize;
+    m_finished = false;
+    // The source is also usable if the spool can't be opened
+    if(m_captureSpool)
+    {
+        m_captureSpool->open(bitDepth, sampleRate, blockSize);
+    }
+    m_activeAnalysisPool = m_analysisPool;
+    if(m_activeAnalysisPool)
+    {
+        m_activeAnalysisPool->addBuffer(m_buffer.get());
+    }
+    else
+    {
+        m_buffer->startReceiverThread();
+    }
+}
+
+void SampleSource::stopReceiving()
+{
+    m_buffer->stopReceiverThread();
+    if(m_activeAnalysisPool)
+    {
+        m_activeAnalysisPool->removeBuffer(m_buffer.get());
+        m_activeAnalysisPool = nullptr;
+    }
+    if(m_captureSpool)
+    {
+        m_captureSpool->close();
+    }
+}
+
+void SampleSource::startGeneratorThread(bool realTime)
+{
+    stopGeneratorThread();
+    m_finished = false;
+    m_generatorRunning = true;
+    m_generatorThread = std::thread(&SampleSource::runGeneratorThread, this, realTime);
+}
+
+void SampleSource::stopGeneratorThread()
+{
+    m_generatorRunning = false;
+    if(m_generatorThread.joinable())
+    {
+        m_generatorThread.join();
+    }
+}
+
+size_t SampleSource::generateSamples(int32_t *samples, size_t count)
+{
+    (void) samples;
+    (void) count;
+    return 0;
+}
+
+void SampleSource::runGeneratorThread(bool realTime)
+{
+    const BlockQueue & queue = m_buffer->getQueue();
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    uint64_t numberOfSamples = 0;
+
+    while(m_generatorRunning)
+    {
+        // Wait for the listener instead of dropping blocks
+        if(queue.getNumberOfQueuedBlocks() >= queue.getNumberOfBlocks())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        size_t available = 0;
+        int32_t *samples = m_buffer->getWritePointer(available);
+        size_t count = generateSamples(samples, available);
+        if(count == 0)
+        {
+            m_finished = true;
+            break;
+        }
+        m_buffer->commitItems(count);
+        numberOfSamples += count;
+
+        if(realTime)
+        {
+            std::this_thread::sleep_until(startTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                              std::chrono::duration<double>(static_cast<double>(numberOfSamples)/m_sampleRate)));
+        }
+    }
+}
@@ -0,0 +1,119 @@
+/*
+ * Spectrogram: Short-time spectra of the incoming samples as columns of display rows
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Spectrogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+static const double pi = 3.14159265358979323846;
+
+Spectrogram::Spectrogram()
+    : m_fft(fftSize)
+    , m_window(fftSize)
+    , m_samples(fftSize)
+    , m_fill(0)
+    , m_windowed(fftSize)
+    , m_fullScalePower(1.0)
+    , m_dynamicRange(1.0)
+    , m_columns(numberOfColumns*numberOfRows)
+    , m_columnCount(0)
+{
+    for(size_t i=0; i<fftSize; i++)
+    {
+        m_window[i] = 0.5 - 0.5*std::cos(2.0*pi*i/fftSize);
+    }
+    setBitDepth(16);
+}
+
+void Spectrogram::addSamples(const std::vector<int32_t> & signalValues)
+{
+    size_t i = 0;
+    while(i < signalValues.size())
+    {
+        const size_t count = std::min(signalValues.size() - i, fftSize - m_fill);
+        std::copy(signalValues.begin() + i, signalValues.begin() + i + count, m_samples.begin() + m_fill);
+        m_fill += count;
+        i += count;
+
+        if(m_fill == fftSize)
+        {
+            addColumn();
+            // The second half is the first half of the next spectrum
+            std::copy(m_samples.begin() + hopSize, m_samples.end(), m_samples.begin());
+            m_fill = fftSize - hopSize;
+        }
+    }
+}
+
+void Spectrogram::setBitDepth(int bitDepth)
+{
+    // A full scale sine has the amplitude 2^(bitDepth-1), the Hann window halves it and the FFT adds fftSize/2
+    const double amplitude = std::pow(2.0, bitDepth-1)*fftSize/4.0;
+    m_fullScalePower = amplitude*amplitude;
+    // The quantization noise of a bin lies at about -(6 dB*bit depth + FFT gain), the range ends 12 dB below it
+    m_dynamicRange = 20.0*std::log10(std::pow(2.0, bitDepth)) + 10.0*std::log10(fftSize/2.0) + 12.0;
+    clear();
+}
+
+void Spectrogram::clear()
+{
+    m_fill = 0;
+    std::lock_guard<std::mutex> lock(m_columnMutex);
+    m_columnCount = 0;
+}
+
+void Spectrogram::readColumns(uint64_t & readCount, std::vector<uint8_t> & columns) const
+{
+    std::lock_guard<std::mutex> lock(m_columnMutex);
+    // Also after clear()
+    if(readCount > m_columnCount || m_columnCount - readCount > numberOfColumns)
+    {
+        readCount = m_columnCount > numberOfColumns ? m_columnCount - numberOfColumns : 0;
+    }
+    for(; readCount<m_columnCount; readCount++)
+    {
+        const auto column = m_columns.begin() + (readCount % numberOfColumns)*numberOfRows;
+        columns.insert(columns.end(), column, column + numberOfRows);
+    }
+}
+
+void Spectrogram::addColumn()
+{
+    for(size_t i=0; i<fftSize; i++)
+    {
+        m_windowed[i] = m_samples[i]*m_window[i];
+    }
+    m_fft.calculatePowerSpectrum(m_windowed, m_power);
+
+    // Bins 1 ... fftSize/2, every row is the maximum of its bins
+    const size_t binsPerRow = (fftSize/2)/numberOfRows;
+    const double scale = 255.0/m_dynamicRange;
+    std::lock_guard<std::mutex> lock(m_columnMutex);
+    const auto column = m_columns.begin() + (m_columnCount % numberOfColumns)*numberOfRows;
+    for(int row=0; row<numberOfRows; row++)
+    {
+        const auto first = m_power.begin() + 1 + row*binsPerRow;
+        const double power = *std::max_element(first, first + binsPerRow);
+        const double level = power > 0.0 ? 10.0*std::log10(power/m_fullScalePower) + m_dynamicRange : 0.0;
+        column[row] = static_cast<uint8_t>(std::max(0.0, std::min(255.0, level*scale)));
+    }
+    ++m_columnCount;
+}
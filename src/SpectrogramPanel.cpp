@@ -0,0 +1,147 @@
+/*
+ * SpectrogramPanel: Window with the scrolling spectrogram of the input channel
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SpectrogramPanel.hpp"
+#include "Spectrogram.hpp"
+
+#include <QPushButton>
+#include <QLayout>
+#include <QStyleOption>
+#include <QPainter>
+#include <QTimer>
+
+#include <algorithm>
+
+const QColor colorFont(0,0,0);
+const QColor colorFrame(160,160,160);
+
+SpectrogramPanel::SpectrogramPanel(const Spectrogram *spectrogram, QWidget *parent)
+    : QWidget(parent)
+    , m_spectrogram(spectrogram)
+    , m_sampleRate(44100)
+    , m_image(imageWidth, Spectrogram::numberOfRows, QImage::Format_RGB32)
+    , m_writeColumn(0)
+    , m_readCount(0)
+    , m_palette(256)
+{
+    m_spectrogramArea = new QWidget(this);
+    m_spectrogramArea->setMinimumSize(imageWidth, Spectrogram::numberOfRows + 2*fontMetrics().height());
+    m_buttonClose = new QPushButton(trUtf8("Close"), this);
+    m_refreshTimer = new QTimer(this);
+    m_refreshTimer->setInterval(40);
+
+    QVBoxLayout *mainVLayout = new QVBoxLayout(this);
+    mainVLayout->addWidget(m_spectrogramArea, 1);
+    mainVLayout->addWidget(m_buttonClose);
+
+    // Black, blue, red, yellow, white, a quarter of the levels for every transition
+    for(int level=0; level<256; level++)
+    {
+        const int step = (level % 64)*255/63;
+        switch(level/64)
+        {
+        case 0:
+            m_palette[level] = qRgb(0, 0, step);
+            break;
+        case 1:
+            m_palette[level] = qRgb(step, 0, 255-step);
+            break;
+        case 2:
+            m_palette[level] = qRgb(255, step, 0);
+            break;
+        default:
+            m_palette[level] = qRgb(255, 255, step);
+            break;
+        }
+    }
+    clear();
+
+    connect(m_refreshTimer, SIGNAL(timeout()), this, SLOT(refresh()));
+    connect(m_buttonClose, SIGNAL(clicked()), this, SLOT(hide()));
+    m_refreshTimer->start();
+}
+
+void SpectrogramPanel::setSampleRate(uint32_t sampleRate)
+{
+    m_sampleRate = sampleRate;
+}
+
+void SpectrogramPanel::clear()
+{
+    m_image.fill(m_palette[0]);
+    m_writeColumn = 0;
+    m_readCount = 0;
+    update();
+}
+
+void SpectrogramPanel::refresh()
+{
+    // The columns are also taken while the window is closed, so it shows the recent history when it is opened
+    m_columns.clear();
+    m_spectrogram->readColumns(m_readCount, m_columns);
+    if(m_columns.empty())
+    {
+        return;
+    }
+
+    // Only the new columns are written, row 0 (0 Hz) is the bottom line of the image
+    const size_t numberOfNewColumns = m_columns.size()/Spectrogram::numberOfRows;
+    for(size_t column=0; column<numberOfNewColumns; column++)
+    {
+        const uint8_t *levels = &m_columns[column*Spectrogram::numberOfRows];
+        for(int row=0; row<Spectrogram::numberOfRows; row++)
+        {
+            reinterpret_cast<QRgb *>(m_image.scanLine(Spectrogram::numberOfRows-1-row))[m_writeColumn] = m_palette[levels[row]];
+        }
+        m_writeColumn = (m_writeColumn + 1) % imageWidth;
+    }
+
+    if(!isHidden())
+    {
+        update(m_spectrogramArea->geometry());
+    }
+}
+
+void SpectrogramPanel::paintEvent(QPaintEvent *)
+{
+    QStyleOption opt;
+    opt.init(this);
+    QPainter p(this);
+    style()->drawPrimitive(QStyle::PE_Widget, &opt, &p, this);
+
+    const QRect area = m_spectrogramArea->geometry();
+    const int titleHeight = p.fontMetrics().height();
+    const QPoint origin(area.left(), area.top()+titleHeight);
+
+    // Oldest columns (from the write position to the end) on the left, then the newest ones
+    const int olderWidth = imageWidth - m_writeColumn;
+    p.drawImage(origin, m_image, QRect(m_writeColumn, 0, olderWidth, Spectrogram::numberOfRows));
+    p.drawImage(origin + QPoint(olderWidth, 0), m_image, QRect(0, 0, m_writeColumn, Spectrogram::numberOfRows));
+
+    const double duration = static_cast<double>(imageWidth)*Spectrogram::hopSize/m_sampleRate;
+    p.setPen(colorFont);
+    p.drawText(area.left(), area.top(), imageWidth, titleHeight, Qt::AlignLeft,
+               trUtf8("0 - ") + QString::number(m_sampleRate/2000.0, 'f', 1) + trUtf8(" kHz, FFT ") + QString::number(Spectrogram::fftSize));
+    p.drawText(area.left(), origin.y()+Spectrogram::numberOfRows+1, imageWidth, titleHeight, Qt::AlignLeft,
+               "-" + QString::number(duration, 'f', 1) + " s");
+    p.drawText(area.left(), origin.y()+Spectrogram::numberOfRows+1, imageWidth, titleHeight, Qt::AlignRight, trUtf8("now"));
+    p.setPen(colorFrame);
+    p.drawRect(QRect(origin, QSize(imageWidth, Spectrogram::numberOfRows)).adjusted(-1, -1, 0, 0));
+}
@@ -0,0 +1,136 @@
+/*
+ * StatisticsPanel: Window with the timing statistics of the running stream
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "StatisticsPanel.hpp"
+
+#include <QLabel>
+#include <QPushButton>
+#include <QLayout>
+#include <QFormLayout>
+#include <QStyleOption>
+#include <QPainter>
+
+#include <algorithm>
+#include <cmath>
+
+const QColor colorFont(0,0,0);
+const QColor colorBar(65,105,225);
+const QColor colorFrame(160,160,160);
+
+// Format a time in seconds with a suitable unit
+static QString formatTime(double seconds)
+{
+    if(seconds < 1.0e-3)
+    {
+        return QString::number(seconds*1.0e6, 'f', 1) + " us";
+    }
+    return QString::number(seconds*1.0e3, 'f', 2) + " ms";
+}
+
+StatisticsPanel::StatisticsPanel(QWidget *parent)
+    : QWidget(parent)
+{
+    setStyleSheet("QLabel {color: " + colorFont.name() + ";}");
+
+    m_labelCallbacks = new QLabel("-", this);
+    m_labelXruns = new QLabel("-", this);
+    m_labelDuration = new QLabel("-", this);
+    m_labelJitter = new QLabel("-", this);
+    m_labelCpuLoad = new QLabel("-", this);
+    m_labelQueue = new QLabel("-", this);
+    m_histogramArea = new QWidget(this);
+    m_histogramArea->setMinimumHeight(220);
+    m_buttonClose = new QPushButton(trUtf8("Close"), this);
+
+    QFormLayout *formLayout = new QFormLayout();
+    formLayout->addRow(trUtf8("Callbacks:"), m_labelCallbacks);
+    formLayout->addRow(trUtf8("Overflows / underflows:"), m_labelXruns);
+    formLayout->addRow(trUtf8("Duration (min/mean/max):"), m_labelDuration);
+    formLayout->addRow(trUtf8("Jitter (mean/max):"), m_labelJitter);
+    formLayout->addRow(trUtf8("CPU load:"), m_labelCpuLoad);
+    formLayout->addRow(trUtf8("Queue (now/max/size, dropped):"), m_labelQueue);
+
+    QVBoxLayout *mainVLayout = new QVBoxLayout(this);
+    mainVLayout->addLayout(formLayout);
+    mainVLayout->addWidget(m_histogramArea, 1);
+    mainVLayout->addWidget(m_buttonClose);
+
+    m_statistics = StreamStatistics().getSnapshot();
+
+    connect(m_buttonClose, SIGNAL(clicked()), this, SLOT(hide()));
+}
+
+void StatisticsPanel::updateStatistics(const StreamStatistics::Snapshot & statistics)
+{
+    m_statistics = statistics;
+
+    m_labelCallbacks->setText(QString::number(statistics.m_numberOfCallbacks) + " (" + QString::number(statistics.m_numberOfFrames) + trUtf8(" frames)"));
+    m_labelXruns->setText(QString::number(statistics.m_inputOverflows) + " / " + QString::number(statistics.m_inputUnderflows));
+    m_labelDuration->setText(formatTime(statistics.m_minimumDuration) + " / " + formatTime(statistics.m_meanDuration) + " / " + formatTime(statistics.m_maximumDuration));
+    m_labelJitter->setText(formatTime(statistics.m_meanJitter) + " / " + formatTime(statistics.m_maximumJitter));
+    m_labelCpuLoad->setText(QString::number(statistics.m_cpuLoad*100.0, 'f', 1) + " %");
+    m_labelQueue->setText(QString::number(statistics.m_queuedBlocks) + " / " + QString::number(statistics.m_maximumQueuedBlocks) + " / "
+                          + QString::number(statistics.m_numberOfBlocks) + ", " + QString::number(statistics.m_droppedBlocks));
+    update();
+}
+
+void StatisticsPanel::drawHistogram(QPainter & painter, const QRect & area, const QString & title,
+                                    const std::array<uint64_t, StreamStatistics::numberOfBins> & histogram)
+{
+    const int titleHeight = painter.fontMetrics().height();
+    const QRect bars(area.left(), area.top()+titleHeight, area.width(), area.height()-2*titleHeight);
+    painter.setPen(colorFont);
+    painter.drawText(area.left(), area.top(), area.width(), titleHeight, Qt::AlignLeft, title);
+    painter.setPen(colorFrame);
+    painter.drawRect(bars);
+
+    // Logarithmic height, otherwise rare outliers wouldn't be visible
+    uint64_t maximum = *std::max_element(histogram.begin(), histogram.end());
+    const double scale = (maximum > 0) ? 1.0/std::log10(static_cast<double>(maximum)+1.0) : 0.0;
+    const double barWidth = static_cast<double>(bars.width())/StreamStatistics::numberOfBins;
+    for(int i=0; i<StreamStatistics::numberOfBins; i++)
+    {
+        int height = static_cast<int>(std::log10(static_cast<double>(histogram[i])+1.0)*scale*bars.height());
+        painter.fillRect(static_cast<int>(bars.left()+i*barWidth)+1, bars.bottom()-height,
+                         std::max(1, static_cast<int>(barWidth)-1), height, colorBar);
+    }
+
+    // Label every fourth bin with its lower bound
+    painter.setPen(colorFont);
+    for(int i=0; i<StreamStatistics::numberOfBins; i+=4)
+    {
+        painter.drawText(static_cast<int>(bars.left()+i*barWidth), bars.bottom()+1, static_cast<int>(4*barWidth), titleHeight,
+                         Qt::AlignLeft, formatTime(StreamStatistics::getBinLowerBound(i)));
+    }
+}
+
+void StatisticsPanel::paintEvent(QPaintEvent *)
+{
+    QStyleOption opt;
+    opt.init(this);
+    QPainter p(this);
+    style()->drawPrimitive(QStyle::PE_Widget, &opt, &p, this);
+
+    const QRect area = m_histogramArea->geometry();
+    const int spacing = 10;
+    const int height = (area.height()-spacing)/2;
+    drawHistogram(p, QRect(area.left(), area.top(), area.width(), height), trUtf8("Callback duration"), m_statistics.m_durationHistogram);
+    drawHistogram(p, QRect(area.left(), area.top()+height+spacing, area.width(), height), trUtf8("Callback jitter"), m_statistics.m_jitterHistogram);
+}
@@ -0,0 +1,154 @@
+/*
+ * StreamStatistics: Timing and overflow counters of the audio thread
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "StreamStatistics.hpp"
+
+StreamStatistics::StreamStatistics()
+{
+    reset(44100);
+}
+
+void StreamStatistics::reset(uint32_t sampleRate)
+{
+    m_sampleRate = sampleRate;
+    m_numberOfCallbacks = 0;
+    m_numberOfFrames = 0;
+    m_inputOverflows = 0;
+    m_inputUnderflows = 0;
+    m_minimumDuration = UINT64_MAX;
+    m_maximumDuration = 0;
+    m_totalDuration = 0;
+    m_maximumJitter = 0;
+    m_totalJitter = 0;
+    m_numberOfIntervals = 0;
+    for(int i=0; i<numberOfBins; i++)
+    {
+        m_durationHistogram[i] = 0;
+        m_jitterHistogram[i] = 0;
+    }
+    m_maximumQueuedBlocks = 0;
+    m_lastStart = std::chrono::steady_clock::time_point();
+    m_lastFrameCount = 0;
+}
+
+void StreamStatistics::addCallback(unsigned long frameCount, bool inputOverflow, bool inputUnderflow,
+                                   std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end,
+                                   size_t queuedBlocks)
+{
+    const std::memory_order relaxed = std::memory_order_relaxed;
+
+    increment(m_numberOfCallbacks);
+    increment(m_numberOfFrames, frameCount);
+    if(inputOverflow)
+    {
+        increment(m_inputOverflows);
+    }
+    if(inputUnderflow)
+    {
+        increment(m_inputUnderflows);
+    }
+
+    const uint64_t duration = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    increment(m_totalDuration, duration);
+    if(duration < m_minimumDuration.load(relaxed))
+    {
+        m_minimumDuration.store(duration, relaxed);
+    }
+    if(duration > m_maximumDuration.load(relaxed))
+    {
+        m_maximumDuration.store(duration, relaxed);
+    }
+    increment(m_durationHistogram[getBin(duration)]);
+
+    // The previous buffer should have taken frameCount/sampleRate seconds
+    if(m_numberOfCallbacks.load(relaxed) > 1 && m_sampleRate > 0)
+    {
+        const int64_t interval = std::chrono::duration_cast<std::chrono::nanoseconds>(start - m_lastStart).count();
+        const int64_t expected = static_cast<int64_t>(m_lastFrameCount*1000000000ULL/m_sampleRate);
+        const uint64_t jitter = static_cast<uint64_t>(interval > expected ? interval - expected : expected - interval);
+        increment(m_totalJitter, jitter);
+        increment(m_numberOfIntervals);
+        if(jitter > m_maximumJitter.load(relaxed))
+        {
+            m_maximumJitter.store(jitter, relaxed);
+        }
+        increment(m_jitterHistogram[getBin(jitter)]);
+    }
+    m_lastStart = start;
+    m_lastFrameCount = frameCount;
+
+    if(queuedBlocks > m_maximumQueuedBlocks.load(relaxed))
+    {
+        m_maximumQueuedBlocks.store(queuedBlocks, relaxed);
+    }
+}
+
+StreamStatistics::Snapshot StreamStatistics::getSnapshot() const
+{
+    Snapshot snapshot;
+    snapshot.m_numberOfCallbacks = m_numberOfCallbacks;
+    snapshot.m_numberOfFrames = m_numberOfFrames;
+    snapshot.m_inputOverflows = m_inputOverflows;
+    snapshot.m_inputUnderflows = m_inputUnderflows;
+
+    const uint64_t minimumDuration = m_minimumDuration;
+    snapshot.m_minimumDuration = (minimumDuration == UINT64_MAX) ? 0.0 : minimumDuration*1.0e-9;
+    snapshot.m_maximumDuration = m_maximumDuration*1.0e-9;
+    snapshot.m_meanDuration = (snapshot.m_numberOfCallbacks > 0) ? m_totalDuration*1.0e-9/snapshot.m_numberOfCallbacks : 0.0;
+
+    const uint64_t numberOfIntervals = m_numberOfIntervals;
+    snapshot.m_maximumJitter = m_maximumJitter*1.0e-9;
+    snapshot.m_meanJitter = (numberOfIntervals > 0) ? m_totalJitter*1.0e-9/numberOfIntervals : 0.0;
+
+    for(int i=0; i<numberOfBins; i++)
+    {
+        snapshot.m_durationHistogram[i] = m_durationHistogram[i];
+        snapshot.m_jitterHistogram[i] = m_jitterHistogram[i];
+    }
+
+    snapshot.m_cpuLoad = 0.0;
+    snapshot.m_queuedBlocks = 0;
+    snapshot.m_maximumQueuedBlocks = static_cast<size_t>(m_maximumQueuedBlocks.load());
+    snapshot.m_numberOfBlocks = 0;
+    snapshot.m_droppedBlocks = 0;
+    return snapshot;
+}
+
+double StreamStatistics::getBinLowerBound(int bin)
+{
+    return (bin == 0) ? 0.0 : static_cast<double>(1ULL << bin)*1.0e-6;
+}
+
+int StreamStatistics::getBin(uint64_t nanoseconds)
+{
+    uint64_t microseconds = nanoseconds/1000;
+    int bin = 0;
+    while(microseconds >= 2 && bin < numberOfBins-1)
+    {
+        microseconds >>= 1;
+        ++bin;
+    }
+    return bin;
+}
+
+void StreamStatistics::increment(std::atomic<uint64_t> & counter, uint64_t value)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
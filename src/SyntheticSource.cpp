@@ -0,0 +1,260 @@
+/*
+ * SyntheticSource: Deterministic test signals without audio hardware
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SyntheticSource.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+const double PI = 3.14159265358979323846;
+
+SyntheticSource::SyntheticSource(SampleSourceListener *listener)
+    : SampleSource(listener)
+    , m_pattern(Pattern::Sine)
+    , m_frequency(997.0)
+    , m_amplitude(-1.0)
+    , m_effectiveBits(16)
+    , m_stuckBit(0)
+    , m_stuckBitValue(false)
+    , m_seed(1)
+    , m_realTime(true)
+    , m_phase(0.0)
+    , m_peakValue(0.0)
+    , m_rampValue(0)
+{
+}
+
+SyntheticSource::~SyntheticSource()
+{
+    // The generator thread must not call generateSamples() of a destroyed object
+    close();
+}
+
+void SyntheticSource::setPattern(Pattern pattern)
+{
+    m_pattern = pattern;
+}
+
+void SyntheticSource::setFrequency(double frequency)
+{
+    m_frequency = frequency;
+}
+
+void SyntheticSource::setAmplitude(double amplitude)
+{
+    m_amplitude = amplitude;
+}
+
+void SyntheticSource::setEffectiveBits(int effectiveBits)
+{
+    m_effectiveBits = effectiveBits;
+}
+
+void SyntheticSource::setStuckBit(int bit, bool value)
+{
+    m_stuckBit = bit;
+    m_stuckBitValue = value;
+}
+
+void SyntheticSource::setSeed(uint32_t seed)
+{
+    m_seed = seed;
+}
+
+void SyntheticSource::setRealTime(bool realTime)
+{
+    m_realTime = realTime;
+}
+
+bool SyntheticSource::open(int bitDepth, uint32_t sampleRate, uint32_t blockSize)
+{
+    close();
+
+    if(bitDepth != 8 && bitDepth != 16 && bitDepth != 24)
+    {
+        std::cout << "ERROR: Unsupported bit depth " << bitDepth << std::endl;
+        return false;
+    }
+    if(m_pairChannel > 0)
+    {
+        std::cout << "ERROR: Synthetic sources have only one channel" << std::endl;
+        return false;
+    }
+
+    // Restart the signal so that every run produces the same samples
+    m_phase = 0.0;
+    m_random.seed(m_seed);
+    m_peakValue = (std::pow(2.0, bitDepth-1) - 1.0)*std::pow(10.0, m_amplitude/20.0);
+    m_rampValue = -static_cast<int64_t>(m_peakValue);
+
+    startReceiving(bitDepth, sampleRate, blockSize);
+    startGeneratorThread(m_realTime);
+    std::cout << "- Synthetic source started -" << std::endl;
+    std::cout << getName() << "| Sample rate:" << sampleRate << "| Bitdepth:" << bitDepth << std::endl;
+    return true;
+}
+
+void SyntheticSource::close()
+{
+    stopGeneratorThread();
+    stopReceiving();
+}
+
+std::string SyntheticSource::getName() const
+{
+    std::stringstream name;
+    name << "Synthetic ";
+    switch(m_pattern)
+    {
+        case Pattern::Sine:
+            name << "sine " << m_frequency << " Hz " << m_amplitude << " dBFS";
+            break;
+        case Pattern::Noise:
+            name << "noise " << m_amplitude << " dBFS";
+            break;
+        case Pattern::Silence:
+            name << "silence";
+            break;
+        case Pattern::TruncatedBitDepth:
+            name << "noise truncated to " << m_effectiveBits << " bit";
+            break;
+        case Pattern::StuckBit:
+            name << "noise with bit " << m_stuckBit << " stuck at " << (m_stuckBitValue ? 1 : 0);
+            break;
+        case Pattern::Ramp:
+            name << "ramp " << m_amplitude << " dBFS";
+            break;
+    }
+    return name.str();
+}
+
+bool SyntheticSource::getPatternFromName(const std::string & name, Pattern & pattern)
+{
+    if(name == "sine")
+    {
+        pattern = Pattern::Sine;
+    }
+    else if(name == "noise")
+    {
+        pattern = Pattern::Noise;
+    }
+    else if(name == "silence")
+    {
+        pattern = Pattern::Silence;
+    }
+    else if(name == "truncated")
+    {
+        pattern = Pattern::TruncatedBitDepth;
+    }
+    else if(name == "stuckbit")
+    {
+        pattern = Pattern::StuckBit;
+    }
+    else if(name == "ramp")
+    {
+        pattern = Pattern::Ramp;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+size_t SyntheticSource::generateSamples(int32_t *samples, size_t count)
+{
+    const double phaseIncrement = 2.0*PI*m_frequency/m_sampleRate;
+    const uint32_t bitMask = static_cast<uint32_t>((1ULL << m_bitDepth) - 1);
+
+    switch(m_pattern)
+    {
+        case Pattern::Sine:
+            for(size_t i=0; i<count; i++)
+            {
+                samples[i] = static_cast<int32_t>(std::lround(m_peakValue*std::sin(m_phase)));
+                m_phase += phaseIncrement;
+                if(m_phase >= 2.0*PI)
+                {
+                    m_phase -= 2.0*PI;
+                }
+            }
+            break;
+        case Pattern::Noise:
+            for(size_t i=0; i<count; i++)
+            {
+                samples[i] = getNoiseSample();
+            }
+            break;
+        case Pattern::Silence:
+            for(size_t i=0; i<count; i++)
+            {
+                samples[i] = 0;
+            }
+            break;
+        case Pattern::TruncatedBitDepth:
+        {
+            // Clear the bits below the effective bit depth
+            const int clearedBits = std::max(0, m_bitDepth - m_effectiveBits);
+            const uint32_t truncateMask = ~static_cast<uint32_t>((1ULL << clearedBits) - 1);
+            for(size_t i=0; i<count; i++)
+            {
+                samples[i] = toSigned(static_cast<uint32_t>(getNoiseSample()) & truncateMask & bitMask);
+            }
+            break;
+        }
+        case Pattern::StuckBit:
+        {
+            const uint32_t stuckMask = 1U << m_stuckBit;
+            for(size_t i=0; i<count; i++)
+            {
+                uint32_t value = static_cast<uint32_t>(getNoiseSample()) & bitMask;
+                value = m_stuckBitValue ? (value | stuckMask) : (value & ~stuckMask);
+                samples[i] = toSigned(value);
+            }
+            break;
+        }
+        case Pattern::Ramp:
+        {
+            const int64_t peak = static_cast<int64_t>(m_peakValue);
+            for(size_t i=0; i<count; i++)
+            {
+                samples[i] = static_cast<int32_t>(m_rampValue);
+                m_rampValue = (m_rampValue < peak) ? m_rampValue + 1 : -peak;
+            }
+            break;
+        }
+    }
+    return count;
+}
+
+int32_t SyntheticSource::getNoiseSample()
+{
+    // Uniform white noise, std::uniform_int_distribution isn't guaranteed to be identical across platforms
+    const int64_t peak = static_cast<int64_t>(m_peakValue);
+    return static_cast<int32_t>(static_cast<int64_t>(m_random() % static_cast<uint64_t>(2*peak+1)) - peak);
+}
+
+int32_t SyntheticSource::toSigned(uint32_t value) const
+{
+    const uint32_t signBit = 1U << (m_bitDepth-1);
+    return static_cast<int32_t>((value ^ signBit) - signBit);
+}
@@ -0,0 +1,138 @@
+/*
+ * TriggerPanel: Window with the conditions of the event trigger
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TriggerPanel.hpp"
+
+#include <QCheckBox>
+#include <QDoubleSpinBox>
+#include <QFileInfo>
+#include <QLabel>
+#include <QPushButton>
+#include <QLayout>
+#include <QFormLayout>
+#include <QStyleOption>
+#include <QPainter>
+
+const QColor colorFont(0,0,0);
+
+TriggerPanel::TriggerPanel(QWidget *parent)
+    : QWidget(parent)
+{
+    setStyleSheet("QLabel {color: " + colorFont.name() + ";} QCheckBox {color: " + colorFont.name() + ";}");
+
+    m_checkBoxClip = new QCheckBox(trUtf8("Clipping"), this);
+    m_checkBoxEntropy = new QCheckBox(trUtf8("Entropy below (bit)"), this);
+    m_spinBoxEntropy = new QDoubleSpinBox(this);
+    m_spinBoxEntropy->setRange(0.0, 24.0);
+    m_spinBoxEntropy->setDecimals(2);
+    m_checkBoxRms = new QCheckBox(trUtf8("RMS step (dB)"), this);
+    m_spinBoxRms = new QDoubleSpinBox(this);
+    m_spinBoxRms->setRange(0.1, 150.0);
+    m_spinBoxRms->setDecimals(1);
+    m_checkBoxBits = new QCheckBox(trUtf8("Bit pattern change"), this);
+    m_spinBoxPreTrigger = new QDoubleSpinBox(this);
+    m_spinBoxPreTrigger->setRange(0.0, 60.0);
+    m_spinBoxPreTrigger->setSuffix(" s");
+    m_spinBoxPostTrigger = new QDoubleSpinBox(this);
+    m_spinBoxPostTrigger->setRange(0.0, 60.0);
+    m_spinBoxPostTrigger->setSuffix(" s");
+    m_labelEvents = new QLabel("0", this);
+    m_labelLastEvent = new QLabel("-", this);
+    m_buttonClose = new QPushButton(trUtf8("Close"), this);
+
+    QFormLayout *formLayout = new QFormLayout();
+    formLayout->addRow(m_checkBoxClip);
+    formLayout->addRow(m_checkBoxEntropy, m_spinBoxEntropy);
+    formLayout->addRow(m_checkBoxRms, m_spinBoxRms);
+    formLayout->addRow(m_checkBoxBits);
+    formLayout->addRow(trUtf8("Pre-trigger time:"), m_spinBoxPreTrigger);
+    formLayout->addRow(trUtf8("Post-trigger time:"), m_spinBoxPostTrigger);
+    formLayout->addRow(trUtf8("Events:"), m_labelEvents);
+    formLayout->addRow(trUtf8("Last event:"), m_labelLastEvent);
+
+    QVBoxLayout *mainVLayout = new QVBoxLayout(this);
+    mainVLayout->addLayout(formLayout);
+    mainVLayout->addStretch(1);
+    mainVLayout->addWidget(m_buttonClose);
+
+    connect(m_checkBoxClip, SIGNAL(toggled(bool)), this, SLOT(emitSettingsChanged()));
+    connect(m_checkBoxEntropy, SIGNAL(toggled(bool)), this, SLOT(emitSettingsChanged()));
+    connect(m_spinBoxEntropy, SIGNAL(valueChanged(double)), this, SLOT(emitSettingsChanged()));
+    connect(m_checkBoxRms, SIGNAL(toggled(bool)), this, SLOT(emitSettingsChanged()));
+    connect(m_spinBoxRms, SIGNAL(valueChanged(double)), this, SLOT(emitSettingsChanged()));
+    connect(m_checkBoxBits, SIGNAL(toggled(bool)), this, SLOT(emitSettingsChanged()));
+    connect(m_spinBoxPreTrigger, SIGNAL(valueChanged(double)), this, SLOT(emitSettingsChanged()));
+    connect(m_spinBoxPostTrigger, SIGNAL(valueChanged(double)), this, SLOT(emitSettingsChanged()));
+    connect(m_buttonClose, SIGNAL(clicked()), this, SLOT(hide()));
+}
+
+void TriggerPanel::setSettings(const EventTrigger::Settings & settings)
+{
+    // Don't report the values which are set here as changes
+    blockSignals(true);
+    m_checkBoxClip->setChecked(settings.m_clip);
+    m_checkBoxEntropy->setChecked(settings.m_entropyDrop);
+    m_spinBoxEntropy->setValue(settings.m_entropyThreshold);
+    m_checkBoxRms->setChecked(settings.m_rmsStep);
+    m_spinBoxRms->setValue(settings.m_rmsStepSize);
+    m_checkBoxBits->setChecked(settings.m_bitChange);
+    m_spinBoxPreTrigger->setValue(settings.m_preTriggerTime);
+    m_spinBoxPostTrigger->setValue(settings.m_postTriggerTime);
+    blockSignals(false);
+}
+
+EventTrigger::Settings TriggerPanel::getSettings(const EventTrigger::Settings & settings) const
+{
+    EventTrigger::Settings s = settings;
+    s.m_clip = m_checkBoxClip->isChecked();
+    s.m_entropyDrop = m_checkBoxEntropy->isChecked();
+    s.m_entropyThreshold = m_spinBoxEntropy->value();
+    s.m_rmsStep = m_checkBoxRms->isChecked();
+    s.m_rmsStepSize = m_spinBoxRms->value();
+    s.m_bitChange = m_checkBoxBits->isChecked();
+    s.m_preTriggerTime = m_spinBoxPreTrigger->value();
+    s.m_postTriggerTime = m_spinBoxPostTrigger->value();
+    return s;
+}
+
+void TriggerPanel::updateEvents(quint64 numberOfEvents, const QString & fileName)
+{
+    m_labelEvents->setText(QString::number(numberOfEvents));
+    m_labelLastEvent->setText(fileName.isEmpty() ? trUtf8("Write error") : QFileInfo(fileName).fileName());
+}
+
+void TriggerPanel::disableUI(bool disable)
+{
+    m_spinBoxPreTrigger->setDisabled(disable);
+    m_spinBoxPostTrigger->setDisabled(disable);
+}
+
+void TriggerPanel::emitSettingsChanged()
+{
+    emit signalSettingsChanged();
+}
+
+void TriggerPanel::paintEvent(QPaintEvent *)
+{
+    QStyleOption opt;
+    opt.init(this);
+    QPainter p(this);
+    style()->drawPrimitive(QStyle::PE_Widget, &opt, &p, this);
+}
@@ -0,0 +1,129 @@
+/*
+ * WaveformPanel: Window with the scrolling min/max envelope of the input channel
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "WaveformPanel.hpp"
+#include "WaveformPyramid.hpp"
+
+#include <QComboBox>
+#include <QPushButton>
+#include <QLayout>
+#include <QFormLayout>
+#include <QStyleOption>
+#include <QPainter>
+#include <QTimer>
+
+#include <algorithm>
+#include <cmath>
+
+const QColor colorFont(0,0,0);
+const QColor colorWave(65,105,225);
+const QColor colorFrame(160,160,160);
+
+WaveformPanel::WaveformPanel(const WaveformPyramid *pyramid, QWidget *parent)
+    : QWidget(parent)
+    , m_pyramid(pyramid)
+    , m_bitDepth(16)
+    , m_sampleRate(44100)
+{
+    setStyleSheet("QLabel {color: " + colorFont.name() + ";}");
+
+    // Time span in seconds
+    m_boxTimeSpan = new QComboBox(this);
+    m_boxTimeSpan->addItem(trUtf8("1 s"), 1);
+    m_boxTimeSpan->addItem(trUtf8("10 s"), 10);
+    m_boxTimeSpan->addItem(trUtf8("1 min"), 60);
+    m_boxTimeSpan->addItem(trUtf8("10 min"), 600);
+    m_boxTimeSpan->addItem(trUtf8("1 h"), 3600);
+    m_boxTimeSpan->addItem(trUtf8("10 h"), 36000);
+    m_waveformArea = new QWidget(this);
+    m_waveformArea->setMinimumHeight(220);
+    m_buttonClose = new QPushButton(trUtf8("Close"), this);
+    m_refreshTimer = new QTimer(this);
+    m_refreshTimer->setInterval(50);
+
+    QFormLayout *formLayout = new QFormLayout();
+    formLayout->addRow(trUtf8("Time span:"), m_boxTimeSpan);
+
+    QVBoxLayout *mainVLayout = new QVBoxLayout(this);
+    mainVLayout->addLayout(formLayout);
+    mainVLayout->addWidget(m_waveformArea, 1);
+    mainVLayout->addWidget(m_buttonClose);
+
+    connect(m_boxTimeSpan, SIGNAL(currentIndexChanged(int)), this, SLOT(refresh()));
+    connect(m_refreshTimer, SIGNAL(timeout()), this, SLOT(refresh()));
+    connect(m_buttonClose, SIGNAL(clicked()), this, SLOT(hide()));
+    m_refreshTimer->start();
+}
+
+void WaveformPanel::setFormat(int bitDepth, uint32_t sampleRate)
+{
+    m_bitDepth = bitDepth;
+    m_sampleRate = sampleRate;
+}
+
+void WaveformPanel::refresh()
+{
+    // Nothing is read while the window is closed
+    if(isHidden())
+    {
+        return;
+    }
+
+    const uint64_t numberOfSamples = std::min(WaveformPyramid::getMaximumNumberOfSamples(),
+                                              static_cast<uint64_t>(m_boxTimeSpan->currentData().toInt())*m_sampleRate);
+    m_pyramid->getEnvelope(numberOfSamples, m_waveformArea->width(), m_minimum, m_maximum);
+    update();
+}
+
+void WaveformPanel::paintEvent(QPaintEvent *)
+{
+    QStyleOption opt;
+    opt.init(this);
+    QPainter p(this);
+    style()->drawPrimitive(QStyle::PE_Widget, &opt, &p, this);
+
+    // y: -FS ... +FS, x: one column per pixel, the newest samples on the right
+    const QRect area = m_waveformArea->geometry();
+    const int titleHeight = p.fontMetrics().height();
+    const QRect plot(area.left(), area.top()+titleHeight, area.width(), area.height()-2*titleHeight);
+    p.setPen(colorFont);
+    p.drawText(area.left(), area.top(), area.width(), titleHeight, Qt::AlignLeft, trUtf8("Minimum / maximum (+FS ... -FS)"));
+    p.drawText(plot.left(), plot.bottom()+1, plot.width(), titleHeight, Qt::AlignLeft, "-" + m_boxTimeSpan->currentText());
+    p.drawText(plot.left(), plot.bottom()+1, plot.width(), titleHeight, Qt::AlignRight, trUtf8("now"));
+    p.setPen(colorFrame);
+    p.drawRect(plot);
+    p.drawLine(plot.left(), plot.center().y(), plot.right(), plot.center().y());
+
+    const double fullScale = std::pow(2.0, m_bitDepth-1);
+    const double scale = plot.height()/(2.0*fullScale);
+    const int columns = std::min(plot.width(), static_cast<int>(m_minimum.size()));
+    p.setPen(colorWave);
+    for(int x=0; x<columns; x++)
+    {
+        // Columns before the start are empty
+        if(m_minimum[x] > m_maximum[x])
+        {
+            continue;
+        }
+        const int top = static_cast<int>(plot.center().y() - m_maximum[x]*scale);
+        const int bottom = static_cast<int>(plot.center().y() - m_minimum[x]*scale);
+        p.drawLine(plot.left()+x, top, plot.left()+x, bottom);
+    }
+}
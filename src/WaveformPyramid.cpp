@@ -0,0 +1,157 @@
+/*
+ * WaveformPyramid: Min/max decimation pyramid of the incoming samples
+ *
+ * Copyright (C) 2014  Andrej Nichelmann
+ *                     Klaus Michael Indlekofer
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "WaveformPyramid.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Combines to any entry without changing it
+static const int32_t emptyMinimum = std::numeric_limits<int32_t>::max();
+static const int32_t emptyMaximum = std::numeric_limits<int32_t>::min();
+
+WaveformPyramid::WaveformPyramid()
+    : m_levels(numberOfLevels)
+{
+    for(auto& level : m_levels)
+    {
+        level.m_entries.resize(levelCapacity);
+    }
+    clear();
+}
+
+void WaveformPyramid::addSamples(const std::vector<int32_t> & signalValues)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Level & base = m_levels[0];
+    size_t i = 0;
+    while(i < signalValues.size())
+    {
+        // Minimum and maximum of the rest of the pending entry, this loop has no dependency between the samples
+        const size_t end = std::min(signalValues.size(), i + static_cast<size_t>(baseDecimation - base.m_pendingCount));
+        int32_t minimum = base.m_pending.m_minimum;
+        int32_t maximum = base.m_pending.m_maximum;
+        for(size_t j=i; j<end; j++)
+        {
+            minimum = std::min(minimum, signalValues[j]);
+            maximum = std::max(maximum, signalValues[j]);
+        }
+        base.m_pending.m_minimum = minimum;
+        base.m_pending.m_maximum = maximum;
+        base.m_pendingCount += static_cast<int>(end - i);
+        i = end;
+
+        if(base.m_pendingCount == baseDecimation)
+        {
+            const Entry entry = base.m_pending;
+            base.m_pending = Entry{emptyMinimum, emptyMaximum};
+            base.m_pendingCount = 0;
+            pushEntry(0, entry);
+        }
+    }
+}
+
+void WaveformPyramid::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for(auto& level : m_levels)
+    {
+        level.m_count = 0;
+        level.m_pending = Entry{emptyMinimum, emptyMaximum};
+        level.m_pendingCount = 0;
+    }
+}
+
+void WaveformPyramid::getEnvelope(uint64_t numberOfSamples, int numberOfPixels, std::vector<int32_t> & minimum, std::vector<int32_t> & maximum) const
+{
+    minimum.assign(static_cast<size_t>(std::max(0, numberOfPixels)), emptyMinimum);
+    maximum.assign(static_cast<size_t>(std::max(0, numberOfPixels)), emptyMaximum);
+    if(numberOfPixels <= 0 || numberOfSamples == 0)
+    {
+        return;
+    }
+
+    // The coarsest level with at least one entry per pixel, unless the span is longer than the ring of that level
+    const double samplesPerPixel = static_cast<double>(numberOfSamples)/numberOfPixels;
+    int levelIndex = 0;
+    uint64_t decimation = baseDecimation;
+    while(levelIndex < numberOfLevels-1 && (decimation*levelFactor <= samplesPerPixel || numberOfSamples/decimation > levelCapacity))
+    {
+        ++levelIndex;
+        decimation *= levelFactor;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const Level & level = m_levels[levelIndex];
+    const double numberOfEntries = static_cast<double>(numberOfSamples)/decimation;
+    const double entriesPerPixel = numberOfEntries/numberOfPixels;
+    // Oldest entry which is still in the ring
+    const int64_t firstAvailable = static_cast<int64_t>(level.m_count > levelCapacity ? level.m_count - levelCapacity : 0);
+    const double firstEntry = static_cast<double>(level.m_count) - numberOfEntries;
+    for(int pixel=0; pixel<numberOfPixels; pixel++)
+    {
+        const int64_t begin = static_cast<int64_t>(std::floor(firstEntry + pixel*entriesPerPixel));
+        // With less than one entry per pixel the entry is repeated
+        const int64_t end = std::max(begin+1, static_cast<int64_t>(std::floor(firstEntry + (pixel+1)*entriesPerPixel)));
+        int32_t pixelMinimum = emptyMinimum;
+        int32_t pixelMaximum = emptyMaximum;
+        for(int64_t index=std::max(begin, firstAvailable); index<std::min(end, static_cast<int64_t>(level.m_count)); index++)
+        {
+            const Entry & entry = level.m_entries[static_cast<size_t>(index) % levelCapacity];
+            pixelMinimum = std::min(pixelMinimum, entry.m_minimum);
+            pixelMaximum = std::max(pixelMaximum, entry.m_maximum);
+        }
+        minimum[pixel] = pixelMinimum;
+        maximum[pixel] = pixelMaximum;
+    }
+}
+
+uint64_t WaveformPyramid::getMaximumNumberOfSamples()
+{
+    uint64_t decimation = baseDecimation;
+    for(int i=1; i<numberOfLevels; i++)
+    {
+        decimation *= levelFactor;
+    }
+    return decimation*levelCapacity;
+}
+
+void WaveformPyramid::pushEntry(int levelIndex, const Entry & entry)
+{
+    Level & level = m_levels[levelIndex];
+    level.m_entries[level.m_count % levelCapacity] = entry;
+    ++level.m_count;
+
+    if(levelIndex+1 >= numberOfLevels)
+    {
+        return;
+    }
+    Level & next = m_levels[levelIndex+1];
+    next.m_pending.m_minimum = std::min(next.m_pending.m_minimum, entry.m_minimum);
+    next.m_pending.m_maximum = std::max(next.m_pending.m_maximum, entry.m_maximum);
+    if(++next.m_pendingCount == levelFactor)
+    {
+        const Entry combined = next.m_pending;
+        next.m_pending = Entry{emptyMinimum, emptyMaximum};
+        next.m_pendingCount = 0;
+        pushEntry(levelIndex+1, combined);
+    }
+}